@@ -28,11 +28,14 @@
 #include <fstream>
 #include <utility>
 #include <iterator>
+#include <set>
 
 #include <wx/datetime.h>
+#include <wx/file.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
+#include <wx/textfile.h>
 
 #include <boost/uuid/sha1.hpp>
 
@@ -40,8 +43,10 @@
 #include <glm/ext.hpp>
 
 #include "common.h"
+#include "profile.h"
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_render_cache.h"
 #include "sg/scenegraph.h"
 #include "3d_filename_resolver.h"
 #include "3d_plugin_manager.h"
@@ -50,8 +55,17 @@
 
 #define MASK_3D_CACHE "3D_CACHE"
 
+// the file of the cache directory holding the hashes of the model files
+#define FILE_STAMPS_NAME "modelstamps.txt"
+
 static wxCriticalSection lock3D_cache;
 
+// the scene graph writer is not reentrant
+static wxCriticalSection lock3D_writer;
+
+// protects the file stamps, used by the concurrent loads of PrefetchModels()
+static wxCriticalSection lock3D_stamps;
+
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
     for( int i = 0; i < 20; ++i )
@@ -71,6 +85,26 @@ static bool checkTag( const char* aTag, void* aPluginMgrPtr )
     return pp->CheckTag( aTag );
 }
 
+
+// the plugin manager, and the tag of a cache file once checked by checkAndKeepTag()
+struct CACHE_TAG_CHECK
+{
+    S3D_PLUGIN_MANAGER* plugins;
+    std::string         tag;
+};
+
+
+static bool checkAndKeepTag( const char* aTag, void* aTagCheckPtr )
+{
+    CACHE_TAG_CHECK* tagCheck = (CACHE_TAG_CHECK*) aTagCheckPtr;
+
+    if( !checkTag( aTag, tagCheck->plugins ) )
+        return false;
+
+    tagCheck->tag = aTag;
+    return true;
+}
+
 static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 {
     unsigned char uc;
@@ -104,6 +138,24 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
     return wxString::FromUTF8Unchecked( sha1 );
 }
 
+static bool wxStringToSHA1( const wxString& aString, unsigned char* aSHA1Sum )
+{
+    if( aString.length() != 40 )
+        return false;
+
+    for( int i = 0; i < 20; ++i )
+    {
+        unsigned long byte;
+
+        if( !aString.Mid( i * 2, 2 ).ToULong( &byte, 16 ) )
+            return false;
+
+        aSHA1Sum[i] = (unsigned char) byte;
+    }
+
+    return true;
+}
+
 
 class S3D_CACHE_ENTRY
 {
@@ -121,11 +173,16 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
 
+    // free the render data, allocated or mapped from a render cache file
+    void ClearRenderData( void );
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    S3D_RENDER_CACHE* renderCache;  // the render cache file holding renderData, if mapped
+    bool          sceneDeferred;    // sceneData was not loaded, renderData was enough
 };
 
 
@@ -133,6 +190,8 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    renderCache = NULL;
+    sceneDeferred = false;
     memset( sha1sum, 0, 20 );
 }
 
@@ -142,6 +201,20 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
     if( NULL != sceneData )
         delete sceneData;
 
+    ClearRenderData();
+}
+
+
+void S3D_CACHE_ENTRY::ClearRenderData( void )
+{
+    if( NULL != renderCache )
+    {
+        // the render data belongs to the render cache
+        delete renderCache;
+        renderCache = NULL;
+        renderData = NULL;
+    }
+
     if( NULL != renderData )
         S3D::Destroy3DModel( &renderData );
 }
@@ -164,6 +237,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
     return;
 }
 
@@ -180,6 +254,7 @@ const wxString S3D_CACHE_ENTRY::GetCacheBaseName( void )
 S3D_CACHE::S3D_CACHE()
 {
     m_DirtyCache = false;
+    m_FileStampsLoaded = false;
     m_FNResolver = new S3D_FILENAME_RESOLVER;
     m_Plugins = new S3D_PLUGIN_MANAGER;
 
@@ -200,7 +275,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aRenderOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -232,7 +308,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
             if( fmdate != mi->second->modTime )
             {
                 unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
+                getFileSHA1( full3Dpath, hashSum );
                 mi->second->modTime = fmdate;
 
                 if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
@@ -250,13 +326,21 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
                     mi->second->sceneData = NULL;
                 }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
-
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                mi->second->ClearRenderData();
+                mi->second->sceneDeferred = false;
+                mi->second->sceneData = loadModelFile( full3Dpath, mi->second->pluginInfo );
             }
         }
 
+        // the model was loaded for its render data only; read its scene data now
+        if( mi->second->sceneDeferred && !aRenderOnly )
+        {
+            mi->second->sceneDeferred = false;
+
+            if( !loadCacheData( mi->second ) )
+                mi->second->sceneData = loadModelFile( full3Dpath, mi->second->pluginInfo );
+        }
+
         if( NULL != aCachePtr )
             *aCachePtr = mi->second;
 
@@ -264,7 +348,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
     }
 
     // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return checkCache( full3Dpath, aCachePtr, aRenderOnly );
 }
 
 
@@ -274,56 +358,15 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr,
+                                   bool aRenderOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
 
-    unsigned char sha1sum[20];
-
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
-    {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            #ifdef DEBUG
-            do {
-                std::ostringstream ostr;
-                ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-                ostr << " * [BUG] duplicate entry in map file; key = '";
-                ostr << aFileName.ToUTF8() << "'";
-                wxLogTrace( MASK_3D_CACHE, "%s\n", ostr.str().c_str() );
-            } while( 0 );
-            #endif
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
-        return NULL;
-    }
-
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+    S3D_CACHE_ENTRY* ep = loadEntry( aFileName, aRenderOnly );
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
+    if( !addEntry( aFileName, ep ) )
     {
         #ifdef DEBUG
         do {
@@ -335,28 +378,86 @@ SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY**
         } while( 0 );
         #endif
 
-        m_CacheList.pop_back();
-        delete ep;
         return NULL;
     }
 
     if( aCachePtr )
         *aCachePtr = ep;
 
+    return ep->sceneData;
+}
+
+
+S3D_CACHE_ENTRY* S3D_CACHE::loadEntry( const wxString& aFileName, bool aRenderOnly )
+{
+    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+    wxFileName fname( aFileName );
+    ep->modTime = fname.GetModificationTime();
+
+    unsigned char sha1sum[20];
+
+    if( !getFileSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    {
+        // just in case we can't get a hash digest (for example, on access issues)
+        // or we do not have a configured cache file directory, the entry remains
+        // empty to prevent further attempts at loading the file
+        return ep;
+    }
+
     ep->SetSHA1( sha1sum );
 
+    // when only the render data is needed, it is mapped from its render cache file,
+    // without reading the scene data
+    if( aRenderOnly && loadRenderCache( ep ) )
+    {
+        ep->sceneDeferred = true;
+        return ep;
+    }
+
     wxString bname = ep->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
     if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+        return ep;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    ep->sceneData = loadModelFile( aFileName, ep->pluginInfo );
 
     if( NULL != ep->sceneData )
         saveCacheData( ep );
 
-    return ep->sceneData;
+    return ep;
+}
+
+
+bool S3D_CACHE::addEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
+                               ( aFileName, aCacheItem ) ).second == false )
+    {
+        delete aCacheItem;
+        return false;
+    }
+
+    m_CacheList.push_back( aCacheItem );
+    return true;
+}
+
+
+SCENEGRAPH* S3D_CACHE::loadModelFile( const wxString& aFileName, std::string& aPluginInfo )
+{
+    return m_Plugins->Load3DModel( aFileName, aPluginInfo );
+}
+
+
+void S3D_CACHE::makeRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL != aCacheItem->renderData || NULL == aCacheItem->sceneData )
+        return;
+
+    aCacheItem->renderData = S3D::GetModel( aCacheItem->sceneData );
+
+    if( NULL != aCacheItem->renderData )
+        saveRenderCache( aCacheItem );
 }
 
 
@@ -428,6 +529,114 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
 }
 
 
+bool S3D_CACHE::getFileSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
+    wxFileName  fname( aFileName );
+    wxULongLong size = fname.GetSize();
+    wxDateTime  modTime = fname.GetModificationTime();
+
+    if( size == wxInvalidSize || !modTime.IsValid() )
+        return getSHA1( aFileName, aSHA1Sum );
+
+    {
+        wxCriticalSectionLocker lock( lock3D_stamps );
+
+        if( !m_FileStampsLoaded )
+            loadFileStamps();
+
+        std::map< wxString, S3D_FILE_STAMP >::iterator it = m_FileStamps.find( aFileName );
+
+        if( it != m_FileStamps.end() && it->second.m_Size == size
+            && it->second.m_ModTime == modTime.GetValue() )
+        {
+            memcpy( aSHA1Sum, it->second.m_SHA1, 20 );
+            return true;
+        }
+    }
+
+    // the file is hashed outside of the lock
+    if( !getSHA1( aFileName, aSHA1Sum ) )
+        return false;
+
+    wxCriticalSectionLocker lock( lock3D_stamps );
+    S3D_FILE_STAMP& stamp = m_FileStamps[aFileName];
+    stamp.m_Size = size;
+    stamp.m_ModTime = modTime.GetValue();
+    memcpy( stamp.m_SHA1, aSHA1Sum, 20 );
+    m_DirtyCache = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadFileStamps( void )
+{
+    if( m_CacheDir.empty() )
+        return;
+
+    m_FileStampsLoaded = true;
+
+    wxString fname = m_CacheDir + wxT( FILE_STAMPS_NAME );
+    wxTextFile file;
+
+    if( !wxFileName::FileExists( fname ) || !file.Open( fname, wxConvUTF8 ) )
+        return;
+
+    // each line is: SHA1 size modification_time full_path
+    for( size_t i = 0; i < file.GetLineCount(); ++i )
+    {
+        S3D_FILE_STAMP      stamp;
+        wxULongLong_t       size;
+        wxLongLong_t        modTime;
+        wxString            sizeText;
+        wxString            modTimeText;
+        wxString            path;
+
+        wxString sha1 = file[i].BeforeFirst( ' ', &sizeText );
+        sizeText = sizeText.BeforeFirst( ' ', &modTimeText );
+        modTimeText = modTimeText.BeforeFirst( ' ', &path );
+
+        if( path.empty() || !wxStringToSHA1( sha1, stamp.m_SHA1 )
+            || !sizeText.ToULongLong( &size ) || !modTimeText.ToLongLong( &modTime ) )
+            continue;
+
+        stamp.m_Size = size;
+        stamp.m_ModTime = modTime;
+        m_FileStamps[path] = stamp;
+    }
+}
+
+
+void S3D_CACHE::saveFileStamps( void )
+{
+    wxCriticalSectionLocker lock( lock3D_stamps );
+
+    if( !m_DirtyCache || m_CacheDir.empty() )
+        return;
+
+    wxString text;
+
+    for( std::map< wxString, S3D_FILE_STAMP >::const_iterator it = m_FileStamps.begin();
+         it != m_FileStamps.end(); ++it )
+    {
+        // forget the files which were removed
+        if( !wxFileName::FileExists( it->first ) )
+            continue;
+
+        text << sha1ToWXString( it->second.m_SHA1 ) << wxT( " " )
+             << it->second.m_Size.ToString() << wxT( " " )
+             << it->second.m_ModTime.ToString() << wxT( " " )
+             << it->first << wxT( "\n" );
+    }
+
+    // the temporary file replaces the previous one when committed
+    wxTempFile file( m_CacheDir + wxT( FILE_STAMPS_NAME ) );
+
+    if( file.IsOpened() && file.Write( text, wxConvUTF8 ) && file.Commit() )
+        m_DirtyCache = false;
+}
+
+
 bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     wxString bname = aCacheItem->GetCacheBaseName();
@@ -462,11 +671,17 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    // the tag of the file is kept to write the render cache file
+    CACHE_TAG_CHECK tagCheck;
+    tagCheck.plugins = m_Plugins;
+
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), &tagCheck,
+                                                         checkAndKeepTag );
 
     if( NULL == aCacheItem->sceneData )
         return false;
 
+    aCacheItem->pluginInfo = tagCheck.tag;
     return true;
 }
 
@@ -534,11 +749,74 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    wxCriticalSectionLocker lock( lock3D_writer );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
 
 
+bool S3D_CACHE::loadRenderCache( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dr" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    S3D_RENDER_CACHE* renderCache = new S3D_RENDER_CACHE;
+
+    if( !renderCache->Open( fname ) )
+    {
+        delete renderCache;
+        return false;
+    }
+
+    // as for the scene graph cache files, the plugin which read the model must still be
+    // available in the same version; otherwise the file is stale and is written again
+    if( !checkTag( renderCache->GetPluginInfo().c_str(), m_Plugins ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] stale render cache file '%s' (plugin '%s')\n",
+                    fname.GetData(), renderCache->GetPluginInfo().c_str() );
+
+        delete renderCache;
+        wxRemoveFile( fname );
+        return false;
+    }
+
+    aCacheItem->pluginInfo = renderCache->GetPluginInfo();
+    aCacheItem->ClearRenderData();
+    aCacheItem->renderCache = renderCache;
+    aCacheItem->renderData = renderCache->GetModel();
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveRenderCache( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem->renderData || NULL != aCacheItem->renderCache )
+        return false;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dr" );
+
+    // the file name is the hash of the model file: an existing file is up to date
+    if( wxFileName::FileExists( fname ) )
+        return true;
+
+    return S3D_RENDER_CACHE::Write( fname, *aCacheItem->renderData, aCacheItem->pluginInfo );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -762,6 +1040,8 @@ void S3D_CACHE::FlushCache( bool closePlugins )
     m_CacheList.clear();
     m_CacheMap.clear();
 
+    saveFileStamps();
+
     if( closePlugins )
         ClosePlugins();
 
@@ -781,7 +1061,11 @@ void S3D_CACHE::ClosePlugins( void )
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    SCENEGRAPH* sp = load( aModelFileName, &cp, true );
+
+    // the render data may have been mapped from its cache file, without the scene data
+    if( cp && cp->renderData )
+        return cp->renderData;
 
     if( !sp )
         return NULL;
@@ -800,13 +1084,80 @@ S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
         return NULL;
     }
 
-    if( cp->renderData )
-        return cp->renderData;
+    makeRenderData( cp );
+
+    return cp->renderData;
+}
+
+
+void S3D_CACHE::PrefetchModels( const std::vector< wxString >& aModelFiles )
+{
+    PROF_COUNTER timer;
+
+    // the file name resolver is not reentrant: resolve the names first
+    std::set< wxString >    uniquePaths;
+    std::vector< wxString > fullPaths;
+
+    for( unsigned ii = 0; ii < aModelFiles.size(); ++ii )
+    {
+        wxString full3Dpath = m_FNResolver->ResolvePath( aModelFiles[ii] );
+
+        if( !full3Dpath.empty() && uniquePaths.insert( full3Dpath ).second )
+            fullPaths.push_back( full3Dpath );
+    }
+
+    {
+        // skip the models which are already loaded
+        wxCriticalSectionLocker lock( lock3D_cache );
+
+        for( unsigned ii = 0; ii < fullPaths.size(); )
+        {
+            if( m_CacheMap.find( fullPaths[ii] ) != m_CacheMap.end() )
+            {
+                fullPaths[ii] = fullPaths.back();
+                fullPaths.pop_back();
+            }
+            else
+            {
+                ++ii;
+            }
+        }
+    }
+
+    std::vector< S3D_CACHE_ENTRY* > entries( fullPaths.size(), NULL );
+
+    // the entries are not in the cache map yet: the threads share only the file stamps,
+    // the scene graph writer and the plugins.  The plugins which are not reentrant lock
+    // their own Load(); the numeric locale they switch to is set once for all threads,
+    // as a plugin restoring the user locale would change it under the others
+    LOCALE_IO toggle;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < (int) fullPaths.size(); ++ii )
+    {
+        entries[ii] = loadEntry( fullPaths[ii], true );
+        makeRenderData( entries[ii] );
+    }
+
+    unsigned mapped = 0;
+
+    for( unsigned ii = 0; ii < entries.size(); ++ii )
+    {
+        if( entries[ii]->renderCache )
+            ++mapped;
+    }
+
+    wxCriticalSectionLocker lock( lock3D_cache );
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    // an entry loaded meanwhile by another caller is kept
+    for( unsigned ii = 0; ii < fullPaths.size(); ++ii )
+        addEntry( fullPaths[ii], entries[ii] );
 
-    return mp;
+    wxLogTrace( MASK_3D_CACHE,
+                " * [3D model] prefetched %u models (%u render cache files) in %.1f ms\n",
+                (unsigned) fullPaths.size(), mapped, timer.msecs() );
 }
 
 
@@ -31,7 +31,9 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <wx/string.h>
+#include <wx/longlong.h>
 #include "str_rsort.h"
 #include "3d_filename_resolver.h"
 #include "3d_info.h"
@@ -47,6 +49,16 @@ class  S3D_PLUGIN_MANAGER;
 struct S3D_INFO;
 
 
+/// the SHA1 hash of a model file, with the size and the modification time of the file
+/// when it was hashed
+struct S3D_FILE_STAMP
+{
+    wxULongLong     m_Size;
+    wxLongLong      m_ModTime;      // in milliseconds since the epoch
+    unsigned char   m_SHA1[20];
+};
+
+
 class S3D_CACHE
 {
 private:
@@ -62,9 +74,16 @@ private:
     /// plugin manager
     S3D_PLUGIN_MANAGER* m_Plugins;
 
-    /// set true if the cache needs to be updated
+    /// set true if the file stamps need to be saved
     bool m_DirtyCache;
 
+    /// the hashes of the model files, by full path; they are kept in the cache directory
+    /// so a model file is hashed again only if its size or modification time changes
+    std::map< wxString, S3D_FILE_STAMP > m_FileStamps;
+
+    /// set true once the file stamps are read from the cache directory
+    bool m_FileStampsLoaded;
+
     /// 3D cache directory
     wxString m_CacheDir;
 
@@ -85,7 +104,30 @@ private:
      * @return      SCENEGRAPH object associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                            bool aRenderOnly = false );
+
+    /**
+     * Function loadEntry
+     * creates the cache entry of a model and loads its data from the cache files, or
+     * else from the model file.  The entry is not added to the cache map, so several
+     * entries may be loaded concurrently.
+     *
+     * @param[in]   aFileName   full path of the model file
+     * @param[in]   aRenderOnly true to map the render data from its cache file, if any,
+     *                          instead of loading the scene data
+     * @return      the new entry, which is empty if the model cannot be loaded
+     */
+    S3D_CACHE_ENTRY* loadEntry( const wxString& aFileName, bool aRenderOnly );
+
+    // add an entry to the cache; the entry is deleted if the file already has one
+    bool addEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    // load a model file with the plugins, which are called one at a time
+    SCENEGRAPH* loadModelFile( const wxString& aFileName, std::string& aPluginInfo );
+
+    // build the render data of an entry from its scene data, if not done yet
+    void makeRenderData( S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Function getSHA1
@@ -98,14 +140,40 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Function getFileSHA1
+     * retrieves the SHA1 hash of the given file; the hash is calculated only if the
+     * size or the modification time of the file differ from the ones stamped with
+     * its last hash
+     *
+     * @param[in]   aFileName   file name (full path)
+     * @param[out]  aSHA1Sum    a 20 byte character array to hold the SHA1 hash
+     * @retval      true        success
+     * @retval      false       failure
+     */
+    bool getFileSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
+
+    // read and write the file stamps of the cache directory
+    void loadFileStamps( void );
+    void saveFileStamps( void );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // map render data from a render cache file
+    bool loadRenderCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a render cache file
+    bool saveRenderCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    // the real load function (can supply a cache entry pointer to member functions);
+    // if aRenderOnly is true and the render data can be read from a render cache file,
+    // the scene data is not loaded
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aRenderOnly = false );
 
 public:
     S3D_CACHE();
@@ -134,6 +202,13 @@ public:
      */
     wxString Get3DConfigDir( bool createDefault = false );
 
+    /**
+     * Function GetCacheDir
+     * returns the directory of the model cache files, set by
+     * Set3DConfigDir(), or wxEmptyString if it was not set yet
+     */
+    const wxString& GetCacheDir() const { return m_CacheDir; }
+
     /**
      * Function SetProjectDir
      * sets the current project's working directory; this
@@ -201,6 +276,18 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Function PrefetchModels
+     * loads the render data of the models which are not in the cache yet, concurrently,
+     * so the following calls to GetModel() find them in the cache.  The models without
+     * cache files are parsed in parallel too, apart from those of the plugins which lock
+     * their Load().  The elapsed time is traced under MASK_3D_CACHE.
+     *
+     * @param aModelFiles is the list of model files (full or partial paths); a model
+     * may appear several times
+     */
+    void PrefetchModels( const std::vector< wxString >& aModelFiles );
+
     wxString GetModelHash( const wxString& aModelFileName );
 };
 
@@ -33,9 +33,9 @@
 #include <wx/log.h>
 #include <wx/stdpaths.h>
 #include <wx/string.h>
+#include <wx/thread.h>
 
 #include "common.h"
-#include "pgm_base.h"
 #include "3d_plugin_dir.h"
 #include "3d_plugin_manager.h"
 #include "plugins/3d/3d_plugin.h"
@@ -44,6 +44,9 @@
 
 #define MASK_3D_PLUGINMGR "3D_PLUGIN_MANAGER"
 
+// the plugin loaders are not reentrant, apart from their Load()
+static wxCriticalSection lock3D_loaders;
+
 
 S3D_PLUGIN_MANAGER::S3D_PLUGIN_MANAGER()
 {
@@ -176,8 +179,10 @@ void S3D_PLUGIN_MANAGER::loadPlugins( void )
    // (2) Machine  /Library/Application Support/kicad/PlugIns/3d
    checkPluginPath( GetOSXKicadMachineDataDir() + wxT( "/PlugIns/3d" ), searchpaths );
    // (3) Bundle   kicad.app/Contents/PlugIns/3d
-   fn.Assign( Pgm().GetExecutablePath() );
-   fn.AppendDir( wxT( "Contents" ) );
+   // From the data directory (kicad.app/Contents/SharedSupport) rather than from Pgm():
+   // there is no program when the kiface is run by pcbnew_batch
+   fn.AssignDir( GetOSXKicadDataDir() );
+   fn.RemoveLastDir();
    fn.AppendDir( wxT( "PlugIns" ) );
    fn.AppendDir( wxT( "3d" ) );
    checkPluginPath( fn.GetPathWithSep(), searchpaths );
@@ -489,7 +494,14 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
     while( sL != items.second )
     {
-        if( sL->second->CanRender() )
+        bool canRender;
+
+        {
+            wxCriticalSectionLocker lock( lock3D_loaders );
+            canRender = sL->second->CanRender();
+        }
+
+        if( canRender )
         {
             SCENEGRAPH* sp = sL->second->Load( aFileName.ToUTF8() );
 
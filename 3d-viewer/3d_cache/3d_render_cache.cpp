@@ -0,0 +1,543 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "3d_render_cache.h"
+
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+// the 8 first bytes of a render cache file
+static const char renderCacheTag[8] = { 'K', 'i', 'C', 'a', 'd', '3', 'D', 'R' };
+
+// to be incremented when the layout of the file, or the conversion of the scene graphs
+// to render data (S3D::GetModel()), changes
+#define RENDER_CACHE_VERSION 2
+
+// written in the byte order of the machine writing the file
+#define RENDER_CACHE_BYTE_ORDER 0x01020304
+
+// the arrays are aligned on this boundary in the file
+#define RENDER_CACHE_ALIGNMENT 8
+
+// the arrays of the file are used as is in the meshes
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "SFVEC3F is not packed" );
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "SFVEC2F is not packed" );
+
+
+struct RENDER_CACHE_HEADER
+{
+    char        tag[8];
+    uint32_t    version;
+    uint32_t    byteOrder;
+    uint32_t    materialsCount;
+    uint32_t    meshesCount;
+    uint32_t    pluginInfoSize;     // the string follows the header, padded
+    uint32_t    reserved;
+};
+
+
+struct RENDER_CACHE_MATERIAL
+{
+    float       ambient[3];
+    float       diffuse[3];
+    float       emissive[3];
+    float       specular[3];
+    float       shininess;
+    float       transparency;
+};
+
+
+struct RENDER_CACHE_MESH
+{
+    uint32_t    vertexCount;
+    uint32_t    faceIdxCount;
+    uint32_t    materialIdx;
+    uint32_t    reserved;
+
+    // offsets of the arrays in the file; 0 if the array is missing
+    uint64_t    positions;
+    uint64_t    normals;
+    uint64_t    texcoords;
+    uint64_t    colors;
+    uint64_t    faceIdx;
+};
+
+
+static void writeVector( float* aDest, const SFVEC3F& aSource )
+{
+    aDest[0] = aSource.x;
+    aDest[1] = aSource.y;
+    aDest[2] = aSource.z;
+}
+
+
+// reserves room for an array of aBytes bytes at the end of the file; returns its offset
+static uint64_t placeArray( uint64_t& aFileSize, const void* aArray, uint64_t aBytes )
+{
+    if( NULL == aArray )
+        return 0;
+
+    aFileSize = ( aFileSize + RENDER_CACHE_ALIGNMENT - 1 ) & ~uint64_t( RENDER_CACHE_ALIGNMENT - 1 );
+    uint64_t offset = aFileSize;
+    aFileSize += aBytes;
+
+    return offset;
+}
+
+
+// writes an array placed by placeArray(), after the padding preceding it
+static bool writeArray( FILE* aFile, uint64_t& aPosition, uint64_t aOffset,
+                        const void* aArray, uint64_t aBytes )
+{
+    if( 0 == aOffset )
+        return true;
+
+    static const char padding[RENDER_CACHE_ALIGNMENT] = { 0 };
+
+    if( aOffset - aPosition > 0
+        && fwrite( padding, 1, aOffset - aPosition, aFile ) != aOffset - aPosition )
+        return false;
+
+    if( fwrite( aArray, 1, aBytes, aFile ) != aBytes )
+        return false;
+
+    aPosition = aOffset + aBytes;
+    return true;
+}
+
+
+// size of the plugin information string in the file, padding included
+static uint64_t pluginInfoBytes( uint64_t aSize )
+{
+    return ( aSize + RENDER_CACHE_ALIGNMENT - 1 ) & ~uint64_t( RENDER_CACHE_ALIGNMENT - 1 );
+}
+
+
+// the file offset is valid for an array of aCount items of aItemSize bytes
+static bool checkArray( uint64_t aOffset, uint64_t aCount, uint64_t aItemSize,
+                        uint64_t aFileSize )
+{
+    if( 0 == aOffset )
+        return false;
+
+    if( aOffset % sizeof( float ) )
+        return false;
+
+    return aOffset <= aFileSize && aCount * aItemSize <= aFileSize - aOffset;
+}
+
+
+S3D_RENDER_CACHE::S3D_RENDER_CACHE()
+{
+    m_Data = NULL;
+    m_Size = 0;
+
+    #if defined(_WIN32)
+    m_File = INVALID_HANDLE_VALUE;
+    m_Mapping = NULL;
+    #endif
+
+    m_Model.m_MeshesSize = 0;
+    m_Model.m_Meshes = NULL;
+    m_Model.m_MaterialsSize = 0;
+    m_Model.m_Materials = NULL;
+}
+
+
+S3D_RENDER_CACHE::~S3D_RENDER_CACHE()
+{
+    Close();
+}
+
+
+bool S3D_RENDER_CACHE::Open( const wxString& aFileName )
+{
+    Close();
+
+    if( !mapFile( aFileName ) )
+        return false;
+
+    if( !buildModel() )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid render cache file '%s'\n",
+                    aFileName.GetData() );
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+
+void S3D_RENDER_CACHE::Close( void )
+{
+    delete[] m_Model.m_Meshes;
+    delete[] m_Model.m_Materials;
+
+    m_Model.m_MeshesSize = 0;
+    m_Model.m_Meshes = NULL;
+    m_Model.m_MaterialsSize = 0;
+    m_Model.m_Materials = NULL;
+    m_PluginInfo.clear();
+
+    unmapFile();
+}
+
+
+S3DMODEL* S3D_RENDER_CACHE::GetModel( void )
+{
+    if( NULL == m_Data )
+        return NULL;
+
+    return &m_Model;
+}
+
+
+const std::string& S3D_RENDER_CACHE::GetPluginInfo( void ) const
+{
+    return m_PluginInfo;
+}
+
+
+bool S3D_RENDER_CACHE::mapFile( const wxString& aFileName )
+{
+    #if defined(_WIN32)
+    m_File = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                          NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+
+    if( INVALID_HANDLE_VALUE == m_File )
+        return false;
+
+    LARGE_INTEGER size;
+
+    if( !GetFileSizeEx( m_File, &size ) || size.QuadPart < (LONGLONG) sizeof( RENDER_CACHE_HEADER )
+        || (ULONGLONG) size.QuadPart > (ULONGLONG) (size_t) -1 )
+    {
+        unmapFile();
+        return false;
+    }
+
+    m_Mapping = CreateFileMappingW( m_File, NULL, PAGE_READONLY, 0, 0, NULL );
+
+    if( NULL == m_Mapping )
+    {
+        unmapFile();
+        return false;
+    }
+
+    m_Data = (const char*) MapViewOfFile( m_Mapping, FILE_MAP_READ, 0, 0, 0 );
+    m_Size = (size_t) size.QuadPart;
+    #else
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd < 0 )
+        return false;
+
+    struct stat st;
+
+    if( fstat( fd, &st ) != 0 || st.st_size < (off_t) sizeof( RENDER_CACHE_HEADER ) )
+    {
+        close( fd );
+        return false;
+    }
+
+    void* data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    // the mapping remains valid after the file is closed
+    close( fd );
+
+    if( MAP_FAILED == data )
+        return false;
+
+    m_Data = (const char*) data;
+    m_Size = st.st_size;
+    #endif
+
+    if( NULL == m_Data )
+    {
+        unmapFile();
+        return false;
+    }
+
+    return true;
+}
+
+
+void S3D_RENDER_CACHE::unmapFile( void )
+{
+    #if defined(_WIN32)
+    if( m_Data )
+        UnmapViewOfFile( m_Data );
+
+    if( m_Mapping )
+        CloseHandle( m_Mapping );
+
+    if( INVALID_HANDLE_VALUE != m_File )
+        CloseHandle( m_File );
+
+    m_File = INVALID_HANDLE_VALUE;
+    m_Mapping = NULL;
+    #else
+    if( m_Data )
+        munmap( (void*) m_Data, m_Size );
+    #endif
+
+    m_Data = NULL;
+    m_Size = 0;
+}
+
+
+bool S3D_RENDER_CACHE::buildModel( void )
+{
+    RENDER_CACHE_HEADER header;
+    memcpy( &header, m_Data, sizeof( header ) );
+
+    if( memcmp( header.tag, renderCacheTag, sizeof( renderCacheTag ) )
+        || header.version != RENDER_CACHE_VERSION
+        || header.byteOrder != RENDER_CACHE_BYTE_ORDER )
+        return false;
+
+    uint64_t infoSize = pluginInfoBytes( header.pluginInfoSize );
+    uint64_t tablesSize = sizeof( RENDER_CACHE_HEADER ) + infoSize
+                          + (uint64_t) header.materialsCount * sizeof( RENDER_CACHE_MATERIAL )
+                          + (uint64_t) header.meshesCount * sizeof( RENDER_CACHE_MESH );
+
+    // a file without plugin information cannot be checked against the plugins
+    if( 0 == header.pluginInfoSize || tablesSize > m_Size )
+        return false;
+
+    m_PluginInfo.assign( m_Data + sizeof( RENDER_CACHE_HEADER ), header.pluginInfoSize );
+
+    // the header and the padded plugin information keep the tables aligned
+    const char* materials = m_Data + sizeof( RENDER_CACHE_HEADER ) + infoSize;
+    const char* meshes = materials + header.materialsCount * sizeof( RENDER_CACHE_MATERIAL );
+
+    m_Model.m_MaterialsSize = header.materialsCount;
+    m_Model.m_Materials = new SMATERIAL[header.materialsCount];
+
+    for( uint32_t i = 0; i < header.materialsCount; ++i )
+    {
+        RENDER_CACHE_MATERIAL mat;
+        memcpy( &mat, materials + i * sizeof( mat ), sizeof( mat ) );
+
+        SMATERIAL& dest = m_Model.m_Materials[i];
+        dest.m_Ambient = SFVEC3F( mat.ambient[0], mat.ambient[1], mat.ambient[2] );
+        dest.m_Diffuse = SFVEC3F( mat.diffuse[0], mat.diffuse[1], mat.diffuse[2] );
+        dest.m_Emissive = SFVEC3F( mat.emissive[0], mat.emissive[1], mat.emissive[2] );
+        dest.m_Specular = SFVEC3F( mat.specular[0], mat.specular[1], mat.specular[2] );
+        dest.m_Shininess = mat.shininess;
+        dest.m_Transparency = mat.transparency;
+    }
+
+    m_Model.m_MeshesSize = header.meshesCount;
+    m_Model.m_Meshes = new SMESH[header.meshesCount];
+
+    for( uint32_t i = 0; i < header.meshesCount; ++i )
+    {
+        RENDER_CACHE_MESH mesh;
+        memcpy( &mesh, meshes + i * sizeof( mesh ), sizeof( mesh ) );
+
+        if( mesh.materialIdx >= header.materialsCount
+            || !checkArray( mesh.positions, mesh.vertexCount, sizeof( SFVEC3F ), m_Size )
+            || !checkArray( mesh.faceIdx, mesh.faceIdxCount, sizeof( unsigned int ), m_Size ) )
+            return false;
+
+        if( mesh.normals
+            && !checkArray( mesh.normals, mesh.vertexCount, sizeof( SFVEC3F ), m_Size ) )
+            return false;
+
+        if( mesh.texcoords
+            && !checkArray( mesh.texcoords, mesh.vertexCount, sizeof( SFVEC2F ), m_Size ) )
+            return false;
+
+        if( mesh.colors
+            && !checkArray( mesh.colors, mesh.vertexCount, sizeof( SFVEC3F ), m_Size ) )
+            return false;
+
+        SMESH& dest = m_Model.m_Meshes[i];
+        dest.m_VertexSize = mesh.vertexCount;
+        dest.m_Positions = (SFVEC3F*) ( m_Data + mesh.positions );
+        dest.m_Normals = mesh.normals ? (SFVEC3F*) ( m_Data + mesh.normals ) : NULL;
+        dest.m_Texcoords = mesh.texcoords ? (SFVEC2F*) ( m_Data + mesh.texcoords ) : NULL;
+        dest.m_Color = mesh.colors ? (SFVEC3F*) ( m_Data + mesh.colors ) : NULL;
+        dest.m_FaceIdxSize = mesh.faceIdxCount;
+        dest.m_FaceIdx = (unsigned int*) ( m_Data + mesh.faceIdx );
+        dest.m_MaterialIdx = mesh.materialIdx;
+
+        // the renderers index the vertex arrays without checking the indices
+        for( uint32_t j = 0; j < mesh.faceIdxCount; ++j )
+        {
+            if( dest.m_FaceIdx[j] >= mesh.vertexCount )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool S3D_RENDER_CACHE::Write( const wxString& aFileName, const S3DMODEL& aModel,
+                              const std::string& aPluginInfo )
+{
+    static_assert( sizeof( unsigned int ) == sizeof( uint32_t ), "unexpected index size" );
+
+    if( aPluginInfo.empty() )
+        return false;
+
+    RENDER_CACHE_HEADER header;
+    memcpy( header.tag, renderCacheTag, sizeof( renderCacheTag ) );
+    header.version = RENDER_CACHE_VERSION;
+    header.byteOrder = RENDER_CACHE_BYTE_ORDER;
+    header.materialsCount = aModel.m_MaterialsSize;
+    header.meshesCount = aModel.m_MeshesSize;
+    header.pluginInfoSize = aPluginInfo.size();
+    header.reserved = 0;
+
+    uint64_t infoSize = pluginInfoBytes( aPluginInfo.size() );
+
+    std::vector< RENDER_CACHE_MATERIAL > materials( aModel.m_MaterialsSize );
+
+    for( unsigned int i = 0; i < aModel.m_MaterialsSize; ++i )
+    {
+        const SMATERIAL& mat = aModel.m_Materials[i];
+        writeVector( materials[i].ambient, mat.m_Ambient );
+        writeVector( materials[i].diffuse, mat.m_Diffuse );
+        writeVector( materials[i].emissive, mat.m_Emissive );
+        writeVector( materials[i].specular, mat.m_Specular );
+        materials[i].shininess = mat.m_Shininess;
+        materials[i].transparency = mat.m_Transparency;
+    }
+
+    // lay out the arrays after the tables
+    std::vector< RENDER_CACHE_MESH > meshes( aModel.m_MeshesSize );
+    uint64_t fileSize = sizeof( RENDER_CACHE_HEADER ) + infoSize
+                        + materials.size() * sizeof( RENDER_CACHE_MATERIAL )
+                        + meshes.size() * sizeof( RENDER_CACHE_MESH );
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+        uint64_t vertexCount = mesh.m_VertexSize;
+
+        // the mesh would be rejected when reading the file
+        if( NULL == mesh.m_Positions || NULL == mesh.m_FaceIdx
+            || mesh.m_MaterialIdx >= aModel.m_MaterialsSize )
+            return false;
+
+        meshes[i].vertexCount = mesh.m_VertexSize;
+        meshes[i].faceIdxCount = mesh.m_FaceIdxSize;
+        meshes[i].materialIdx = mesh.m_MaterialIdx;
+        meshes[i].reserved = 0;
+
+        meshes[i].positions = placeArray( fileSize, mesh.m_Positions,
+                                          vertexCount * sizeof( SFVEC3F ) );
+        meshes[i].normals = placeArray( fileSize, mesh.m_Normals,
+                                        vertexCount * sizeof( SFVEC3F ) );
+        meshes[i].texcoords = placeArray( fileSize, mesh.m_Texcoords,
+                                          vertexCount * sizeof( SFVEC2F ) );
+        meshes[i].colors = placeArray( fileSize, mesh.m_Color,
+                                       vertexCount * sizeof( SFVEC3F ) );
+        meshes[i].faceIdx = placeArray( fileSize, mesh.m_FaceIdx,
+                                        (uint64_t) mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    // the same model may be written by several threads of S3D_CACHE::PrefetchModels() or
+    // by several instances at once: each writer gets its own temporary file
+    wxString tmpName = wxFileName::CreateTempFileName( aFileName );
+
+    if( tmpName.empty() )
+        return false;
+
+    #if defined(_WIN32)
+    FILE* fp = _wfopen( tmpName.wc_str(), L"wb" );
+    #else
+    FILE* fp = fopen( tmpName.ToUTF8(), "wb" );
+    #endif
+
+    if( NULL == fp )
+        return false;
+
+    uint64_t position = sizeof( RENDER_CACHE_HEADER ) + infoSize
+                        + materials.size() * sizeof( RENDER_CACHE_MATERIAL )
+                        + meshes.size() * sizeof( RENDER_CACHE_MESH );
+
+    std::vector< char > info( infoSize, 0 );
+    memcpy( &info[0], aPluginInfo.data(), aPluginInfo.size() );
+
+    bool ok = fwrite( &header, sizeof( header ), 1, fp ) == 1
+              && fwrite( &info[0], 1, info.size(), fp ) == info.size();
+
+    if( ok && !materials.empty() )
+        ok = fwrite( &materials[0], sizeof( RENDER_CACHE_MATERIAL ), materials.size(), fp )
+             == materials.size();
+
+    if( ok && !meshes.empty() )
+        ok = fwrite( &meshes[0], sizeof( RENDER_CACHE_MESH ), meshes.size(), fp )
+             == meshes.size();
+
+    for( unsigned int i = 0; ok && i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+        uint64_t vertexCount = mesh.m_VertexSize;
+
+        ok = writeArray( fp, position, meshes[i].positions, mesh.m_Positions,
+                         vertexCount * sizeof( SFVEC3F ) )
+             && writeArray( fp, position, meshes[i].normals, mesh.m_Normals,
+                            vertexCount * sizeof( SFVEC3F ) )
+             && writeArray( fp, position, meshes[i].texcoords, mesh.m_Texcoords,
+                            vertexCount * sizeof( SFVEC2F ) )
+             && writeArray( fp, position, meshes[i].colors, mesh.m_Color,
+                            vertexCount * sizeof( SFVEC3F ) )
+             && writeArray( fp, position, meshes[i].faceIdx, mesh.m_FaceIdx,
+                            (uint64_t) mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    if( fclose( fp ) != 0 )
+        ok = false;
+
+    if( !ok || !wxRenameFile( tmpName, aFileName, true ) )
+    {
+        wxRemoveFile( tmpName );
+        return false;
+    }
+
+    return true;
+}
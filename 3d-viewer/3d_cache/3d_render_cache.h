@@ -0,0 +1,125 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_render_cache.h
+ * defines the memory mapped cache files holding the render data of 3D models
+ */
+
+#ifndef RENDER_CACHE_3D_H
+#define RENDER_CACHE_3D_H
+
+#include <cstddef>
+#include <string>
+#include <wx/string.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+
+/**
+ * Class S3D_RENDER_CACHE
+ * holds the render data (S3DMODEL) of a 3D model read from a render cache file.
+ *
+ * A render cache file is a flat and versioned binary image of a S3DMODEL: a header,
+ * the plugin information, the materials, the mesh descriptors, then the vertex, normal,
+ * texture coordinate, color and index arrays, each one contiguous.  The file is memory mapped, and the
+ * arrays of the meshes point directly into the mapping, so a model is available
+ * without parsing its scene graph cache file (.3dc) node by node.
+ *
+ * The files are written in the native byte order; a file written on a machine with a
+ * different byte order, or with another version of the format, is rejected.
+ */
+class S3D_RENDER_CACHE
+{
+private:
+    // prohibit assignment and default copy constructor
+    S3D_RENDER_CACHE( const S3D_RENDER_CACHE& source );
+    S3D_RENDER_CACHE& operator=( const S3D_RENDER_CACHE& source );
+
+    const char* m_Data;         // the mapped file
+    size_t      m_Size;         // size of the mapped file
+
+    #if defined(_WIN32)
+    void*       m_File;         // file and mapping handles
+    void*       m_Mapping;
+    #endif
+
+    S3DMODEL    m_Model;        // meshes and materials arrays are allocated,
+                                // the meshes data points into the mapped file
+    std::string m_PluginInfo;   // PluginName:Version string of the plugin which read the model
+
+    bool mapFile( const wxString& aFileName );
+    void unmapFile( void );
+
+    // validate the mapped data and build m_Model
+    bool buildModel( void );
+
+public:
+    S3D_RENDER_CACHE();
+    ~S3D_RENDER_CACHE();
+
+    /**
+     * Function Open
+     * maps a render cache file and builds its model
+     *
+     * @param aFileName is the full path of the render cache file
+     * @return true if the file was mapped and is a valid render cache file
+     */
+    bool Open( const wxString& aFileName );
+
+    /**
+     * Function Close
+     * releases the model and unmaps the file
+     */
+    void Close( void );
+
+    /**
+     * Function GetModel
+     * @return the model of the open file, or NULL if no file is open; the model
+     * belongs to this object and is valid until the file is closed
+     */
+    S3DMODEL* GetModel( void );
+
+    /**
+     * Function GetPluginInfo
+     * @return the information string of the plugin which read the model of the open file,
+     * as written in the file; the caller checks it against the available plugins, as it does
+     * for the scene graph cache files
+     */
+    const std::string& GetPluginInfo( void ) const;
+
+    /**
+     * Function Write
+     * writes the render cache file of aModel.  The file is written under a unique
+     * temporary name then renamed, so a file mapped by another instance is never
+     * modified and concurrent writers of the same file do not mix their data.
+     *
+     * @param aFileName is the full path of the render cache file
+     * @param aModel is the render data to write
+     * @param aPluginInfo is the information string of the plugin which read the model
+     * @return true on success
+     */
+    static bool Write( const wxString& aFileName, const S3DMODEL& aModel,
+                       const std::string& aPluginInfo );
+};
+
+#endif  // RENDER_CACHE_3D_H
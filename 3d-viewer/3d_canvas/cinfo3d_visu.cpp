@@ -234,6 +234,31 @@ bool CINFO3D_VISU::ShouldModuleBeDisplayed( MODULE_ATTR_T aModuleAttributs ) con
     return false;
 }
 
+void CINFO3D_VISU::Prefetch3DModels() const
+{
+    if( !m_board || !m_3d_model_manager )
+        return;
+
+    std::vector< wxString > modelFiles;
+
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        if( module->Models().empty() ||
+            !ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+            continue;
+
+        for( std::list<S3D_INFO>::const_iterator sM = module->Models().begin();
+             sM != module->Models().end();
+             ++sM )
+        {
+            if( !sM->m_Filename.empty() )
+                modelFiles.push_back( sM->m_Filename );
+        }
+    }
+
+    m_3d_model_manager->PrefetchModels( modelFiles );
+}
+
 
 // !TODO: define the actual copper thickness by user
 #define COPPER_THICKNESS KiROUND( 0.035 * IU_PER_MM )   // for 35 um
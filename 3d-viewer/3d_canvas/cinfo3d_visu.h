@@ -115,6 +115,12 @@ class CINFO3D_VISU
      */
     bool ShouldModuleBeDisplayed( MODULE_ATTR_T aModuleAttributs ) const;
 
+    /**
+     * @brief Prefetch3DModels - Load concurrently in the 3D cache the models of the
+     * modules to be displayed, so the renderers get them without waiting for each file
+     */
+    void Prefetch3DModels() const;
+
     /**
      * @brief SetBoard - Set current board to be rendered
      * @param aBoard: board to process
@@ -911,15 +911,26 @@ void CINFO3D_VISU::AddSolidAreasShapesToContainer( const ZONE_CONTAINER* aZoneCo
                                                    CGENERICCONTAINER2D *aDstContainer,
                                                    PCB_LAYER_ID aLayerId )
 {
-    // Copy the polys list because we have to simplify it
-    SHAPE_POLY_SET polyList = SHAPE_POLY_SET(aZoneContainer->GetFilledPolysList());
+    // The zone fill keeps its triangulation, shared with the GAL and the exporters.
+    // It is used as is: a simplified copy would not have the cached triangulation
+    const SHAPE_POLY_SET& filledPolys = aZoneContainer->GetFilledPolysList();
+    const bool useCachedTriangulation = filledPolys.CacheTriangulation();
+    SHAPE_POLY_SET simplifiedPolys;
 
-    // This convert the poly in outline and holes
+    if( !useCachedTriangulation )
+    {
+        // Copy the polys list because we have to simplify it
+        simplifiedPolys = filledPolys;
+
+        // This convert the poly in outline and holes
+
+        // Note: This two sequencial calls are need in order to get
+        // the triangulation function to work properly.
+        simplifiedPolys.Simplify( SHAPE_POLY_SET::PM_FAST );
+        simplifiedPolys.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    }
 
-    // Note: This two sequencial calls are need in order to get
-    // the triangulation function to work properly.
-    polyList.Simplify( SHAPE_POLY_SET::PM_FAST );
-    polyList.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    const SHAPE_POLY_SET& polyList = useCachedTriangulation ? filledPolys : simplifiedPolys;
 
     if( polyList.IsEmpty() )
         return;
@@ -931,6 +942,7 @@ void CINFO3D_VISU::AddSolidAreasShapesToContainer( const ZONE_CONTAINER* aZoneCo
 
 
     // add filled areas outlines, which are drawn with thick lines segments
+    // (the fracture cuts of a fill used as is lie inside the filled area)
     // /////////////////////////////////////////////////////////////////////////
     for( int i = 0; i < polyList.OutlineCount(); ++i )
     {
@@ -926,6 +926,9 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models()
         (!m_settings.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Load the models concurrently, the loop below gets them from the cache
+    m_settings.Prefetch3DModels();
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
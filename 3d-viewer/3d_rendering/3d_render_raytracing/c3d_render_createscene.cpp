@@ -1199,6 +1199,9 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Load the models concurrently, the loop below gets them from the cache
+    m_settings.Prefetch3DModels();
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -161,6 +161,32 @@ void Convert_shape_line_polygon_to_triangles( const SHAPE_POLY_SET &aPolyList,
                                               float aBiuTo3DunitsScale ,
                                               const BOARD_ITEM &aBoardItem )
 {
+    // Reuse the triangulation cached in the polygon set, if any
+    if( aPolyList.IsTriangulationUpToDate() )
+    {
+        for( unsigned int idx = 0; idx < aPolyList.TriangulatedPolyCount(); ++idx )
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triPoly =
+                aPolyList.TriangulatedPolygon( idx );
+
+            for( int i = 0; i < triPoly->GetTriangleCount(); ++i )
+            {
+                VECTOR2I a, b, c;
+                triPoly->GetTriangle( i, a, b, c );
+
+                aDstContainer.Add( new CTRIANGLE2D( SFVEC2F( a.x * aBiuTo3DunitsScale,
+                                                            -a.y * aBiuTo3DunitsScale ),
+                                                    SFVEC2F( b.x * aBiuTo3DunitsScale,
+                                                            -b.y * aBiuTo3DunitsScale ),
+                                                    SFVEC2F( c.x * aBiuTo3DunitsScale,
+                                                            -c.y * aBiuTo3DunitsScale ),
+                                                    aBoardItem ) );
+            }
+        }
+
+        return;
+    }
+
     unsigned int nOutlines = aPolyList.OutlineCount();
 
 
@@ -422,6 +422,12 @@ void BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
         if( extraitems > 0 )
             ClearUndoORRedoList( m_UndoList, extraitems );
     }
+
+    // Delete the oldest items, if the memory limit is reached
+    int excessitems = m_UndoList.GetExcessCommandCount();
+
+    if( excessitems > 0 )
+        ClearUndoORRedoList( m_UndoList, excessitems );
 }
 
 
@@ -436,6 +442,12 @@ void BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
         if( extraitems > 0 )
             ClearUndoORRedoList( m_RedoList, extraitems );
     }
+
+    // Delete the oldest items, if the memory limit is reached
+    int excessitems = m_RedoList.GetExcessCommandCount();
+
+    if( excessitems > 0 )
+        ClearUndoORRedoList( m_RedoList, excessitems );
 }
 
 
@@ -0,0 +1,77 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file batch_launcher.cpp
+ */
+
+#include <fctsys.h>
+#include <kiway.h>
+#include <batch_launcher.h>
+
+#include <wx/dynlib.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+
+#include <iostream>
+
+
+REPORTER& STDIO_REPORTER::Report( const wxString& aText, SEVERITY aSeverity )
+{
+    if( aSeverity == RPT_ERROR )
+        std::cerr << aText.ToUTF8() << std::endl;
+    else
+        std::cout << aText.ToUTF8() << std::endl;
+
+    return *this;
+}
+
+
+KIFACE* LoadBatchKiface( const wxString& aName, REPORTER& aReporter )
+{
+    // The kiface resides in the same directory as this program
+    wxFileName dsoName( wxStandardPaths::Get().GetExecutablePath() );
+
+    dsoName.SetName( wxString( KIFACE_PREFIX ) + aName );
+    dsoName.SetExt( KIFACE_SUFFIX + 1 );         // + 1 => &KIFACE_SUFFIX[1]
+
+    wxDynamicLibrary    dso;
+    void*               addr = NULL;
+
+    if( !dso.Load( dsoName.GetFullPath(), wxDL_VERBATIM | wxDL_NOW | wxDL_GLOBAL ) ||
+        ( addr = dso.GetSymbol( wxT( KIFACE_INSTANCE_NAME_AND_VERSION ) ) ) == NULL )
+    {
+        aReporter.Report( wxString::Format( _( "Failed to load kiface library '%s'." ),
+                                            GetChars( dsoName.GetFullPath() ) ),
+                          REPORTER::RPT_ERROR );
+        return NULL;
+    }
+
+    // Keep the kiface loaded until exit
+    (void) dso.Detach();
+
+    KIFACE_GETTER_FUNC* getter = (KIFACE_GETTER_FUNC*) addr;
+    int                 kifaceVersion = 0;
+
+    return getter( &kifaceVersion, KIFACE_VERSION, NULL );
+}
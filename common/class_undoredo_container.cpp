@@ -37,12 +37,14 @@ ITEM_PICKER::ITEM_PICKER( EDA_ITEM* aItem, UNDO_REDO_T aUndoRedoStatus )
     SetItem( aItem );
     m_pickerFlags = 0;
     m_link = NULL;
+    m_hasMoveVector = false;
 }
 
 
 PICKED_ITEMS_LIST::PICKED_ITEMS_LIST()
 {
     m_Status = UR_UNSPECIFIED;
+    m_memoryUsage = 0;
 }
 
 PICKED_ITEMS_LIST::~PICKED_ITEMS_LIST()
@@ -307,6 +309,7 @@ void PICKED_ITEMS_LIST::ReversePickersListOrder()
 
 UNDO_REDO_CONTAINER::UNDO_REDO_CONTAINER()
 {
+    m_memoryLimit = 0;
 }
 
 
@@ -342,3 +345,30 @@ PICKED_ITEMS_LIST* UNDO_REDO_CONTAINER::PopCommand()
 
     return NULL;
 }
+
+
+size_t UNDO_REDO_CONTAINER::GetMemoryUsage() const
+{
+    size_t usage = 0;
+
+    for( const PICKED_ITEMS_LIST* command : m_CommandsList )
+        usage += command->GetMemoryUsage();
+
+    return usage;
+}
+
+
+int UNDO_REDO_CONTAINER::GetExcessCommandCount() const
+{
+    if( m_memoryLimit == 0 )
+        return 0;
+
+    size_t usage = GetMemoryUsage();
+    int    excess = 0;
+
+    // Commands are removed from the oldest one, but the last one is always kept
+    while( usage > m_memoryLimit && excess < (int) m_CommandsList.size() - 1 )
+        usage -= m_CommandsList[excess++]->GetMemoryUsage();
+
+    return excess;
+}
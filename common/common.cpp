@@ -34,6 +34,7 @@
 #include <macros.h>
 #include <base_units.h>
 #include <reporter.h>
+#include <ki_mutex.h>
 
 #include <wx/process.h>
 #include <wx/config.h>
@@ -165,9 +166,13 @@ int ProcessExecute( const wxString& aCommandLine, int aFlags, wxProcess *callbac
 
 time_t GetNewTimeStamp()
 {
+    // Items can be created from worker threads, e.g. while plotting
+    static MUTEX  timestamp_mutex;
     static time_t oldTimeStamp;
     time_t newTimeStamp;
 
+    MUTLOCK lock( timestamp_mutex );
+
     newTimeStamp = time( NULL );
 
     if( newTimeStamp <= oldTimeStamp )
@@ -250,7 +255,6 @@ wxString GetKicadConfigPath()
 }
 
 
-#include <ki_mutex.h>
 const wxString ExpandEnvVarSubstitutions( const wxString& aString )
 {
     // wxGetenv( wchar_t* ) is not re-entrant on linux.
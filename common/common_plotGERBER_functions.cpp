@@ -45,8 +45,6 @@
 
 GERBER_PLOTTER::GERBER_PLOTTER()
 {
-    workFile  = NULL;
-    finalFile = NULL;
     currentAperture = apertures.end();
     m_apertureAttribute = 0;
 
@@ -116,6 +114,9 @@ void GERBER_PLOTTER::clearNetAttribute()
     fputs( "%TD*%\n", outputFile );
 
     m_objectAttributesDictionnary.clear();
+
+    // %TD*% deletes the aperture attribute too
+    m_apertureAttribute = 0;
 }
 
 
@@ -160,17 +161,8 @@ bool GERBER_PLOTTER::StartPlot()
 {
     wxASSERT( outputFile );
 
-    finalFile = outputFile;     // the actual gerber file will be created later
-
-    // Create a temporary filename to store gerber file
-    // note tmpfile() does not work under Vista and W7 in user mode
-    m_workFilename = filename + wxT(".tmp");
-    workFile   = wxFopen( m_workFilename, wxT( "wt" ));
-    outputFile = workFile;
-    wxASSERT( outputFile );
-
-    if( outputFile == NULL )
-        return false;
+    // The file is written in one pass: each aperture is defined where it is first used
+    m_apertureAttribute = 0;
 
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
@@ -208,7 +200,6 @@ bool GERBER_PLOTTER::StartPlot()
     // Specify linear interpol (G01):
     fputs( "G01*\n", outputFile );
 
-    fputs( "G04 APERTURE LIST*\n", outputFile );
     /* Select the default aperture */
     SetCurrentLineWidth( USE_DEFAULT_LINE_WIDTH, 0 );
 
@@ -218,38 +209,19 @@ bool GERBER_PLOTTER::StartPlot()
 
 bool GERBER_PLOTTER::EndPlot()
 {
-    char     line[1024];
-    wxString msg;
-
     wxASSERT( outputFile );
 
-    /* Outfile is actually a temporary file i.e. workFile */
     fputs( "M02*\n", outputFile );
-    fflush( outputFile );
 
-    fclose( workFile );
-    workFile   = wxFopen( m_workFilename, wxT( "rt" ));
-    wxASSERT( workFile );
-    outputFile = finalFile;
-
-    // Placement of apertures in RS274X
-    while( fgets( line, 1024, workFile ) )
-    {
-        fputs( line, outputFile );
+    // A failed write leaves the error indicator of the stream set
+    bool success = !ferror( outputFile );
 
-        if( strcmp( strtok( line, "\n\r" ), "G04 APERTURE LIST*" ) == 0 )
-        {
-            writeApertureList();
-            fputs( "G04 APERTURE END LIST*\n", outputFile );
-        }
-    }
+    if( fclose( outputFile ) != 0 )
+        success = false;
 
-    fclose( workFile );
-    fclose( finalFile );
-    ::wxRemoveFile( m_workFilename );
-    outputFile = 0;
+    outputFile = NULL;
 
-    return true;
+    return success;
 }
 
 
@@ -283,30 +255,30 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
+    APERTURE_KEY key;
+    key.m_Type = aType;
+    key.m_SizeX = aSize.x;
+    key.m_SizeY = aSize.y;
+    key.m_ApertureAttribute = aApertureAttribute;
 
     // Search an existing aperture
-    std::vector<APERTURE>::iterator tool = apertures.begin();
+    auto found = m_apertureIndex.find( key );
 
-    while( tool != apertures.end() )
-    {
-        last_D_code = tool->m_DCode;
-
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) && (tool->m_ApertureAttribute == aApertureAttribute) )
-            return tool;
-
-        ++tool;
-    }
+    if( found != m_apertureIndex.end() )
+        return apertures.begin() + found->second;
 
     // Allocate a new aperture
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = apertures.empty() ? FIRST_DCODE_VALUE : apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
+    m_apertureIndex[key] = apertures.size();
     apertures.push_back( new_tool );
 
+    writeApertureDefinition( new_tool );
+
     return apertures.end() - 1;
 }
 
@@ -333,73 +305,67 @@ void GERBER_PLOTTER::selectAperture( const wxSize&           aSize,
 }
 
 
-void GERBER_PLOTTER::writeApertureList()
+void GERBER_PLOTTER::writeApertureDefinition( const APERTURE& aAperture )
 {
     wxASSERT( outputFile );
     char cbuf[1024];
 
-    // Init
-    for( std::vector<APERTURE>::iterator tool = apertures.begin();
-         tool != apertures.end(); ++tool )
-    {
-        // apertude sizes are in inch or mm, regardless the
-        // coordinates format
-        double fscale = 0.0001 * plotScale / m_IUsPerDecimil; // inches
+    // apertude sizes are in inch or mm, regardless the
+    // coordinates format
+    double fscale = 0.0001 * plotScale / m_IUsPerDecimil; // inches
 
-        if(! m_gerberUnitInch )
-            fscale *= 25.4;     // size in mm
+    if(! m_gerberUnitInch )
+        fscale *= 25.4;     // size in mm
 
-        int attribute = tool->m_ApertureAttribute;
+    int attribute = aAperture.m_ApertureAttribute;
 
-        if( attribute != m_apertureAttribute )
+    // The aperture attribute applies to the apertures defined after it.  Only this
+    // attribute is deleted, as %TD*% would also delete the object attributes of the
+    // item being plotted
+    if( attribute != m_apertureAttribute )
+    {
+        if( attribute )
             fputs( GBR_APERTURE_METADATA::FormatAttribute(
                     (GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB) attribute ).c_str(), outputFile );
+        else
+            fputs( "%TD.AperFunction*%\n", outputFile );
 
-        char* text = cbuf + sprintf( cbuf, "%%ADD%d", tool->m_DCode );
+        m_apertureAttribute = attribute;
+    }
 
-        /* Please note: the Gerber specs for mass parameters say that
-           exponential syntax is *not* allowed and the decimal point should
-           also be always inserted. So the %g format is ruled out, but %f is fine
-           (the # modifier forces the decimal point). Sadly the %f formatter
-           can't remove trailing zeros but thats not a problem, since nothing
-           forbid it (the file is only slightly longer) */
+    char* text = cbuf + sprintf( cbuf, "%%ADD%d", aAperture.m_DCode );
 
-        switch( tool->m_Type )
-        {
-        case APERTURE::Circle:
-            sprintf( text, "C,%#f*%%\n", tool->m_Size.x * fscale );
-            break;
-
-        case APERTURE::Rect:
-            sprintf( text, "R,%#fX%#f*%%\n",
-	             tool->m_Size.x * fscale,
-                     tool->m_Size.y * fscale );
-            break;
-
-        case APERTURE::Plotting:
-            sprintf( text, "C,%#f*%%\n", tool->m_Size.x * fscale );
-            break;
-
-        case APERTURE::Oval:
-            sprintf( text, "O,%#fX%#f*%%\n",
-	            tool->m_Size.x * fscale,
-		    tool->m_Size.y * fscale );
-            break;
-        }
+    /* Please note: the Gerber specs for mass parameters say that
+       exponential syntax is *not* allowed and the decimal point should
+       also be always inserted. So the %g format is ruled out, but %f is fine
+       (the # modifier forces the decimal point). Sadly the %f formatter
+       can't remove trailing zeros but thats not a problem, since nothing
+       forbid it (the file is only slightly longer) */
 
-        fputs( cbuf, outputFile );
+    switch( aAperture.m_Type )
+    {
+    case APERTURE::Circle:
+        sprintf( text, "C,%#f*%%\n", aAperture.m_Size.x * fscale );
+        break;
 
-        m_apertureAttribute = attribute;
+    case APERTURE::Rect:
+        sprintf( text, "R,%#fX%#f*%%\n",
+                 aAperture.m_Size.x * fscale,
+                 aAperture.m_Size.y * fscale );
+        break;
 
-        // Currently reset the aperture attribute. Perhaps a better optimization
-        // is to store the last attribute
-        if( attribute )
-        {
-            fputs( "%TD*%\n", outputFile );
-            m_apertureAttribute = 0;
-        }
+    case APERTURE::Plotting:
+        sprintf( text, "C,%#f*%%\n", aAperture.m_Size.x * fscale );
+        break;
 
+    case APERTURE::Oval:
+        sprintf( text, "O,%#fX%#f*%%\n",
+                 aAperture.m_Size.x * fscale,
+                 aAperture.m_Size.y * fscale );
+        break;
     }
+
+    fputs( cbuf, outputFile );
 }
 
 
@@ -93,6 +93,20 @@ static const wxString GalDisplayOptionsKeyword( wxT( "GalDisplayOptions" ) );
  */
 static const wxString MaxUndoItemsEntry(wxT( "DevelMaxUndoItems" ) );
 
+/**
+ * Integer to set the maximum memory, in MiB, used by each of the undo and redo
+ * stacks.  When exceeded, the oldest commands are dropped.  If zero, the undo
+ * memory is unlimited.
+ *
+ * Present as:
+ *
+ * - PcbFrameDevelMaxUndoMemory (file: pcbnew)
+ * - ModEditFrameDevelMaxUndoMemory (file: pcbnew)
+ *
+ * \ingroup develconfig
+ */
+static const wxString MaxUndoMemoryEntry(wxT( "DevelMaxUndoMemory" ) );
+
 BEGIN_EVENT_TABLE( EDA_DRAW_FRAME, KIWAY_PLAYER )
     EVT_MOUSEWHEEL( EDA_DRAW_FRAME::OnMouseEvent )
     EVT_MENU_OPEN( EDA_DRAW_FRAME::OnMenuOpen )
@@ -161,6 +175,7 @@ EDA_DRAW_FRAME::EDA_DRAW_FRAME( KIWAY* aKiway, wxWindow* aParent,
     m_MsgFrameHeight      = EDA_MSG_PANEL::GetRequiredHeight();
     m_movingCursorWithKeyboard = false;
     m_zoomLevelCoeff      = 1.0;
+    m_UndoRedoMemoryMax   = 0;
 
     m_auimgr.SetFlags(wxAUI_MGR_DEFAULT|wxAUI_MGR_LIVE_RESIZE);
 
@@ -728,6 +743,11 @@ void EDA_DRAW_FRAME::LoadSettings( wxConfigBase* aCfg )
     m_UndoRedoCountMax = aCfg->Read( baseCfgName + MaxUndoItemsEntry,
             long( DEFAULT_MAX_UNDO_ITEMS ) );
 
+    aCfg->Read( baseCfgName + MaxUndoMemoryEntry, &m_UndoRedoMemoryMax, 0L );
+
+    if( m_UndoRedoMemoryMax < 0 )
+        m_UndoRedoMemoryMax = 0;
+
     m_galDisplayOptions->ReadConfig( aCfg, baseCfgName + GalDisplayOptionsKeyword );
 }
 
@@ -746,6 +766,8 @@ void EDA_DRAW_FRAME::SaveSettings( wxConfigBase* aCfg )
     if( GetScreen() )
         aCfg->Write( baseCfgName + MaxUndoItemsEntry, long( GetScreen()->GetMaxUndoItems() ) );
 
+    aCfg->Write( baseCfgName + MaxUndoMemoryEntry, m_UndoRedoMemoryMax );
+
     m_galDisplayOptions->WriteConfig( aCfg, baseCfgName + GalDisplayOptionsKeyword );
 }
 
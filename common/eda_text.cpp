@@ -79,6 +79,8 @@ void EDA_TEXT::SwapEffects( EDA_TEXT& aTradingPartner )
 
 int EDA_TEXT::LenSize( const wxString& aLine ) const
 {
+    MUTLOCK lock( basic_gal_lock );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetGlyphSize( VECTOR2D( GetTextSize() ) );
@@ -776,6 +776,14 @@ void OPENGL_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
 
 void OPENGL_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
 {
+    // Sets which keep their triangulation (e.g. zone fills) are drawn from it; temporary
+    // sets are not worth triangulating for a single draw and are tesselated by GLU
+    if( aPolySet.IsTriangulationUpToDate() )
+    {
+        drawTriangulatedPolyset( aPolySet );
+        return;
+    }
+
     for( int j = 0; j < aPolySet.OutlineCount(); ++j )
     {
         const SHAPE_LINE_CHAIN& outline = aPolySet.COutline( j );
@@ -1490,6 +1498,33 @@ void OPENGL_GAL::drawPolygon( GLdouble* aPoints, int aPointCount )
 }
 
 
+void OPENGL_GAL::drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet )
+{
+    currentManager->Shader( SHADER_NONE );
+    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
+
+    for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
+    {
+        auto triPoly = aPolySet.TriangulatedPolygon( j );
+
+        if( triPoly->GetTriangleCount() == 0 )
+            continue;
+
+        currentManager->Reserve( 3 * triPoly->GetTriangleCount() );
+
+        for( int i = 0; i < triPoly->GetTriangleCount(); i++ )
+        {
+            VECTOR2I a, b, c;
+            triPoly->GetTriangle( i, a, b, c );
+
+            currentManager->Vertex( a.x, a.y, layerDepth );
+            currentManager->Vertex( b.x, b.y, layerDepth );
+            currentManager->Vertex( c.x, c.y, layerDepth );
+        }
+    }
+}
+
+
 void OPENGL_GAL::drawPolyline( std::function<VECTOR2D (int)> aPointGetter, int aPointCount )
 {
     if( aPointCount < 2 )
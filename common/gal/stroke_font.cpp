@@ -30,6 +30,11 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <wx/string.h>
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 using namespace KIGFX;
 
 const double STROKE_FONT::INTERLINE_PITCH_RATIO = 1.5;
@@ -38,54 +43,44 @@ const double STROKE_FONT::BOLD_FACTOR = 1.3;
 const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
-STROKE_FONT::STROKE_FONT( GAL* aGal ) :
-    m_gal( aGal )
+GLYPH_TABLE::GLYPH_TABLE( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
-}
-
+    const double scale = STROKE_FONT::STROKE_FONT_SCALE;
 
-bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
-{
-    m_glyphs.clear();
-    m_glyphBoundingBoxes.clear();
-    m_glyphs.resize( aNewStrokeFontSize );
-    m_glyphBoundingBoxes.resize( aNewStrokeFontSize );
+    m_glyphStrokes.reserve( aNewStrokeFontSize + 1 );
+    m_boundingBoxes.reserve( aNewStrokeFontSize );
+    m_glyphStrokes.push_back( 0 );
+    m_strokePoints.push_back( 0 );
 
     for( int j = 0; j < aNewStrokeFontSize; j++ )
     {
-        GLYPH    glyph;
+        const char* glyph = aNewStrokeFont[j];
         double   glyphStartX = 0.0;
         double   glyphEndX = 0.0;
-        VECTOR2D glyphBoundingX;
 
-        std::deque<VECTOR2D> pointList;
+        // The bounding box spans the glyph width and the vertical extent of its points
+        std::deque<VECTOR2D> boundingPoints;
 
         int i = 0;
 
-        while( aNewStrokeFont[j][i] )
+        while( glyph[i] )
         {
-            VECTOR2D    point( 0.0, 0.0 );
-            char        coordinate[2] = { 0, };
-
-            for( int k = 0; k < 2; k++ )
-            {
-                coordinate[k] = aNewStrokeFont[j][i + k];
-            }
+            char coordinate[2] = { glyph[i], glyph[i + 1] };
 
             if( i < 2 )
             {
                 // The first two values contain the width of the char
-                glyphStartX     = ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE;
-                glyphEndX       = ( coordinate[1] - 'R' ) * STROKE_FONT_SCALE;
-                glyphBoundingX  = VECTOR2D( 0, glyphEndX - glyphStartX );
+                glyphStartX     = ( coordinate[0] - 'R' ) * scale;
+                glyphEndX       = ( coordinate[1] - 'R' ) * scale;
+
+                boundingPoints.push_back( VECTOR2D( 0, 0 ) );
+                boundingPoints.push_back( VECTOR2D( glyphEndX - glyphStartX, 0 ) );
             }
             else if( ( coordinate[0] == ' ' ) && ( coordinate[1] == 'R' ) )
             {
                 // Raise pen
-                if( pointList.size() > 0 )
-                    glyph.push_back( pointList );
-
-                pointList.clear();
+                if( (int) m_points.size() > m_strokePoints.back() )
+                    m_strokePoints.push_back( m_points.size() );
             }
             else
             {
@@ -97,65 +92,81 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
                 //  * the stroke coordinates are stored in reduced form (-1.0 to +1.0),
                 //    and the actual size is stroke coordinate * glyph size
                 //  * a few shapes have a height slightly bigger than 1.0 ( like '{' '[' )
-                point.x = (double) ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE - glyphStartX;
+                VECTOR2D point;
+                point.x = (double) ( coordinate[0] - 'R' ) * scale - glyphStartX;
                 #define FONT_OFFSET -10
-				// FONT_OFFSET is here for historical reasons, due to the way the stroke font
+                // FONT_OFFSET is here for historical reasons, due to the way the stroke font
                 // was built. It allows shapes coordinates like W M ... to be >= 0
                 // Only shapes like j y have coordinates < 0
-                point.y = (double) ( coordinate[1] - 'R' + FONT_OFFSET ) * STROKE_FONT_SCALE;
-                pointList.push_back( point );
+                point.y = (double) ( coordinate[1] - 'R' + FONT_OFFSET ) * scale;
+
+                m_points.push_back( point );
+                boundingPoints.push_back( VECTOR2D( 0, point.y ) );
             }
 
             i += 2;
         }
 
-        if( pointList.size() > 0 )
-            glyph.push_back( pointList );
+        // Close the last stroke of the glyph
+        if( (int) m_points.size() > m_strokePoints.back() )
+            m_strokePoints.push_back( m_points.size() );
 
-        m_glyphs[j] = glyph;
+        m_glyphStrokes.push_back( m_strokePoints.size() - 1 );
 
-        // Compute the bounding box of the glyph
-        m_glyphBoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
+        BOX2D boundingBox;
+        boundingBox.Compute( boundingPoints );
+        m_boundingBoxes.push_back( boundingBox );
     }
 
-    return true;
+    m_points.shrink_to_fit();
+    m_strokePoints.shrink_to_fit();
 }
 
 
-// Static function:
-double STROKE_FONT::GetInterline( double aGlyphHeight, double aGlyphThickness )
+std::shared_ptr<const GLYPH_TABLE> GLYPH_TABLE::Get( const char* const aNewStrokeFont[],
+                                                     int aNewStrokeFontSize )
 {
-    return ( aGlyphHeight * INTERLINE_PITCH_RATIO ) + aGlyphThickness;
+    // Every GAL (including the BASIC_GAL used for plotting and legacy drawing) owns a
+    // STROKE_FONT, so the same font data would otherwise be decoded again for each of them.
+    // Font data are static tables, so the decoded glyphs are kept for the process lifetime.
+    static std::mutex lock;
+    static std::map<const char* const*, std::shared_ptr<const GLYPH_TABLE>> cache;
+
+    std::lock_guard<std::mutex> guard( lock );
+
+    std::shared_ptr<const GLYPH_TABLE>& table = cache[aNewStrokeFont];
+
+    if( !table || table->GlyphCount() != aNewStrokeFontSize )
+        table = std::make_shared<GLYPH_TABLE>( aNewStrokeFont, aNewStrokeFontSize );
+
+    return table;
 }
 
 
-int STROKE_FONT::getInterline() const
+STROKE_FONT::STROKE_FONT( GAL* aGal ) :
+    m_gal( aGal )
 {
-    return KiROUND( GetInterline( m_gal->GetGlyphSize().y, m_gal->GetLineWidth() ) );
 }
 
 
-BOX2D STROKE_FONT::computeBoundingBox( const GLYPH& aGLYPH, const VECTOR2D& aGLYPHBoundingX ) const
+bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
-    BOX2D boundingBox;
+    m_glyphs = GLYPH_TABLE::Get( aNewStrokeFont, aNewStrokeFontSize );
 
-    std::deque<VECTOR2D> boundingPoints;
+    return true;
+}
 
-    boundingPoints.push_back( VECTOR2D( aGLYPHBoundingX.x, 0 ) );
-    boundingPoints.push_back( VECTOR2D( aGLYPHBoundingX.y, 0 ) );
 
-    for( GLYPH::const_iterator pointListIt = aGLYPH.begin(); pointListIt != aGLYPH.end(); ++pointListIt )
-    {
-        for( std::deque<VECTOR2D>::const_iterator pointIt = pointListIt->begin();
-                pointIt != pointListIt->end(); ++pointIt )
-        {
-            boundingPoints.push_back( VECTOR2D( aGLYPHBoundingX.x, pointIt->y ) );
-        }
-    }
+// Static function:
+double STROKE_FONT::GetInterline( double aGlyphHeight, double aGlyphThickness )
+{
+    return ( aGlyphHeight * INTERLINE_PITCH_RATIO ) + aGlyphThickness;
+}
 
-    boundingBox.Compute( boundingPoints );
 
-    return boundingBox;
+int STROKE_FONT::getInterline() const
+{
+    return KiROUND( GetInterline( m_gal->GetGlyphSize().y, m_gal->GetLineWidth() ) );
 }
 
 
@@ -239,59 +250,130 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
 }
 
 
-void STROKE_FONT::drawSingleLineText( const UTF8& aText )
+namespace KIGFX
 {
-    // By default the overbar is turned off
-    bool overbar = false;
 
-    double      xOffset;
-    VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
-    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
+/**
+ * Struct SHAPED_TEXT_LINE
+ * holds a single line of text laid out with the stroke font: the strokes of all the glyphs
+ * (and the overbars), already scaled, slanted and placed along the line.
+ */
+struct SHAPED_TEXT_LINE
+{
+    struct STROKE
+    {
+        int  m_first;           ///< Index of the first point in m_points
+        int  m_count;           ///< Number of points
+        bool m_isOverbar;       ///< Overbars are drawn as lines, glyph strokes as polylines
+    };
+
+    VECTOR2D                m_textSize;
+    std::vector<VECTOR2D>   m_points;
+    std::vector<STROKE>     m_strokes;
+};
+
+
+/**
+ * Class SHAPED_TEXT_CACHE
+ * is a process wide, size limited (least recently used entries are dropped) cache of shaped
+ * text lines. It is shared by all the GALs, so texts drawn by the painters, plotted or
+ * converted to polygons (through BASIC_GAL) are laid out only once.
+ */
+class SHAPED_TEXT_CACHE
+{
+public:
+    typedef std::tuple<const GLYPH_TABLE*, std::string, double, double, double, bool, bool> KEY;
+    typedef std::shared_ptr<const SHAPED_TEXT_LINE> ENTRY;
 
-    if( m_gal->IsTextMirrored() )
-        overbar_italic_comp = -overbar_italic_comp;
+    static SHAPED_TEXT_CACHE& Instance()
+    {
+        static SHAPED_TEXT_CACHE cache;
+        return cache;
+    }
 
-    // Compute the text size
-    VECTOR2D textSize = computeTextLineSize( aText );
-    double half_thickness = m_gal->GetLineWidth()/2;
+    ENTRY Get( const KEY& aKey )
+    {
+        std::lock_guard<std::mutex> guard( m_lock );
 
-    // Context needs to be saved before any transformations
-    m_gal->Save();
+        auto it = m_index.find( aKey );
 
-    // First adjust: the text X position is corrected by half_thickness
-    // because when the text with thickness is draw, its full size is textSize,
-    // but the position of lines is half_thickness to textSize - half_thickness
-    // so we must translate the coordinates by half_thickness on the X axis
-    // to place the text inside the 0 to textSize X area.
-    m_gal->Translate( VECTOR2D( half_thickness, 0 ) );
+        if( it == m_index.end() )
+            return ENTRY();
 
-    // Adjust the text position to the given horizontal justification
-    switch( m_gal->GetHorizontalJustify() )
+        // Move the entry to the front of the LRU list
+        m_lru.splice( m_lru.begin(), m_lru, it->second );
+
+        return it->second->second;
+    }
+
+    void Put( const KEY& aKey, const ENTRY& aEntry )
     {
-    case GR_TEXT_HJUSTIFY_CENTER:
-        m_gal->Translate( VECTOR2D( -textSize.x / 2.0, 0 ) );
-        break;
+        std::lock_guard<std::mutex> guard( m_lock );
 
-    case GR_TEXT_HJUSTIFY_RIGHT:
-        if( !m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
-        break;
+        auto it = m_index.find( aKey );
 
-    case GR_TEXT_HJUSTIFY_LEFT:
-        if( m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
-        break;
+        if( it != m_index.end() )
+            m_lru.erase( it->second );
 
-    default:
-        break;
+        m_lru.push_front( std::make_pair( aKey, aEntry ) );
+        m_index[aKey] = m_lru.begin();
+
+        if( m_lru.size() > MAX_ENTRIES )
+        {
+            m_index.erase( m_lru.back().first );
+            m_lru.pop_back();
+        }
     }
 
-    if( m_gal->IsTextMirrored() )
+private:
+    ///> Number of text lines kept in the cache
+    static const size_t MAX_ENTRIES = 32768;
+
+    typedef std::list< std::pair<KEY, ENTRY> > LRU_LIST;
+
+    std::mutex                              m_lock;
+    LRU_LIST                                m_lru;
+    std::map<KEY, LRU_LIST::iterator>       m_index;
+};
+
+} // namespace KIGFX
+
+
+std::shared_ptr<const SHAPED_TEXT_LINE> STROKE_FONT::shapeSingleLineText( const UTF8& aText ) const
+{
+    VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
+    bool        italic = m_gal->IsFontItalic();
+    bool        mirrored = m_gal->IsTextMirrored();
+
+    SHAPED_TEXT_CACHE::KEY key( m_glyphs.get(), aText, glyphSize.x, glyphSize.y,
+                                m_gal->GetLineWidth(), italic, mirrored );
+
+    SHAPED_TEXT_CACHE& cache = SHAPED_TEXT_CACHE::Instance();
+    SHAPED_TEXT_CACHE::ENTRY shaped = cache.Get( key );
+
+    if( shaped )
+        return shaped;
+
+    auto line = std::make_shared<SHAPED_TEXT_LINE>();
+
+    // By default the overbar is turned off
+    bool overbar = false;
+
+    double      xOffset;
+    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
+
+    if( mirrored )
+        overbar_italic_comp = -overbar_italic_comp;
+
+    // Compute the text size
+    line->m_textSize = computeTextLineSize( aText );
+
+    if( mirrored )
     {
         // In case of mirrored text invert the X scale of points and their X direction
         // (m_glyphSize.x) and start drawing from the position where text normally should end
         // (textSize.x)
-        xOffset = textSize.x - m_gal->GetLineWidth();
+        xOffset = line->m_textSize.x - m_gal->GetLineWidth();
         glyphSize.x = -glyphSize.x;
     }
     else
@@ -318,13 +400,8 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             // If it is a double tilda, just process the second one
         }
 
-        int dd = *chIt - ' ';
-
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
-            dd = '?' - ' ';
-
-        GLYPH& glyph = m_glyphs[dd];
-        BOX2D& bbox  = m_glyphBoundingBoxes[dd];
+        int dd = glyphIndex( *chIt );
+        const BOX2D& bbox = m_glyphs->BoundingBox( dd );
 
         if( overbar )
         {
@@ -339,45 +416,103 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
                 last_had_overbar = true;
             }
 
-            VECTOR2D startOverbar( overbar_start_x, overbar_start_y );
-            VECTOR2D endOverbar( overbar_end_x, overbar_end_y );
-
-            m_gal->DrawLine( startOverbar, endOverbar );
+            SHAPED_TEXT_LINE::STROKE stroke = { (int) line->m_points.size(), 2, true };
+            line->m_strokes.push_back( stroke );
+            line->m_points.push_back( VECTOR2D( overbar_start_x, overbar_start_y ) );
+            line->m_points.push_back( VECTOR2D( overbar_end_x, overbar_end_y ) );
         }
         else
         {
             last_had_overbar = false;
         }
 
-        for( GLYPH::iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
-             ++pointListIt )
+        for( int stroke = m_glyphs->FirstStroke( dd ); stroke < m_glyphs->EndStroke( dd );
+             ++stroke )
         {
-            std::deque<VECTOR2D> pointListScaled;
+            const VECTOR2D* points = m_glyphs->StrokePoints( stroke );
+            int pointCount = m_glyphs->StrokePointCount( stroke );
+
+            SHAPED_TEXT_LINE::STROKE shapedStroke = { (int) line->m_points.size(), pointCount,
+                                                      false };
+            line->m_strokes.push_back( shapedStroke );
 
-            for( std::deque<VECTOR2D>::iterator pointIt = pointListIt->begin();
-                 pointIt != pointListIt->end(); ++pointIt )
+            for( int i = 0; i < pointCount; ++i )
             {
-                VECTOR2D pointPos( pointIt->x * glyphSize.x + xOffset, pointIt->y * glyphSize.y );
+                VECTOR2D pointPos( points[i].x * glyphSize.x + xOffset, points[i].y * glyphSize.y );
 
-                if( m_gal->IsFontItalic() )
+                if( italic )
                 {
                     // FIXME should be done other way - referring to the lowest Y value of point
                     // because now italic fonts are translated a bit
-                    if( m_gal->IsTextMirrored() )
+                    if( mirrored )
                         pointPos.x += pointPos.y * STROKE_FONT::ITALIC_TILT;
                     else
                         pointPos.x -= pointPos.y * STROKE_FONT::ITALIC_TILT;
                 }
 
-                pointListScaled.push_back( pointPos );
+                line->m_points.push_back( pointPos );
             }
-
-            m_gal->DrawPolyline( pointListScaled );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
     }
 
+    cache.Put( key, line );
+
+    return line;
+}
+
+
+void STROKE_FONT::drawSingleLineText( const UTF8& aText )
+{
+    // The layout of the line does not depend on its position, so it is shared by all the
+    // occurrences of the same text with the same attributes
+    std::shared_ptr<const SHAPED_TEXT_LINE> line = shapeSingleLineText( aText );
+
+    const VECTOR2D& textSize = line->m_textSize;
+    double half_thickness = m_gal->GetLineWidth()/2;
+
+    // Context needs to be saved before any transformations
+    m_gal->Save();
+
+    // First adjust: the text X position is corrected by half_thickness
+    // because when the text with thickness is draw, its full size is textSize,
+    // but the position of lines is half_thickness to textSize - half_thickness
+    // so we must translate the coordinates by half_thickness on the X axis
+    // to place the text inside the 0 to textSize X area.
+    m_gal->Translate( VECTOR2D( half_thickness, 0 ) );
+
+    // Adjust the text position to the given horizontal justification
+    switch( m_gal->GetHorizontalJustify() )
+    {
+    case GR_TEXT_HJUSTIFY_CENTER:
+        m_gal->Translate( VECTOR2D( -textSize.x / 2.0, 0 ) );
+        break;
+
+    case GR_TEXT_HJUSTIFY_RIGHT:
+        if( !m_gal->IsTextMirrored() )
+            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+        break;
+
+    case GR_TEXT_HJUSTIFY_LEFT:
+        if( m_gal->IsTextMirrored() )
+            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+        break;
+
+    default:
+        break;
+    }
+
+    for( const SHAPED_TEXT_LINE::STROKE& stroke : line->m_strokes )
+    {
+        const VECTOR2D* points = &line->m_points[stroke.m_first];
+
+        if( stroke.m_isOverbar )
+            m_gal->DrawLine( points[0], points[1] );
+        else
+            m_gal->DrawPolyline( points, stroke.m_count );
+    }
+
     m_gal->Restore();
 }
 
@@ -426,13 +561,7 @@ VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, VECTOR2D a
                 break;
         }
 
-        // Index in the bounding boxes table
-        int dd = *it - ' ';
-
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
-            dd = '?' - ' ';
-
-        const BOX2D& box = m_glyphBoundingBoxes[dd];
+        const BOX2D& box = m_glyphs->BoundingBox( glyphIndex( *it ) );
 
         string_bbox.x += box.GetEnd().x;
 
@@ -80,6 +80,19 @@ int SHAPE_LINE_CHAIN::Length() const
 }
 
 
+double SHAPE_LINE_CHAIN::Area() const
+{
+    // Shoelace formula, in doubles to avoid overflows with large coordinates
+    double area = 0.0;
+    int    count = PointCount();
+
+    for( int i = 0, j = count - 1; i < count; j = i++ )
+        area += (double) m_points[j].x * m_points[i].y - (double) m_points[i].x * m_points[j].y;
+
+    return area / 2.0;
+}
+
+
 void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I& aP )
 {
     if( aEndIndex < 0 )
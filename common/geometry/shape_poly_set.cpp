@@ -39,16 +39,23 @@
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
 
+#include <poly2tri/poly2tri.h>
+
 using namespace ClipperLib;
 
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
-    SHAPE( SH_POLY_SET )
+    SHAPE( SH_POLY_SET ),
+    m_triangulationChecksum( 0 ),
+    m_triangulationValid( false )
 {
 }
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys ),
+    m_triangulatedPolys( aOther.m_triangulatedPolys ),
+    m_triangulationChecksum( aOther.m_triangulationChecksum ),
+    m_triangulationValid( aOther.m_triangulationValid )
 {
 }
 
@@ -1661,3 +1668,165 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
 
     return newPoly;
 }
+
+
+uint64_t SHAPE_POLY_SET::checksum() const
+{
+    // FNV-1a over the vertex coordinates and the contour structure
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+
+    auto mix = [&hash, prime] ( uint64_t aValue )
+    {
+        hash ^= aValue;
+        hash *= prime;
+    };
+
+    mix( m_polys.size() );
+
+    for( const POLYGON& poly : m_polys )
+    {
+        mix( poly.size() );
+
+        for( const SHAPE_LINE_CHAIN& path : poly )
+        {
+            mix( path.PointCount() );
+
+            for( int i = 0; i < path.PointCount(); i++ )
+            {
+                const VECTOR2I& p = path.CPoint( i );
+                mix( (uint32_t) p.x );
+                mix( (uint32_t) p.y );
+            }
+        }
+    }
+
+    return hash;
+}
+
+
+bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
+{
+    if( !m_triangulationValid )
+        return false;
+
+    return m_triangulationChecksum == checksum();
+}
+
+
+bool SHAPE_POLY_SET::triangulateSingle( const POLYGON& aPoly, TRIANGULATED_POLYGON& aResult )
+{
+    // poly2tri does not cope well with collinear and nearly coincident points, so as in the
+    // 3D viewer the contours are upscaled and each point is nudged by one (upscaled) unit
+    // towards the previous one before triangulating. See edgeshrink.cpp for details.
+    const double scale = 256.0;
+
+    std::vector< std::vector<p2t::Point> > points( aPoly.size() );
+    std::vector< std::vector<p2t::Point*> > paths( aPoly.size() );
+    std::vector<int> firstVertex( aPoly.size() );
+
+    for( unsigned int i = 0; i < aPoly.size(); i++ )
+    {
+        const SHAPE_LINE_CHAIN& path = aPoly[i];
+        int count = path.PointCount();
+
+        if( count < 3 )
+            return false;
+
+        points[i].reserve( count );
+        paths[i].reserve( count );
+        firstVertex[i] = aResult.GetVertexCount();
+
+        for( int j = 0; j < count; j++ )
+        {
+            const VECTOR2I& p = path.CPoint( j );
+
+            aResult.AddVertex( p );
+            points[i].push_back( p2t::Point( p.x * scale, p.y * scale ) );
+        }
+
+        int prev = count - 1;
+
+        for( int j = 0; j < count; j++ )
+        {
+            p2t::Point& p = points[i][j];
+            const p2t::Point& q = points[i][prev];
+
+            p.x += ( p.x - q.x ) > 0 ? -1.0 : 1.0;
+            p.y += ( p.y - q.y ) > 0 ? -1.0 : 1.0;
+
+            paths[i].push_back( &p );
+            prev = j;
+        }
+    }
+
+    p2t::CDT cdt( paths[0] );
+
+    for( unsigned int i = 1; i < paths.size(); i++ )
+        cdt.AddHole( paths[i] );
+
+    cdt.Triangulate();
+
+    // The triangulation does not create new points, so every triangle corner is one of the
+    // contour points and maps back to the vertex added for it above.
+    auto vertexIndex = [&] ( const p2t::Point* aP )
+    {
+        for( unsigned int i = 0; i < points.size(); i++ )
+        {
+            const p2t::Point* first = points[i].data();
+
+            if( aP >= first && aP < first + points[i].size() )
+                return firstVertex[i] + int( aP - first );
+        }
+
+        wxASSERT_MSG( false, "Triangle corner is not a contour point" );
+        return 0;
+    };
+
+    for( p2t::Triangle* tri : cdt.GetTriangles() )
+    {
+        aResult.AddTriangle( vertexIndex( tri->GetPoint( 0 ) ),
+                             vertexIndex( tri->GetPoint( 1 ) ),
+                             vertexIndex( tri->GetPoint( 2 ) ) );
+    }
+
+    return true;
+}
+
+
+bool SHAPE_POLY_SET::CacheTriangulation() const
+{
+    uint64_t currentChecksum = checksum();
+
+    if( m_triangulationValid && m_triangulationChecksum == currentChecksum )
+        return true;
+
+    m_triangulatedPolys.clear();
+    m_triangulationValid = false;
+
+    // The triangulator requires strictly simple polygons with explicit holes, so convert
+    // e.g. fractured zone fills back to outlines + holes first.
+    // Note: the two sequential calls are needed, see the 3D viewer zone conversion.
+    SHAPE_POLY_SET tmpSet( *this );
+
+    tmpSet.Simplify( PM_FAST );
+    tmpSet.Simplify( PM_STRICTLY_SIMPLE );
+
+    for( const POLYGON& poly : tmpSet.m_polys )
+    {
+        auto triangulated = std::make_shared<TRIANGULATED_POLYGON>();
+
+        if( !triangulateSingle( poly, *triangulated ) )
+        {
+            m_triangulatedPolys.clear();
+            return false;
+        }
+
+        m_triangulatedPolys.push_back( triangulated );
+    }
+
+    m_triangulationChecksum = currentChecksum;
+    m_triangulationValid = true;
+
+    return true;
+}
@@ -35,6 +35,8 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
 
+#include <unordered_set>
+
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__  */
@@ -357,6 +359,47 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         viewData->clearUpdateFlags();
     }
 
+    removeFromLayers( aItem );
+}
+
+
+void VIEW::Remove( const std::vector<VIEW_ITEM*>& aItems )
+{
+    std::unordered_set<VIEW_ITEM*> removed;
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        if( !item )
+            continue;
+
+        auto viewData = item->viewPrivData();
+
+        if( !viewData || !viewData->m_view )
+            continue;
+
+        wxASSERT( viewData->m_view == this );
+
+        viewData->clearUpdateFlags();
+        removeFromLayers( item );
+        removed.insert( item );
+    }
+
+    if( removed.empty() )
+        return;
+
+    m_allItems.erase( std::remove_if( m_allItems.begin(), m_allItems.end(),
+                                      [&removed] ( VIEW_ITEM* aItem )
+                                      {
+                                          return removed.count( aItem ) > 0;
+                                      } ),
+                      m_allItems.end() );
+}
+
+
+void VIEW::removeFromLayers( VIEW_ITEM* aItem )
+{
+    auto viewData = aItem->viewPrivData();
+
     int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
     viewData->getLayers( layers, layers_count );
 
@@ -173,7 +173,9 @@ wxString WS_DRAW_ITEM_LIST::BuildFullText( const wxString& aTextbase )
                 break;
 
             case 'K':
-                msg += productName + Pgm().App().GetAppName();
+                // The same as Pgm().App(), but also valid when there is no program,
+                // e.g. from the pcbnew_batch launcher
+                msg += productName + wxTheApp->GetAppName();
                 msg += wxT( " " ) + GetBuildVersion();
                 break;
 
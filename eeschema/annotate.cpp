@@ -48,6 +48,7 @@ void SCH_EDIT_FRAME::DeleteAnnotation( bool aCurrentSheetOnly )
     {
         SCH_SCREENS ScreenList;
         ScreenList.ClearAnnotation();
+        ScreenList.ConnectivityChanged();
     }
 
     // Update the references for the sheet that is currently being displayed.
@@ -174,6 +175,9 @@ void SCH_EDIT_FRAME::AnnotateComponents( bool              aAnnotateSchematic,
         wxLogWarning( msg );
     }
 
+    // Units of components can have changed in all the sheets, not only in the current one
+    screens.ConnectivityChanged();
+
     OnModify();
 
     // Update on screen references, that can be modified by previous calculations:
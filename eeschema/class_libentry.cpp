@@ -35,6 +35,7 @@
 #include <gr_basic.h>
 #include <class_sch_screen.h>
 #include <richio.h>
+#include <ki_mutex.h>
 
 #include <general.h>
 #include <template_fieldnames.h>
@@ -50,6 +51,38 @@
 #include <lib_text.h>
 
 
+/// Serializes the deferred loading of the part drawings, which can be requested by the
+/// threads reading the schematic sheets.
+static MUTEX drawingsLoadLock;
+
+
+void LIB_PART::SetDrawingsLoader( const LIB_DRAWINGS_LOADER& aLoader )
+{
+    m_drawingsLoader = aLoader;
+    m_drawingsPending.store( bool( m_drawingsLoader ), std::memory_order_release );
+}
+
+
+void LIB_PART::loadPendingDrawings() const
+{
+    MUTLOCK locker( drawingsLoadLock );
+
+    // Another thread may have loaded the drawings while this one was waiting.
+    if( !m_drawingsPending.load( std::memory_order_acquire ) )
+        return;
+
+    LIB_DRAWINGS_LOADER loader;
+
+    std::swap( loader, m_drawingsLoader );
+
+    // The loader is empty if a previous attempt threw.
+    if( loader )
+        loader( const_cast<LIB_ITEMS&>( drawings ) );
+
+    m_drawingsPending.store( false, std::memory_order_release );
+}
+
+
 // the separator char between the subpart id and the reference
 // 0 (no separator) or '.' or some other character
 int LIB_PART::m_subpartIdSeparator = 0;
@@ -178,7 +211,8 @@ struct null_deleter
 
 LIB_PART::LIB_PART( const wxString& aName, PART_LIB* aLibrary ) :
     EDA_ITEM( LIB_PART_T ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_drawingsPending( false )
 {
     m_name                = aName;
     m_library             = aLibrary;
@@ -208,7 +242,8 @@ LIB_PART::LIB_PART( const wxString& aName, PART_LIB* aLibrary ) :
 
 LIB_PART::LIB_PART( LIB_PART& aPart, PART_LIB* aLibrary ) :
     EDA_ITEM( aPart ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_drawingsPending( false )
 {
     LIB_ITEM* newItem;
 
@@ -316,6 +351,8 @@ void LIB_PART::SetName( const wxString& aName )
 void LIB_PART::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDc, const wxPoint& aOffset,
             int aMulti, int aConvert, const PART_DRAW_OPTIONS& aOpts )
 {
+    LoadDrawings();
+
     BASE_SCREEN*   screen = aPanel ? aPanel->GetScreen() : NULL;
 
     GRSetDrawMode( aDc, aOpts.draw_mode );
@@ -459,6 +496,8 @@ void LIB_PART::Plot( PLOTTER* aPlotter, int aUnit, int aConvert,
 {
     wxASSERT( aPlotter != NULL );
 
+    LoadDrawings();
+
     aPlotter->SetColor( GetLayerColor( LAYER_DEVICE ) );
     bool fill = aPlotter->GetColorMode();
 
@@ -507,6 +546,7 @@ void LIB_PART::PlotLibFields( PLOTTER* aPlotter, int aUnit, int aConvert,
     aPlotter->SetColor( GetLayerColor( LAYER_FIELDS ) );
     bool fill = aPlotter->GetColorMode();
 
+    // The fields are never deferred.
     for( LIB_ITEM& item : drawings )
     {
         if( item.Type() != LIB_FIELD_T )
@@ -537,6 +577,8 @@ void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem, EDA_DRAW_PANEL* aPanel, wxDC* aD
 {
     wxASSERT( aItem != NULL );
 
+    LoadDrawings();
+
     // none of the MANDATORY_FIELDS may be removed in RAM, but they may be
     // omitted when saving to disk.
     if( aItem->Type() == LIB_FIELD_T )
@@ -575,6 +617,8 @@ void LIB_PART::AddDrawItem( LIB_ITEM* aItem )
 {
     wxASSERT( aItem != NULL );
 
+    LoadDrawings();
+
     drawings.push_back( aItem );
     drawings.sort();
 }
@@ -585,6 +629,8 @@ LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
     /* Return the next draw object pointer.
      * If item is NULL return the first item of type in the list.
      */
+    LoadDrawings();
+
     if( drawings.empty() )
         return NULL;
 
@@ -625,6 +671,8 @@ void LIB_PART::GetPins( LIB_PINS& aList, int aUnit, int aConvert )
      * when .m_Unit == 0, the body item is common to units
      * when .m_Convert == 0, the body item is common to shapes
      */
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         if( item.Type() != LIB_PIN_T )    // we search pins only
@@ -725,6 +773,8 @@ bool LIB_PART::PinsConflictWith( LIB_PART& aOtherPart, bool aTestNums, bool aTes
 
 bool LIB_PART::Save( OUTPUTFORMATTER& aFormatter )
 {
+    LoadDrawings();
+
     LIB_FIELD&  value = GetValueField();
 
     // First line: it s a comment (component name for readers)
@@ -1166,6 +1216,8 @@ bool LIB_PART::LoadFootprints( LINE_READER& aLineReader, wxString& aErrorMsg )
 
 const EDA_RECT LIB_PART::GetUnitBoundingBox( int aUnit, int aConvert ) const
 {
+    LoadDrawings();
+
     EDA_RECT bBox;
     bool initialized = false;
 
@@ -1198,6 +1250,8 @@ const EDA_RECT LIB_PART::GetUnitBoundingBox( int aUnit, int aConvert ) const
 
 const EDA_RECT LIB_PART::GetBodyBoundingBox( int aUnit, int aConvert ) const
 {
+    LoadDrawings();
+
     EDA_RECT bBox;
     bool initialized = false;
 
@@ -1248,6 +1302,8 @@ void LIB_PART::deleteAllFields()
 
 void LIB_PART::SetFields( const std::vector <LIB_FIELD>& aFields )
 {
+    LoadDrawings();
+
     deleteAllFields();
 
     for( unsigned i=0;  i<aFields.size();  ++i )
@@ -1284,7 +1340,7 @@ void LIB_PART::GetFields( LIB_FIELDS& aList )
         aList.push_back( *field );
     }
 
-    // Now grab all the rest of fields.
+    // Now grab all the rest of fields, which are never deferred.
     for( LIB_ITEM& item : drawings )
     {
         if( item.Type() != LIB_FIELD_T )
@@ -1302,6 +1358,7 @@ void LIB_PART::GetFields( LIB_FIELDS& aList )
 
 LIB_FIELD* LIB_PART::GetField( int aId )
 {
+    // The fields are never deferred.
     for( LIB_ITEM& item : drawings )
     {
         if( item.Type() != LIB_FIELD_T )
@@ -1319,6 +1376,7 @@ LIB_FIELD* LIB_PART::GetField( int aId )
 
 LIB_FIELD* LIB_PART::FindField( const wxString& aFieldName )
 {
+    // The fields are never deferred.
     for( LIB_ITEM& item : drawings )
     {
         if( item.Type() != LIB_FIELD_T )
@@ -1391,6 +1449,8 @@ bool LIB_PART::LoadDateAndTime( char* aLine )
 
 void LIB_PART::SetOffset( const wxPoint& aOffset )
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         item.SetOffset( aOffset );
@@ -1400,12 +1460,16 @@ void LIB_PART::SetOffset( const wxPoint& aOffset )
 
 void LIB_PART::RemoveDuplicateDrawItems()
 {
+    LoadDrawings();
+
     drawings.unique();
 }
 
 
 bool LIB_PART::HasConversion() const
 {
+    LoadDrawings();
+
     for( unsigned ii = 0; ii < drawings.size(); ii++  )
     {
         const LIB_ITEM& item = drawings[ii];
@@ -1419,6 +1483,8 @@ bool LIB_PART::HasConversion() const
 
 void LIB_PART::ClearStatus()
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         item.m_Flags = 0;
@@ -1428,6 +1494,8 @@ void LIB_PART::ClearStatus()
 
 int LIB_PART::SelectItems( EDA_RECT& aRect, int aUnit, int aConvert, bool aEditPinByPin )
 {
+    LoadDrawings();
+
     int itemCount = 0;
 
     for( LIB_ITEM& item : drawings )
@@ -1459,6 +1527,8 @@ int LIB_PART::SelectItems( EDA_RECT& aRect, int aUnit, int aConvert, bool aEditP
 
 void LIB_PART::MoveSelectedItems( const wxPoint& aOffset )
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         if( !item.IsSelected() )
@@ -1474,6 +1544,8 @@ void LIB_PART::MoveSelectedItems( const wxPoint& aOffset )
 
 void LIB_PART::ClearSelectedItems()
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         item.m_Flags = 0;
@@ -1483,6 +1555,8 @@ void LIB_PART::ClearSelectedItems()
 
 void LIB_PART::DeleteSelectedItems()
 {
+    LoadDrawings();
+
     LIB_ITEMS::iterator item = drawings.begin();
 
     // We *do not* remove the 2 mandatory fields: reference and value
@@ -1518,6 +1592,8 @@ void LIB_PART::CopySelectedItems( const wxPoint& aOffset )
      * When push_back elements in buffer,
      * a memory reallocation can happen and will break pointers
      */
+    LoadDrawings();
+
     unsigned icnt = drawings.size();
 
     for( unsigned ii = 0; ii < icnt; ii++  )
@@ -1546,6 +1622,8 @@ void LIB_PART::CopySelectedItems( const wxPoint& aOffset )
 
 void LIB_PART::MirrorSelectedItemsH( const wxPoint& aCenter )
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         if( !item.IsSelected() )
@@ -1560,6 +1638,8 @@ void LIB_PART::MirrorSelectedItemsH( const wxPoint& aCenter )
 
 void LIB_PART::MirrorSelectedItemsV( const wxPoint& aCenter )
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         if( !item.IsSelected() )
@@ -1574,6 +1654,8 @@ void LIB_PART::MirrorSelectedItemsV( const wxPoint& aCenter )
 
 void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         if( !item.IsSelected() )
@@ -1591,6 +1673,8 @@ void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
 LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert,
                                     KICAD_T aType, const wxPoint& aPoint )
 {
+    LoadDrawings();
+
     for( LIB_ITEM& item : drawings )
     {
         if( ( aUnit && item.m_Unit && ( aUnit != item.m_Unit) )
@@ -1629,6 +1713,8 @@ LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert, KICAD_T aType,
 
 void LIB_PART::SetUnitCount( int aCount )
 {
+    LoadDrawings();
+
     if( m_unitCount == aCount )
         return;
 
@@ -1676,6 +1762,8 @@ void LIB_PART::SetUnitCount( int aCount )
 
 void LIB_PART::SetConversion( bool aSetConvert )
 {
+    LoadDrawings();
+
     if( aSetConvert == HasConversion() )
         return;
 
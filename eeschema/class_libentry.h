@@ -36,6 +36,8 @@
 #include <lib_field.h>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <functional>
 
 class EDA_RECT;
 class LINE_READER;
@@ -211,6 +213,13 @@ struct PART_DRAW_OPTIONS
 };
 
 
+/**
+ * Parses the deferred drawings of a LIB_PART, appending them to \a aItems, which is
+ * the draw item list of the part.  It must not call the LIB_PART itself.
+ */
+typedef std::function<void( LIB_ITEMS& aItems )> LIB_DRAWINGS_LOADER;
+
+
 /**
  * Class LIB_PART
  * defines a library part object.
@@ -237,6 +246,8 @@ class LIB_PART : public EDA_ITEM
     LIBRENTRYOPTIONS    m_options;          ///< Special part features such as POWER or NORMAL.)
     int                 m_unitCount;        ///< Number of units (parts) per package.
     LIB_ITEMS           drawings;           ///< How to draw this part.
+    mutable LIB_DRAWINGS_LOADER m_drawingsLoader;   ///< Parses the deferred drawings.
+    mutable std::atomic<bool>   m_drawingsPending;  ///< The drawings are not loaded yet.
     wxArrayString       m_FootprintList;    /**< List of suitable footprint names for the
                                                  part (wild card names accepted). */
     LIB_ALIASES         m_aliases;          ///< List of alias object pointers associated with the
@@ -251,6 +262,7 @@ class LIB_PART : public EDA_ITEM
                                             ///< other values have no sense.
 private:
     void deleteAllFields();
+    void loadPendingDrawings() const;
 
     // LIB_PART()  { }     // not legal
 
@@ -681,7 +693,27 @@ public:
      *
      * @return LIB_ITEMS& - Reference to the draw item object list.
      */
-    LIB_ITEMS& GetDrawItemList() { return drawings; }
+    LIB_ITEMS& GetDrawItemList() { LoadDrawings(); return drawings; }
+
+    /**
+     * Function SetDrawingsLoader
+     * defers the loading of the graphic items and pins of the part: \a aLoader is called
+     * once, by LoadDrawings(), the first time they are needed.  Library plugins use it to
+     * index the parts of a library without parsing their drawings.  The fields are never
+     * deferred.
+     */
+    void SetDrawingsLoader( const LIB_DRAWINGS_LOADER& aLoader );
+
+    /**
+     * Function LoadDrawings
+     * runs the deferred drawings loader, if any.  Every access to the draw item list
+     * other than the fields goes through it.  Thread safe.
+     */
+    void LoadDrawings() const
+    {
+        if( m_drawingsPending.load( std::memory_order_acquire ) )
+            loadPendingDrawings();
+    }
 
     /**
      * Set the units per part count.
@@ -28,6 +28,7 @@
  */
 
 #include <algorithm>
+#include <set>
 #include <fctsys.h>
 #include <kiface_i.h>
 #include <gr_basic.h>
@@ -45,6 +46,8 @@
 #include <general.h>
 #include <class_library.h>
 #include <sch_legacy_plugin.h>
+#include <symbol_libs_loader.h>
+#include <lib_trigram_index.h>
 
 #include <wx/progdlg.h>
 #include <wx/tokenzr.h>
@@ -59,7 +62,8 @@ PART_LIB::PART_LIB( int aType, const wxString& aFileName, SCH_IO_MGR::SCH_FILE_T
     // start @ != 0 so each additional library added
     // is immediately detectable, zero would not be.
     m_mod_hash( PART_LIBS::s_modify_generation ),
-    m_pluginType( aPluginType )
+    m_pluginType( aPluginType ),
+    m_trigramIndexHash( 0 )
 {
     type = aType;
     isModified = false;
@@ -164,6 +168,24 @@ void PART_LIB::GetAliases( std::vector<LIB_ALIAS*>& aAliases )
 }
 
 
+std::shared_ptr< const LIB_TRIGRAM_INDEX > PART_LIB::GetTrigramIndex()
+{
+    std::vector<LIB_ALIAS*> aliases;
+    GetAliases( aliases );
+
+    // The plugin can reload the library from its file, which gives new aliases but
+    // leaves the modification hash unchanged
+    if( !m_trigramIndex || m_trigramIndexHash != m_mod_hash
+            || !m_trigramIndex->IsBuiltFrom( aliases ) )
+    {
+        m_trigramIndex = std::make_shared< const LIB_TRIGRAM_INDEX >( aliases );
+        m_trigramIndexHash = m_mod_hash;
+    }
+
+    return m_trigramIndex;
+}
+
+
 void PART_LIB::GetEntryTypePowerNames( wxArrayString& aNames )
 {
     std::vector<LIB_ALIAS*> aliases;
@@ -565,26 +587,13 @@ void PART_LIBS::LoadAllLibraries( PROJECT* aProject, bool aShowProgress )
 
     wxASSERT( !size() );    // expect to load into "this" empty container.
 
-    wxProgressDialog lib_dialog( _( "Loading Symbol Libraries" ),
-                                 wxEmptyString,
-                                 lib_names.GetCount(),
-                                 NULL,
-                                 wxPD_APP_MODAL );
-
-    if( aShowProgress )
-    {
-        lib_dialog.Show();
-    }
-
-    wxString progress_message;
+    // The file names are resolved first, the libraries are then loaded in parallel, and
+    // added to this container in the order of lib_names.
+    std::vector<wxString> filenames;
+    std::set<wxString>    names;
 
     for( unsigned i = 0; i < lib_names.GetCount();  ++i )
     {
-        if( aShowProgress )
-        {
-            lib_dialog.Update( i, _( "Loading " + lib_names[i] ) );
-        }
-
         // lib_names[] does not store the file extension. Set it.
         // Remember lib_names[i] can contain a '.' in name, so using a wxFileName
         // before adding the extension can create incorrect full filename
@@ -618,15 +627,54 @@ void PART_LIBS::LoadAllLibraries( PROJECT* aProject, bool aShowProgress )
             filename = fn.GetFullPath();
         }
 
-        try
+        // Don't load the same library twice, see AddLibrary().
+        if( names.insert( wxFileName( filename ).GetName() ).second )
+            filenames.push_back( filename );
+    }
+
+    wxProgressDialog lib_dialog( _( "Loading Symbol Libraries" ),
+                                 wxEmptyString,
+                                 std::max<int>( filenames.size(), 1 ),
+                                 NULL,
+                                 wxPD_APP_MODAL );
+
+    if( aShowProgress )
+    {
+        lib_dialog.Show();
+    }
+
+    std::vector<std::unique_ptr<PART_LIB>> libs( filenames.size() );
+
+    SYMBOL_LIBS_LOADER loader( filenames.size(), [&]( size_t aIndex )
         {
-            AddLibrary( filename );
+            libs[aIndex].reset( PART_LIB::LoadLibrary( filenames[aIndex] ) );
+        } );
+
+    SYMBOL_LIBS_LOADER::PROGRESS progress;
+
+    if( aShowProgress )
+    {
+        progress = [&]( size_t aDone )
+            {
+                lib_dialog.Update( aDone, wxString::Format( _( "Loaded %u of %u libraries" ),
+                                                            (unsigned) aDone,
+                                                            (unsigned) filenames.size() ) );
+            };
+    }
+
+    loader.Run( progress );
+
+    for( size_t i = 0; i < filenames.size(); ++i )
+    {
+        if( libs[i] )
+        {
+            push_back( libs[i].release() );
         }
-        catch( const IO_ERROR& ioe )
+        else
         {
             wxString msg;
             msg.Printf( _( "Part library '%s' failed to load. Error:\n %s" ),
-                        GetChars( filename ), GetChars( ioe.What() ) );
+                        GetChars( filenames[i] ), GetChars( loader.GetError( i ) ) );
 
             wxLogError( msg );
         }
@@ -39,8 +39,10 @@
 #include <project.h>
 
 #include <map>
+#include <memory>
 
 class LIB_ID;
+class LIB_TRIGRAM_INDEX;
 class LINE_READER;
 class OUTPUTFORMATTER;
 class SCH_LEGACY_PLUGIN;
@@ -334,6 +336,9 @@ class PART_LIB
     std::unique_ptr< SCH_PLUGIN > m_plugin;
     std::unique_ptr< PROPERTIES > m_properties;   ///< Library properties
 
+    std::shared_ptr< const LIB_TRIGRAM_INDEX > m_trigramIndex;
+    int             m_trigramIndexHash;   ///< m_mod_hash when m_trigramIndex was built
+
 public:
     PART_LIB( int aType, const wxString& aFileName,
               SCH_IO_MGR::SCH_FILE_T aPluginType = SCH_IO_MGR::SCH_LEGACY );
@@ -405,6 +410,13 @@ public:
      */
     void GetAliases( std::vector<LIB_ALIAS*>& aAliases );
 
+    /**
+     * Return the trigram index of the aliases of this library, used by the component
+     * chooser search.  The index is kept and only rebuilt when the library was modified
+     * or its aliases were reloaded since.
+     */
+    std::shared_ptr< const LIB_TRIGRAM_INDEX > GetTrigramIndex();
+
     /**
      * Load a string array with the names of  entries of type POWER in this library.
      *
@@ -34,6 +34,7 @@
 
 #include <sch_component.h>
 #include <class_netlist_object.h>
+#include <ki_mutex.h>
 
 #include <wx/regex.h>
 
@@ -45,13 +46,38 @@
  */
 static wxRegEx busLabelRe( wxT( "^([^[:space:]]+)(\\[[\\d]+\\.+[\\d]+\\])$" ), wxRE_ADVANCED );
 
+/// wxRegEx keeps the state of the last match: netlist items are built by several threads
+static MUTEX busLabelReLock;
 
-bool IsBusLabel( const wxString& aLabel )
+
+/**
+ * Function matchBusLabel
+ * tests if \a aLabel has a bus notation, and if so, splits it in its bus name and
+ * bus number parts, when \a aBusName and \a aBusNumber are not NULL.
+ */
+static bool matchBusLabel( const wxString& aLabel, wxString* aBusName, wxString* aBusNumber )
 {
     wxCHECK_MSG( busLabelRe.IsValid(), false,
                  wxT( "Invalid regular expression in IsBusLabel()." ) );
 
-    return busLabelRe.Matches( aLabel );
+    MUTLOCK locker( busLabelReLock );
+
+    if( !busLabelRe.Matches( aLabel ) )
+        return false;
+
+    if( aBusName )
+        *aBusName = busLabelRe.GetMatch( aLabel, 1 );
+
+    if( aBusNumber )
+        *aBusNumber = busLabelRe.GetMatch( aLabel, 2 );
+
+    return true;
+}
+
+
+bool IsBusLabel( const wxString& aLabel )
+{
+    return matchBusLabel( aLabel, NULL, NULL );
 }
 
 
@@ -241,7 +267,9 @@ bool NETLIST_OBJECT::IsLabelConnected( NETLIST_OBJECT* aNetItem )
 
 void NETLIST_OBJECT::ConvertBusToNetListItems( NETLIST_OBJECT_LIST& aNetListItems )
 {
-    wxCHECK_RET( IsBusLabel( m_Label ),
+    wxString busName, busNumber;
+
+    wxCHECK_RET( matchBusLabel( m_Label, &busName, &busNumber ),
                  wxT( "<" ) + m_Label + wxT( "> is not a valid bus label." ) );
 
     if( m_Type == NET_HIERLABEL )
@@ -256,12 +284,9 @@ void NETLIST_OBJECT::ConvertBusToNetListItems( NETLIST_OBJECT_LIST& aNetListItem
         wxCHECK_RET( false, wxT( "Net list object type is not valid." ) );
 
     unsigned i;
-    wxString tmp, busName, busNumber;
+    wxString tmp;
     long begin, end, member;
 
-    busName = busLabelRe.GetMatch( m_Label, 1 );
-    busNumber = busLabelRe.GetMatch( m_Label, 2 );
-
     /* Search for  '[' because a bus label is like "busname[nn..mm]" */
     i = busNumber.Find( '[' );
     i++;
@@ -36,8 +36,16 @@
 #include <lib_pin.h>      // LIB_PIN::PinStringNum( m_PinNum )
 #include <sch_item_struct.h>
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
 class NETLIST_OBJECT_LIST;
+class NETLIST_SHEET_CACHE;
 class SCH_COMPONENT;
+class SCH_SCREEN;
+class PART_LIBS;
 
 
 /* Type of Net objects (wires, labels, pins...) */
@@ -288,6 +296,46 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    /**
+     * Net codes merged while connecting items (union-find): each net code refers to
+     * the net code it was merged into, and the last one of the chain is the actual
+     * net code of the items.  Merging two nets does not have to visit their items,
+     * which keep their net code until BuildNetListInfo() resolves it.
+     */
+    std::vector<int> m_netCodeMerges;
+
+    /**
+     * Items of the sheet being connected, indexed by position, so connections do not
+     * have to be searched by comparing an item to all the items of the sheet.
+     */
+    struct SHEET_INDEX
+    {
+        /// Items by position, and by end point for wires and buses
+        std::unordered_map<uint64_t, NETLIST_OBJECTS> m_points;
+
+        /// Wires and buses: horizontal ones by Y, vertical ones by X, and the others
+        std::unordered_map<int, NETLIST_OBJECTS> m_horizontalSegments;
+        std::unordered_map<int, NETLIST_OBJECTS> m_verticalSegments;
+        NETLIST_OBJECTS m_otherSegments;
+    };
+
+    /**
+     * Connection state of the items of a sheet.  Sheets are connected in parallel, each
+     * one with its own net codes starting at 1, see connectSheetItems().
+     */
+    struct SHEET_CONNECTIONS
+    {
+        SHEET_INDEX      m_index;
+        std::vector<int> m_netCodeMerges;       // see NETLIST_OBJECT_LIST::m_netCodeMerges
+        std::vector<int> m_busNetCodeMerges;    // same, for bus net codes
+        int              m_lastNetCode;
+        int              m_lastBusNetCode;
+        bool             m_hasUnspecifiedItems;
+    };
+
+    /// Label type items, by label text
+    std::map<wxString, NETLIST_OBJECTS> m_labelIndex;
+
 public:
     /**
      * Constructor.
@@ -309,9 +357,11 @@ public:
      * Build the list of connected objects (pins, labels ...) and
      * all info to generate netlists or run ERC diags
      * @param aSheets = the flattened sheet list
+     * @param aCache = the items of the sheets of a previous call, to reuse the items of
+     *                 the sheets which were not modified since.  Can be NULL.
      * @return true if OK, false is not item found
      */
-    bool BuildNetListInfo( SCH_SHEET_LIST& aSheets );
+    bool BuildNetListInfo( SCH_SHEET_LIST& aSheets, NETLIST_SHEET_CACHE* aCache = NULL );
 
     /**
      * Acces to an item in list
@@ -372,7 +422,7 @@ public:
     void SortListbyNetcode();
 
     /*
-     * Sorts the list of connected items by sheet.
+     * Sorts the list of connected items by sheet.  Items of a same sheet keep their order.
      * This sorting is used when searching "physical" connection between items
      * because obviously only items inside the same sheet can be connected
      */
@@ -421,8 +471,49 @@ private:
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
      * when a new connection is found between aOldNetCode and aNewNetCode
+     * Items are not updated, see m_netCodeMerges.
+     */
+    void propagateNetCode( int aOldNetCode, int aNewNetCode );
+
+    /**
+     * Function mergeNetCodes
+     * records in \a aMerges that the items having \a aOldNetCode now have \a aNewNetCode.
+     */
+    static void mergeNetCodes( std::vector<int>& aMerges, int aOldNetCode, int aNewNetCode );
+
+    /**
+     * Function resolveNetCode
+     * @return the net code \a aNetCode was merged into, see m_netCodeMerges.
+     */
+    static int resolveNetCode( std::vector<int>& aMerges, int aNetCode );
+
+    /// @return the actual net code of \a aItem, during the connection of items.
+    int getNet( const NETLIST_OBJECT* aItem )
+    {
+        return resolveNetCode( m_netCodeMerges, aItem->GetNet() );
+    }
+
+    /**
+     * Function resolveNetCodes
+     * stores the actual net codes in the items, once the connections are done.
+     */
+    void resolveNetCodes();
+
+    /**
+     * Function buildSheetIndex
+     * fills \a aIndex with the items from index \a aIdxStart to \a aIdxEnd (excluded),
+     * which are the items of a sheet.
      */
-    void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
+    void buildSheetIndex( unsigned aIdxStart, unsigned aIdxEnd, SHEET_INDEX& aIndex );
+
+    /**
+     * Function connectSheetItems
+     * finds the physical connections between the items from index \a aIdxStart to
+     * \a aIdxEnd (excluded), which are the items of a sheet, and gives them net codes
+     * local to the sheet.  Only these items and \a aSheet are modified, so sheets can be
+     * connected by several threads.
+     */
+    void connectSheetItems( unsigned aIdxStart, unsigned aIdxEnd, SHEET_CONNECTIONS& aSheet );
 
     /*
      * This function merges the net codes of groups of objects already connected
@@ -451,16 +542,20 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search items having an end point in common with \a aRef, in the sheet
+     * \a aSheet, and propagate the net code of aRef to them.
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, SHEET_CONNECTIONS& aSheet );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * Search is done in the sheet \a aSheet
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus,
+                                SHEET_CONNECTIONS& aSheet );
 
 
     /**
@@ -495,6 +590,67 @@ private:
 };
 
 
+/**
+ * Class NETLIST_SHEET_CACHE
+ * keeps a copy of the items of each sheet, as read and once connected inside the sheet,
+ * so the next NETLIST_OBJECT_LIST::BuildNetListInfo() call only has to read the sheets
+ * modified since (see SCH_SCREEN::GetConnectivityStamp()).  The items of a sheet are
+ * connected in the order the sequential netlister sorted them in, which also depends on
+ * the item count of the other sheets: an unmodified sheet is connected again when this
+ * order changed.  The connections between sheets, by labels and sheet pins, are rebuilt
+ * for the whole hierarchy.
+ */
+class NETLIST_SHEET_CACHE
+{
+public:
+    NETLIST_SHEET_CACHE() :
+        m_libs( NULL ),
+        m_libsModifyHash( 0 )
+    {
+    }
+
+    /** Delete all the cached items */
+    void Clear()
+    {
+        m_sheets.clear();
+    }
+
+    /**
+     * Function SetLibraries
+     * sets the libraries the items are built from.  The items refer to library pins, so
+     * all the sheets are discarded if the libraries were changed or reloaded.
+     */
+    void SetLibraries( PART_LIBS* aLibs );
+
+private:
+    friend class NETLIST_OBJECT_LIST;
+
+    struct SHEET
+    {
+        SCH_SHEET_PATH  m_sheetPath;
+        SCH_SCREEN*     m_screen;
+        unsigned        m_connectivityStamp;
+        std::unique_ptr<NETLIST_OBJECT_LIST> m_readItems;   ///< unconnected, as read
+        std::vector<unsigned> m_order;      ///< the order of m_readItems in m_items
+        std::unique_ptr<NETLIST_OBJECT_LIST> m_items;   ///< with net codes local to the sheet
+        int             m_lastNetCode;
+        int             m_lastBusNetCode;
+        bool            m_hasUnspecifiedItems;
+    };
+
+    /**
+     * Function find
+     * @return the cached items of \a aSheetPath, or NULL if its screen was modified or it is
+     * not in the cache.
+     */
+    SHEET* find( const SCH_SHEET_PATH& aSheetPath );
+
+    std::map<wxString, SHEET> m_sheets;     ///< by SCH_SHEET_PATH::Path()
+    PART_LIBS*                m_libs;
+    int                       m_libsModifyHash;
+};
+
+
 /**
  * Function IsBusLabel
  * test if \a aLabel has a bus notation.
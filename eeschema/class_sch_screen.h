@@ -85,6 +85,8 @@ private:
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
+    unsigned m_connectivityStamp;       ///< see GetConnectivityStamp()
+
     /**
      * Function addConnectedItemsToBlock
      * add items connected at \a aPosition to the block pick list.
@@ -141,6 +143,7 @@ public:
     {
         m_drawList.Append( aItem );
         --m_modification_sync;
+        ConnectivityChanged();
     }
 
     /**
@@ -153,8 +156,24 @@ public:
     {
         m_drawList.Append( aList );
         --m_modification_sync;
+        ConnectivityChanged();
     }
 
+    /**
+     * Function GetConnectivityStamp
+     * @return a number which changes each time the items of the screen may have been
+     * connected differently, and which is never given to another screen.  The netlist
+     * items of a sheet are reused as long as the stamp of its screen does not change.
+     */
+    unsigned GetConnectivityStamp() const                   { return m_connectivityStamp; }
+
+    /**
+     * Function ConnectivityChanged
+     * gives a new connectivity stamp to the screen.  It must be called when items
+     * are added, removed or modified.
+     */
+    void ConnectivityChanged();
+
     /**
      * Function GetCurItem
      * returns the currently selected SCH_ITEM, overriding BASE_SCREEN::GetCurItem().
@@ -551,6 +570,13 @@ public:
      */
     void ClearAnnotation();
 
+    /**
+     * Function ConnectivityChanged
+     * gives a new connectivity stamp to all the screens, after a change which is not
+     * limited to the current screen, like the annotation of the hierarchy.
+     */
+    void ConnectivityChanged();
+
     /**
      * Function SchematicCleanUp
      * merges and breaks wire segments in the entire schematic hierarchy.
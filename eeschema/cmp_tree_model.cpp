@@ -22,8 +22,11 @@
 #include <cmp_tree_model.h>
 
 #include <class_library.h>
+#include <lib_trigram_index.h>
 #include <eda_pattern_match.h>
 #include <make_unique.h>
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 
@@ -49,6 +52,23 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
+// Returns true if the search term can only be found as a substring: it has none of
+// the special characters of the regex, wildcard and relational matchers.  Only such
+// terms can use the trigram index.
+static bool isPlainTerm( wxString const& aTerm )
+{
+    static const wxString special = wxT( ".*+?^${}()|[]\\<=>" );
+
+    for( wxUniChar c: aTerm )
+    {
+        if( special.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
 void CMP_TREE_NODE::ResetScore()
 {
     for( auto& child: Children )
@@ -208,7 +228,9 @@ void CMP_TREE_NODE_ALIAS::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 }
 
 
-CMP_TREE_NODE_LIB::CMP_TREE_NODE_LIB( CMP_TREE_NODE* aParent, wxString const& aName )
+CMP_TREE_NODE_LIB::CMP_TREE_NODE_LIB( CMP_TREE_NODE* aParent, wxString const& aName,
+                                      PART_LIB* aLib ) :
+    m_lib( aLib )
 {
     Type = LIB;
     Name = aName;
@@ -229,6 +251,32 @@ void CMP_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 {
     Score = 0;
 
+    std::vector<int> candidates;
+
+    // A library name match is a match for all the aliases of the library
+    if( MatchName.Find( aMatcher.GetPattern() ) == wxNOT_FOUND
+            && FindCandidates( aMatcher.GetPattern(), candidates ) )
+    {
+        for( auto& child: Children )
+        {
+            int index = m_index->FindAlias( child->Alias );
+
+            if( index < 0 || std::binary_search( candidates.begin(), candidates.end(), index ) )
+            {
+                child->UpdateScore( aMatcher );
+            }
+            else
+            {
+                // Cannot contain the term: no match, as the search would have found
+                child->Score = 0;
+            }
+
+            Score = std::max( Score, child->Score );
+        }
+
+        return;
+    }
+
     for( auto& child: Children )
     {
         child->UpdateScore( aMatcher );
@@ -237,15 +285,28 @@ void CMP_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 }
 
 
+bool CMP_TREE_NODE_LIB::FindCandidates( wxString const& aTerm, std::vector<int>& aCandidates )
+{
+    if( !m_lib || !isPlainTerm( aTerm ) )
+        return false;
+
+    // The index is kept by the library, and only rebuilt when the library changes
+    if( !m_index )
+        m_index = m_lib->GetTrigramIndex();
+
+    return m_index->FindCandidates( aTerm, aCandidates );
+}
+
+
 CMP_TREE_NODE_ROOT::CMP_TREE_NODE_ROOT()
 {
     Type = ROOT;
 }
 
 
-CMP_TREE_NODE_LIB& CMP_TREE_NODE_ROOT::AddLib( wxString const& aName )
+CMP_TREE_NODE_LIB& CMP_TREE_NODE_ROOT::AddLib( wxString const& aName, PART_LIB* aLib )
 {
-    CMP_TREE_NODE_LIB* lib = new CMP_TREE_NODE_LIB( this, aName );
+    CMP_TREE_NODE_LIB* lib = new CMP_TREE_NODE_LIB( this, aName, aLib );
     Children.push_back( std::unique_ptr<CMP_TREE_NODE>( lib ) );
     return *lib;
 }
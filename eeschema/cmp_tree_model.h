@@ -30,6 +30,8 @@
 class EDA_COMBINED_MATCHER;
 class TREE_NODE;
 class LIB_ALIAS;
+class LIB_TRIGRAM_INDEX;
+class PART_LIB;
 
 
 /**
@@ -232,8 +234,11 @@ public:
      *
      * @param aParent   parent node, should be a CMP_TREE_NODE_ROOT
      * @param aName     display name of the library
+     * @param aLib      library of the aliases, which provides the trigram index, or
+     *                  nullptr if the aliases are not from a single library
      */
-    CMP_TREE_NODE_LIB( CMP_TREE_NODE* aParent, wxString const& aName );
+    CMP_TREE_NODE_LIB( CMP_TREE_NODE* aParent, wxString const& aName,
+                       PART_LIB* aLib = nullptr );
 
     /**
      * Construct a new alias node, add it to this library, and return it.
@@ -242,7 +247,28 @@ public:
      */
     CMP_TREE_NODE_ALIAS& AddAlias( LIB_ALIAS* aAlias );
 
+    /**
+     * Update the score of the aliases. When the search term is a plain string,
+     * only the aliases found in the trigram index are actually searched.
+     */
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+private:
+    /**
+     * Find the aliases which can contain a search term, using the trigram index of
+     * the library.
+     *
+     * @param aTerm         lower case search term
+     * @param aCandidates   receives the indices in the library index of the aliases
+     *                      containing all the trigrams of aTerm, in increasing order
+     * @return false if the index cannot be used for this term, because there is no
+     *         library, or the term is too short or uses a regex, wildcard or
+     *         relational syntax
+     */
+    bool FindCandidates( wxString const& aTerm, std::vector<int>& aCandidates );
+
+    PART_LIB*                                   m_lib;
+    std::shared_ptr<const LIB_TRIGRAM_INDEX>    m_index;
 };
 
 
@@ -267,7 +293,7 @@ public:
     /**
      * Construct an empty library node, add it to the root, and return it.
      */
-    CMP_TREE_NODE_LIB& AddLib( wxString const& aName );
+    CMP_TREE_NODE_LIB& AddLib( wxString const& aName, PART_LIB* aLib = nullptr );
 
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
 };
@@ -160,7 +160,7 @@ void CMP_TREE_MODEL_ADAPTER::AddAliasList(
             std::vector<LIB_ALIAS*> const&  aAliasList,
             PART_LIB*               aOptionalLib )
 {
-    auto& lib_node = m_tree.AddLib( aNodeName );
+    auto& lib_node = m_tree.AddLib( aNodeName, aOptionalLib );
 
     for( auto a: aAliasList )
     {
@@ -43,6 +43,8 @@
 
 #include <wx/ffile.h>
 
+#include <algorithm>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -620,38 +622,27 @@ void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned
 // when they are compared using case insensitive coparisons.
 
 
-// A helper struct to compare NETLIST_OBJECT items by sheetpath and label texts
-// for a std::set<NETLIST_OBJECT*> container
-// the full text is "sheetpath+label" for local labels and "label" for global labels
-struct compare_labels
+// A label tested by TestforSimilarLabels(), with its sheet path built only once
+struct LABEL_CANDIDATE
 {
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        wxString str1 = lab1->m_SheetPath.Path() + lab1->m_Label;
-        wxString str2 = lab2->m_SheetPath.Path() + lab2->m_Label;
+    NETLIST_OBJECT* m_item;
+    wxString        m_path;
 
-        return str1.Cmp( str2 ) < 0;
-    }
+    wxString FullText() const { return m_path + m_item->m_Label; }
 };
 
-struct compare_label_names
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        return lab1->m_Label.Cmp( lab2->m_Label ) < 0;
-    }
-};
+// Hash maps used to find similar and identical labels without comparing all the labels
+WX_DECLARE_STRING_HASH_MAP( int, LABEL_INDEX );
+WX_DECLARE_STRING_HASH_MAP( LABEL_INDEX, LABEL_INDEX_BY_PATH );
+WX_DECLARE_STRING_HASH_MAP( std::vector<int>, LABEL_GROUPS );
+WX_DECLARE_STRING_HASH_MAP( LABEL_GROUPS, LABEL_GROUPS_BY_PATH );
 
-struct compare_paths
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
-    }
-};
+typedef std::vector< std::pair<int, int> > LABEL_PAIRS;
 
 // Helper functions to build the warning messages about Similar Labels:
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel );
+static void addSimilarLabelPairs( const std::vector<LABEL_CANDIDATE>& aLabels,
+                                  std::vector<int>& aGroup, bool aSkipGlobalPairs,
+                                  LABEL_PAIRS& aPairs );
 static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
 
 
@@ -661,10 +652,7 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     // but are equal when using case insensitive comparisons
 
     // list of all labels (used the better item to build diag messages)
-    std::vector<NETLIST_OBJECT*> fullLabelList;
-    // list of all labels , each label appears only once (used to to detect similar labels)
-    std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
-    wxString msg;
+    std::vector<LABEL_CANDIDATE> fullLabelList;
 
     // Build a list of differents labels. If inside a given sheet there are
     // more than one given label, only one label is stored.
@@ -684,8 +672,8 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBLABEL:
             // add this label in lists
-            uniqueLabelList.insert( GetItem( netItem ) );
-            fullLabelList.push_back( GetItem( netItem ) );
+            fullLabelList.push_back( { GetItem( netItem ),
+                                       GetItem( netItem )->m_SheetPath.Path() } );
             break;
 
         case NET_SHEETLABEL:
@@ -695,118 +683,172 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         }
     }
 
-    // build global labels and compare
-    std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
-    std::set<NETLIST_OBJECT*>::const_iterator it;
+    // Count the identical labels, which are used to choose the label reported first:
+    //  for global label: global labels in the full project
+    //  for local label: all labels in the current sheet
+    LABEL_INDEX         globalCounts;
+    LABEL_INDEX_BY_PATH localCounts;
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
+    // list of all labels, each label appears only once (the first one found in a sheet
+    // path), indexed by sheet path + label text
+    LABEL_INDEX         uniqueLabelList;
+    std::vector<int>    uniqueLabels;
+
+    for( unsigned ii = 0; ii < fullLabelList.size(); ++ii )
     {
-        if( (*it)->IsLabelGlobal() )
-            loc_labelList.insert( *it );
+        const LABEL_CANDIDATE& label = fullLabelList[ii];
+
+        if( label.m_item->IsLabelGlobal() )
+            globalCounts[label.m_item->m_Label]++;
+
+        localCounts[label.m_path][label.m_item->m_Label]++;
+
+        if( uniqueLabelList.insert( LABEL_INDEX::value_type( label.FullText(), ii ) ).second )
+            uniqueLabels.push_back( ii );
     }
 
-    // compare global labels (same label names appears only once in list)
-    for( it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
+    auto countIdenticalLabels = [&]( const LABEL_CANDIDATE& aLabel )
     {
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = it;
+        if( aLabel.m_item->IsLabelGlobal() )
+            return globalCounts[aLabel.m_item->m_Label];
+
+        return localCounts[aLabel.m_path][aLabel.m_item->m_Label];
+    };
 
-        for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
+    auto diagnose = [&]( const LABEL_PAIRS& aPairs )
+    {
+        for( const auto& pair : aPairs )
         {
-            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-            {
-                // Create new marker for ERC.
-                int cntA = countIndenticalLabels( fullLabelList, *it );
-                int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                if( cntA <= cntB )
-                    SimilarLabelsDiagnose( (*it), (*it_aux) );
-                else
-                    SimilarLabelsDiagnose( (*it_aux), (*it) );
-            }
+            // Create new marker for ERC.
+            const LABEL_CANDIDATE& labelA = fullLabelList[pair.first];
+            const LABEL_CANDIDATE& labelB = fullLabelList[pair.second];
+
+            if( countIdenticalLabels( labelA ) <= countIdenticalLabels( labelB ) )
+                SimilarLabelsDiagnose( labelA.m_item, labelB.m_item );
+            else
+                SimilarLabelsDiagnose( labelB.m_item, labelA.m_item );
         }
+    };
+
+    // build global labels: a label name appears only once, from the first sheet path
+    LABEL_INDEX globalLabels;
+
+    for( int ii : uniqueLabels )
+    {
+        const LABEL_CANDIDATE& label = fullLabelList[ii];
+
+        if( !label.m_item->IsLabelGlobal() )
+            continue;
+
+        auto it = globalLabels.find( label.m_item->m_Label );
+
+        if( it == globalLabels.end() )
+            globalLabels[label.m_item->m_Label] = ii;
+        else if( label.FullText().Cmp( fullLabelList[it->second].FullText() ) < 0 )
+            it->second = ii;
     }
 
-    // Build paths list
-    std::set<NETLIST_OBJECT*, compare_paths> pathsList;
+    // compare global labels: only labels having the same lower case text can be similar
+    LABEL_GROUPS globalGroups;
+    LABEL_PAIRS  pairs;
+
+    for( const auto& entry : globalLabels )
+        globalGroups[entry.first.Lower()].push_back( entry.second );
+
+    for( auto& group : globalGroups )
+        addSimilarLabelPairs( fullLabelList, group.second, false, pairs );
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-        pathsList.insert( *it );
+    // Report them by order of label text
+    std::sort( pairs.begin(), pairs.end(),
+               [&]( const std::pair<int, int>& a, const std::pair<int, int>& b )
+               {
+                   const wxString& textA = fullLabelList[a.first].m_item->m_Label;
+                   const wxString& textB = fullLabelList[b.first].m_item->m_Label;
+
+                   if( textA != textB )
+                       return textA.Cmp( textB ) < 0;
+
+                   return fullLabelList[a.second].m_item->m_Label.Cmp(
+                                fullLabelList[b.second].m_item->m_Label ) < 0;
+               } );
+
+    diagnose( pairs );
 
     // Examine each label inside a sheet path:
-    for( it = pathsList.begin(); it != pathsList.end(); ++it )
+    LABEL_GROUPS_BY_PATH localGroups;
+
+    for( int ii : uniqueLabels )
     {
-        loc_labelList.clear();
+        const LABEL_CANDIDATE& label = fullLabelList[ii];
 
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = uniqueLabelList.begin();
+        localGroups[label.m_path][label.m_item->m_Label.Lower()].push_back( ii );
+    }
+
+    pairs.clear();
 
-        for( ; it_aux != uniqueLabelList.end(); ++it_aux )
+    for( auto& path : localGroups )
+    {
+        for( auto& group : path.second )
         {
-            if( (*it)->m_SheetPath.Path() == (*it_aux)->m_SheetPath.Path() )
-                loc_labelList.insert( *it_aux );
+            // global label versus global label was already examined.
+            // here, at least one label must be local
+            addSimilarLabelPairs( fullLabelList, group.second, true, pairs );
         }
+    }
 
-        // at this point, loc_labelList contains labels of the current sheet path.
-        // Detect similar labels (same label names appears only once in list)
-        std::set<NETLIST_OBJECT*>::const_iterator ref_it;
+    // Report them by order of sheet path, then label text
+    std::sort( pairs.begin(), pairs.end(),
+               [&]( const std::pair<int, int>& a, const std::pair<int, int>& b )
+               {
+                   const wxString& pathA = fullLabelList[a.first].m_path;
+                   const wxString& pathB = fullLabelList[b.first].m_path;
 
-        for( ref_it = loc_labelList.begin(); ref_it != loc_labelList.end(); ++ref_it )
-        {
-            NETLIST_OBJECT* ref_item = *ref_it;
-            it_aux = ref_it;
+                   if( pathA != pathB )
+                       return pathA.Cmp( pathB ) < 0;
 
-            for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-            {
-                // global label versus global label was already examined.
-                // here, at least one label must be local
-                if( ref_item->IsLabelGlobal() && (*it_aux)->IsLabelGlobal() )
-                    continue;
+                   const wxString& textA = fullLabelList[a.first].m_item->m_Label;
+                   const wxString& textB = fullLabelList[b.first].m_item->m_Label;
 
-                if( ref_item->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-                {
-                    // Create new marker for ERC.
-                    int cntA = countIndenticalLabels( fullLabelList, ref_item );
-                    int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                    if( cntA <= cntB )
-                        SimilarLabelsDiagnose( ref_item, (*it_aux) );
-                    else
-                        SimilarLabelsDiagnose( (*it_aux), ref_item );
-                }
-            }
-        }
-    }
+                   if( textA != textB )
+                       return textA.Cmp( textB ) < 0;
+
+                   return fullLabelList[a.second].m_item->m_Label.Cmp(
+                                fullLabelList[b.second].m_item->m_Label ) < 0;
+               } );
+
+    diagnose( pairs );
 }
 
-// Helper function: count the number of labels identical to aLabel
-//  for global label: global labels in the full project
-//  for local label: all labels in the current sheet
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel )
+
+// Helper function: appends to aPairs the pairs of labels of aGroup, which all have the
+// same text when compared case insensitively, and different texts otherwise.
+// In each pair, the first label has the lowest text.
+static void addSimilarLabelPairs( const std::vector<LABEL_CANDIDATE>& aLabels,
+                                  std::vector<int>& aGroup, bool aSkipGlobalPairs,
+                                  LABEL_PAIRS& aPairs )
 {
-    int count = 0;
+    if( aGroup.size() < 2 )
+        return;
 
-    if( aLabel->IsLabelGlobal() )
-    {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
+    std::sort( aGroup.begin(), aGroup.end(),
+               [&]( int a, int b )
+               {
+                   return aLabels[a].m_item->m_Label.Cmp( aLabels[b].m_item->m_Label ) < 0;
+               } );
 
-            if( item->IsLabelGlobal() && item->m_Label == aLabel->m_Label )
-                count++;
-        }
-    }
-    else
+    for( unsigned ii = 0; ii < aGroup.size(); ++ii )
     {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
+        NETLIST_OBJECT* ref_item = aLabels[aGroup[ii]].m_item;
+
+        for( unsigned jj = ii + 1; jj < aGroup.size(); ++jj )
         {
-            NETLIST_OBJECT* item = aList[netItem];
+            if( aSkipGlobalPairs && ref_item->IsLabelGlobal()
+                && aLabels[aGroup[jj]].m_item->IsLabelGlobal() )
+                continue;
 
-            if( item->m_Label == aLabel->m_Label &&
-                item->m_SheetPath.Path() == aLabel->m_SheetPath.Path() )
-                count++;
+            aPairs.push_back( std::make_pair( aGroup[ii], aGroup[jj] ) );
         }
     }
-
-    return count;
 }
 
 // Helper function: creates a marker for similar labels ERC warning
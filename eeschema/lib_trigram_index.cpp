@@ -0,0 +1,125 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <lib_trigram_index.h>
+#include <class_libentry.h>
+
+#include <algorithm>
+#include <iterator>
+
+
+// Appends the trigrams of aText to aTrigrams, each one packed in an integer.
+static void addTrigrams( const wxString& aText, std::vector<uint64_t>& aTrigrams )
+{
+    uint64_t trigram = 0;
+    int      count = 0;
+
+    for( wxUniChar c: aText )
+    {
+        // Code points fit in 21 bits
+        trigram = ( ( trigram << 21 ) | c.GetValue() ) & ( ( uint64_t( 1 ) << 63 ) - 1 );
+
+        if( ++count >= 3 )
+            aTrigrams.push_back( trigram );
+    }
+}
+
+
+LIB_TRIGRAM_INDEX::LIB_TRIGRAM_INDEX( const std::vector<LIB_ALIAS*>& aAliases ) :
+    m_aliases( aAliases )
+{
+    std::vector<uint64_t> trigrams;
+
+    for( int index = 0; index < (int) m_aliases.size(); ++index )
+    {
+        LIB_ALIAS* alias = m_aliases[index];
+
+        m_aliasIndices[alias] = index;
+
+        // The strings searched by CMP_TREE_NODE_ALIAS
+        trigrams.clear();
+        addTrigrams( alias->GetName().Lower(), trigrams );
+        addTrigrams( ( alias->GetKeyWords() + "        " + alias->GetDescription() ).Lower(),
+                     trigrams );
+
+        std::sort( trigrams.begin(), trigrams.end() );
+        trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+        for( uint64_t trigram: trigrams )
+            m_trigrams[trigram].push_back( index );
+    }
+}
+
+
+int LIB_TRIGRAM_INDEX::FindAlias( LIB_ALIAS* aAlias ) const
+{
+    auto it = m_aliasIndices.find( aAlias );
+
+    return it == m_aliasIndices.end() ? -1 : it->second;
+}
+
+
+bool LIB_TRIGRAM_INDEX::FindCandidates( const wxString& aTerm,
+                                        std::vector<int>& aCandidates ) const
+{
+    std::vector<uint64_t> trigrams;
+
+    addTrigrams( aTerm, trigrams );
+
+    if( trigrams.empty() )
+        return false;
+
+    // Intersect the alias lists of the trigrams, shortest first
+    std::vector<std::vector<int> const*> lists;
+
+    for( uint64_t trigram: trigrams )
+    {
+        auto it = m_trigrams.find( trigram );
+
+        if( it == m_trigrams.end() )
+        {
+            aCandidates.clear();
+            return true;
+        }
+
+        lists.push_back( &it->second );
+    }
+
+    std::sort( lists.begin(), lists.end(),
+            []( std::vector<int> const* a, std::vector<int> const* b )
+                { return a->size() < b->size(); } );
+
+    aCandidates = *lists[0];
+
+    std::vector<int> intersection;
+
+    for( size_t i = 1; i < lists.size() && !aCandidates.empty(); ++i )
+    {
+        intersection.clear();
+        std::set_intersection( aCandidates.begin(), aCandidates.end(),
+                lists[i]->begin(), lists[i]->end(), std::back_inserter( intersection ) );
+        aCandidates.swap( intersection );
+    }
+
+    return true;
+}
@@ -0,0 +1,79 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_TRIGRAM_INDEX_H
+#define LIB_TRIGRAM_INDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+class LIB_ALIAS;
+
+
+/**
+ * Class LIB_TRIGRAM_INDEX
+ * indexes the trigrams of the lower case name, keywords and description of the aliases
+ * of a library, the strings searched by the component chooser.  It is owned by the
+ * library (see PART_LIB::GetTrigramIndex()), so it is built once per library load or
+ * modification rather than each time the chooser opens.
+ */
+class LIB_TRIGRAM_INDEX
+{
+public:
+    /**
+     * Index \a aAliases, which must stay valid as long as the index is used.
+     */
+    LIB_TRIGRAM_INDEX( const std::vector<LIB_ALIAS*>& aAliases );
+
+    /**
+     * @return true if the index was built from \a aAliases.
+     */
+    bool IsBuiltFrom( const std::vector<LIB_ALIAS*>& aAliases ) const
+    {
+        return aAliases == m_aliases;
+    }
+
+    /**
+     * @return the index of \a aAlias in the indexed aliases, or -1 if it is not indexed.
+     */
+    int FindAlias( LIB_ALIAS* aAlias ) const;
+
+    /**
+     * Find the aliases which can contain a search term.
+     *
+     * @param aTerm         lower case search term
+     * @param aCandidates   receives the indices of the aliases containing all the trigrams
+     *                      of aTerm, in increasing order
+     * @return false if the term is too short to be searched in the index
+     */
+    bool FindCandidates( const wxString& aTerm, std::vector<int>& aCandidates ) const;
+
+private:
+    std::vector<LIB_ALIAS*>                         m_aliases;
+    std::unordered_map<LIB_ALIAS*, int>             m_aliasIndices;
+    std::unordered_map<uint64_t, std::vector<int>>  m_trigrams;
+};
+
+#endif  // LIB_TRIGRAM_INDEX_H
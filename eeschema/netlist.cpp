@@ -44,11 +44,20 @@
 #include <sch_text.h>
 #include <sch_sheet.h>
 #include <algorithm>
+#include <memory>
+#include <numeric>
 #include <invoke_sch_dialog.h>
+#include <profile.h>
 
 #define IS_WIRE false
 #define IS_BUS true
 
+/**
+ * Definition for enabling and disabling netlist trace output.  See the
+ * wxWidgets documentation on using the WXTRACE environment variable.
+ */
+static const wxChar traceNetlist[] = wxT( "KicadNetlist" );
+
 //Imported function:
 int TestDuplicateSheetNames( bool aCreateMarker );
 
@@ -166,8 +175,13 @@ NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::BuildNetListBase( bool updateStatusText )
     // Creates the flattened sheet list:
     SCH_SHEET_LIST aSheets( g_RootSheet );
 
+    if( !m_netlistCache )
+        m_netlistCache = new NETLIST_SHEET_CACHE();
+
+    m_netlistCache->SetLibraries( Prj().SchLibs() );
+
     // Build netlist info
-    bool success = ret->BuildNetListInfo( aSheets );
+    bool success = ret->BuildNetListInfo( aSheets, m_netlistCache );
 
     if( !success )
     {
@@ -185,132 +199,273 @@ NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::BuildNetListBase( bool updateStatusText )
 }
 
 
-bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+void NETLIST_SHEET_CACHE::SetLibraries( PART_LIBS* aLibs )
 {
-    SCH_SHEET_PATH* sheet;
+    int modifyHash = aLibs ? aLibs->GetModifyHash() : 0;
 
-    // Fill list with connected items from the flattened sheet list
-    for( unsigned i = 0; i < aSheets.size();  i++ )
+    if( aLibs != m_libs || modifyHash != m_libsModifyHash )
     {
-        sheet = &aSheets[i];
+        Clear();
+        m_libs = aLibs;
+        m_libsModifyHash = modifyHash;
+    }
+}
+
+
+NETLIST_SHEET_CACHE::SHEET* NETLIST_SHEET_CACHE::find( const SCH_SHEET_PATH& aSheetPath )
+{
+    auto it = m_sheets.find( aSheetPath.Path() );
+
+    if( it == m_sheets.end() )
+        return NULL;
+
+    SHEET&      sheet = it->second;
+    SCH_SCREEN* screen = aSheetPath.LastScreen();
+
+    if( !( sheet.m_sheetPath == aSheetPath ) || sheet.m_screen != screen
+        || sheet.m_connectivityStamp != screen->GetConnectivityStamp() )
+        return NULL;
+
+    return &sheet;
+}
+
+
+/**
+ * Computes the order the sequential netlister gave to the items of the sheets: they were
+ * appended in the order of \a aSheets and sorted by sheet path with std::sort().  This
+ * sort is not stable, but its result only depends on the sheet of each item, so it is
+ * computed on the sheet ranks alone, without the items.
+ * @param aItemCounts is the number of items of each sheet of \a aSheets
+ * @param aSheetOrder receives the indices of the sheets, by order of sheet path
+ * @param aItemOrders receives, for each sheet, the indices of its items (in the order they
+ *                    are read) in sorted order
+ */
+static void sortSheetItems( SCH_SHEET_LIST& aSheets, const std::vector<unsigned>& aItemCounts,
+                            std::vector<int>& aSheetOrder,
+                            std::vector<std::vector<unsigned>>& aItemOrders )
+{
+    int sheetCount = (int) aSheets.size();
+
+    aSheetOrder.resize( sheetCount );
+    std::iota( aSheetOrder.begin(), aSheetOrder.end(), 0 );
+    std::stable_sort( aSheetOrder.begin(), aSheetOrder.end(),
+                      [&aSheets]( int a, int b )
+                      {
+                          return aSheets[a].Cmp( aSheets[b] ) < 0;
+                      } );
+
+    std::vector<int> sheetRanks( sheetCount );
+
+    for( int ii = 0; ii < sheetCount; ii++ )
+        sheetRanks[ aSheetOrder[ii] ] = ii;
+
+    struct SORT_KEY
+    {
+        int      m_rank;
+        int      m_sheet;
+        unsigned m_item;
+    };
+
+    std::vector<SORT_KEY> keys;
+
+    for( int ii = 0; ii < sheetCount; ii++ )
+    {
+        for( unsigned jj = 0; jj < aItemCounts[ii]; jj++ )
+            keys.push_back( { sheetRanks[ii], ii, jj } );
+    }
+
+    // The comparisons of NETLIST_OBJECT_LIST::sortItemsBySheet(), so the same permutation
+    std::sort( keys.begin(), keys.end(),
+               []( const SORT_KEY& a, const SORT_KEY& b )
+               {
+                   return a.m_rank < b.m_rank;
+               } );
+
+    aItemOrders.assign( sheetCount, std::vector<unsigned>() );
+
+    for( const SORT_KEY& key : keys )
+        aItemOrders[key.m_sheet].push_back( key.m_item );
+}
+
+
+bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets, NETLIST_SHEET_CACHE* aCache )
+{
+    PROF_COUNTER    timer;
+    int             sheetCount = (int) aSheets.size();
+
+    // Items of different sheets cannot be physically connected: sheets are read and
+    // connected in parallel, each one in its own list and with its own net codes.  The
+    // sheets not modified since the last call are not read again, and their connected
+    // items are copied from the cache when they keep the same order.
+    std::vector<std::unique_ptr<NETLIST_OBJECT_LIST>> readItems( sheetCount );
+    std::vector<std::unique_ptr<NETLIST_OBJECT_LIST>> sheetItems( sheetCount );
+    std::vector<SHEET_CONNECTIONS> sheetConnections( sheetCount );
+    std::vector<NETLIST_SHEET_CACHE::SHEET*> cachedSheets( sheetCount, nullptr );
+    std::vector<char> reusedSheets( sheetCount, false );
+    int cachedSheetCount = 0;
+
+    for( int i = 0; i < sheetCount; i++ )
+    {
+        readItems[i].reset( new NETLIST_OBJECT_LIST() );
+        sheetItems[i].reset( new NETLIST_OBJECT_LIST() );
+
+        if( aCache && ( cachedSheets[i] = aCache->find( aSheets[i] ) ) != NULL )
+            cachedSheetCount++;
+    }
+
+    #ifdef USE_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1)
+    #endif /* USE_OPENMP */
+    for( int i = 0; i < sheetCount; i++ )
+    {
+        if( cachedSheets[i] )
+            continue;
+
+        SCH_SHEET_PATH* sheet = &aSheets[i];
 
         for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
         {
-            item->GetNetListItem( *this, sheet );
+            item->GetNetListItem( *readItems[i], sheet );
         }
     }
 
-    if( size() == 0 )
-        return false;
+    double readTime = timer.msecs();
 
-    // Sort objects by Sheet
-    SortListbySheet();
+    // Connect the items of each sheet in the order the sequential netlister had them,
+    // so the item order and the net codes are the same.
+    std::vector<unsigned> itemCounts( sheetCount );
+    std::vector<int> sheetOrder;
+    std::vector<std::vector<unsigned>> itemOrders;
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
-    m_lastNetCode = m_lastBusNetCode = 1;
+    for( int i = 0; i < sheetCount; i++ )
+    {
+        itemCounts[i] = cachedSheets[i] ? cachedSheets[i]->m_readItems->size()
+                                        : readItems[i]->size();
+    }
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    sortSheetItems( aSheets, itemCounts, sheetOrder, itemOrders );
+
+    #ifdef USE_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1)
+    #endif /* USE_OPENMP */
+    for( int i = 0; i < sheetCount; i++ )
     {
-        NETLIST_OBJECT* net_item = GetItem( ii );
+        NETLIST_OBJECT_LIST& items = *sheetItems[i];
+        SHEET_CONNECTIONS& connections = sheetConnections[i];
+        NETLIST_SHEET_CACHE::SHEET* cached = cachedSheets[i];
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
+        if( cached && cached->m_order == itemOrders[i] )
         {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            for( NETLIST_OBJECT* item : *cached->m_items )
+                items.push_back( new NETLIST_OBJECT( *item ) );
+
+            connections.m_lastNetCode = cached->m_lastNetCode;
+            connections.m_lastBusNetCode = cached->m_lastBusNetCode;
+            connections.m_hasUnspecifiedItems = cached->m_hasUnspecifiedItems;
+            reusedSheets[i] = true;
+            continue;
         }
 
-        switch( net_item->m_Type )
-        {
-        case NET_ITEM_UNSPECIFIED:
-            wxMessageBox( wxT( "BuildNetListInfo() error" ) );
-            break;
+        // The read items are kept unconnected for the cache
+        const NETLIST_OBJECT_LIST& source = cached ? *cached->m_readItems : *readItems[i];
 
-        case NET_PIN:
-        case NET_PINLABEL:
-        case NET_SHEETLABEL:
-        case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
-                break;
+        for( unsigned idx : itemOrders[i] )
+            items.push_back( new NETLIST_OBJECT( *source[idx] ) );
 
-        case NET_SEGMENT:
-            // Test connections point to point type without bus.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+        items.connectSheetItems( 0, items.size(), connections );
+    }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
-            break;
+    std::map<wxString, NETLIST_SHEET_CACHE::SHEET> cache;
 
-        case NET_JUNCTION:
-            // Control of the junction outside BUS.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+    // Number the nets of each sheet after the nets of the previous sheets, which gives
+    // the net codes the sheets would have had if they were connected one after the other.
+    m_lastNetCode = m_lastBusNetCode = 1;
+    m_netCodeMerges.clear();
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+    for( int i : sheetOrder )
+    {
+        NETLIST_OBJECT_LIST& items = *sheetItems[i];
+        SHEET_CONNECTIONS& sheet = sheetConnections[i];
+        int netOffset = m_lastNetCode - 1;
+        int busNetOffset = m_lastBusNetCode - 1;
 
-            // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
+        if( sheet.m_hasUnspecifiedItems )
+            wxMessageBox( wxT( "BuildNetListInfo() error" ) );
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
-            break;
+        for( NETLIST_OBJECT* item : items )
+        {
+            item->SetNet( resolveNetCode( sheet.m_netCodeMerges, item->GetNet() ) );
+            item->m_BusNetCode = resolveNetCode( sheet.m_busNetCodeMerges, item->m_BusNetCode );
+        }
 
-        case NET_LABEL:
-        case NET_HIERLABEL:
-        case NET_GLOBLABEL:
-            // Test connections type junction without bus.
-            if( net_item->GetNet() == 0 )
+        if( aCache )
+        {
+            NETLIST_SHEET_CACHE::SHEET& cached = cache[aSheets[i].Path()];
+
+            if( cachedSheets[i] )
             {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
+                cached = std::move( *cachedSheets[i] );
             }
-
-            segmentToPointConnect( net_item, IS_WIRE, istart );
-            break;
-
-        case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
-                break;
-
-        case NET_BUS:
-            // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
+            else
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
+                cached.m_sheetPath = aSheets[i];
+                cached.m_screen = aSheets[i].LastScreen();
+                cached.m_connectivityStamp = cached.m_screen->GetConnectivityStamp();
+                cached.m_readItems = std::move( readItems[i] );
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
-            break;
-
-        case NET_BUSLABELMEMBER:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_GLOBBUSLABELMEMBER:
-            // Control connections similar has on BUS
-            if( net_item->GetNet() == 0 )
+            if( !reusedSheets[i] )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
+                cached.m_order = itemOrders[i];
+                cached.m_items.reset( new NETLIST_OBJECT_LIST() );
+                cached.m_lastNetCode = sheet.m_lastNetCode;
+                cached.m_lastBusNetCode = sheet.m_lastBusNetCode;
+                cached.m_hasUnspecifiedItems = sheet.m_hasUnspecifiedItems;
+
+                for( NETLIST_OBJECT* item : items )
+                    cached.m_items->push_back( new NETLIST_OBJECT( *item ) );
             }
+        }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
-            break;
+        for( NETLIST_OBJECT* item : items )
+        {
+            if( item->GetNet() )
+                item->SetNet( item->GetNet() + netOffset );
+
+            if( item->m_BusNetCode )
+                item->m_BusNetCode += busNetOffset;
         }
+
+        insert( end(), items.begin(), items.end() );
+        items.clear();      // Items are now owned by this list
+
+        m_lastNetCode += sheet.m_lastNetCode - 1;
+        m_lastBusNetCode += sheet.m_lastBusNetCode - 1;
     }
 
+    // Sheets which are no longer in the hierarchy are dropped from the cache
+    if( aCache )
+        aCache->m_sheets.swap( cache );
+
+    if( size() == 0 )
+        return false;
+
+    double localTime = timer.msecs();
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
 #endif
 
+    // Index labels by text, for the connections by label name
+    m_labelIndex.clear();
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        if( GetItem( ii )->IsLabelType() )
+            m_labelIndex[GetItem( ii )->m_Label].push_back( GetItem( ii ) );
+    }
+
     // Updating the Bus Labels Netcode connected by Bus
     connectBusLabels();
 
@@ -358,6 +513,11 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             sheetLabelConnect( GetItem( ii ) );
     }
 
+    m_labelIndex.clear();
+
+    // Store the final net codes in items, before sorting them
+    resolveNetCodes();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -387,9 +547,117 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // find the best label object to give the best net name to each net
     findBestNetNameForEachNet();
 
+    wxLogTrace( traceNetlist,
+                wxT( "%u items, %d nets in %.1f ms (%d of %d sheets cached, read %.1f ms, "
+                     "sheet connections %.1f ms)" ),
+                (unsigned) size(), NetCode, timer.msecs(), cachedSheetCount, sheetCount,
+                readTime, localTime - readTime );
+
     return true;
 }
 
+void NETLIST_OBJECT_LIST::connectSheetItems( unsigned aIdxStart, unsigned aIdxEnd,
+                                             SHEET_CONNECTIONS& aSheet )
+{
+    aSheet.m_lastNetCode = aSheet.m_lastBusNetCode = 1;
+    aSheet.m_hasUnspecifiedItems = false;
+
+    buildSheetIndex( aIdxStart, aIdxEnd, aSheet.m_index );
+
+    for( unsigned ii = aIdxStart; ii < aIdxEnd; ii++ )
+    {
+        NETLIST_OBJECT* net_item = GetItem( ii );
+
+        switch( net_item->m_Type )
+        {
+        case NET_ITEM_UNSPECIFIED:
+            // Reported by BuildNetListInfo(), not from a worker thread
+            aSheet.m_hasUnspecifiedItems = true;
+            break;
+
+        case NET_PIN:
+        case NET_PINLABEL:
+        case NET_SHEETLABEL:
+        case NET_NOCONNECT:
+            if( net_item->GetNet() != 0 )
+                break;
+
+        case NET_SEGMENT:
+            // Test connections point to point type without bus.
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->SetNet( aSheet.m_lastNetCode );
+                aSheet.m_lastNetCode++;
+            }
+
+            pointToPointConnect( net_item, IS_WIRE, aSheet );
+            break;
+
+        case NET_JUNCTION:
+            // Control of the junction outside BUS.
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->SetNet( aSheet.m_lastNetCode );
+                aSheet.m_lastNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_WIRE, aSheet );
+
+            // Control of the junction, on BUS.
+            if( net_item->m_BusNetCode == 0 )
+            {
+                net_item->m_BusNetCode = aSheet.m_lastBusNetCode;
+                aSheet.m_lastBusNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_BUS, aSheet );
+            break;
+
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+            // Test connections type junction without bus.
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->SetNet( aSheet.m_lastNetCode );
+                aSheet.m_lastNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_WIRE, aSheet );
+            break;
+
+        case NET_SHEETBUSLABELMEMBER:
+            if( net_item->m_BusNetCode != 0 )
+                break;
+
+        case NET_BUS:
+            // Control type connections point to point mode bus
+            if( net_item->m_BusNetCode == 0 )
+            {
+                net_item->m_BusNetCode = aSheet.m_lastBusNetCode;
+                aSheet.m_lastBusNetCode++;
+            }
+
+            pointToPointConnect( net_item, IS_BUS, aSheet );
+            break;
+
+        case NET_BUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            // Control connections similar has on BUS
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->m_BusNetCode = aSheet.m_lastBusNetCode;
+                aSheet.m_lastBusNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_BUS, aSheet );
+            break;
+        }
+    }
+}
+
+
 // Helper function to give a priority to sort labels:
 // NET_PINLABEL, NET_GLOBBUSLABELMEMBER and NET_GLOBLABEL are global labels
 // and the priority is high
@@ -610,25 +878,25 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
     if( SheetLabel->GetNet() == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
-    {
-        NETLIST_OBJECT* ObjetNet = GetItem( ii );
+    auto labels = m_labelIndex.find( SheetLabel->m_Label );
+
+    if( labels == m_labelIndex.end() )
+        return;     // no label with the same name
 
+    for( NETLIST_OBJECT* ObjetNet : labels->second )
+    {
         if( ObjetNet->m_SheetPath != SheetLabel->m_SheetPathInclude )
             continue;  //use SheetInclude, not the sheet!!
 
         if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
+        if( getNet( ObjetNet ) == getNet( SheetLabel ) )
             continue;  //already connected.
 
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
-
         // Propagate Netcode having all the objects of the same Netcode.
         if( ObjetNet->GetNet() )
-            propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
+            propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet() );
         else
             ObjetNet->SetNet( SheetLabel->GetNet() );
     }
@@ -640,6 +908,23 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
     // Search is done in the entire list
+
+    // Bus label members are connected when they have the same bus net code and member
+    // number: group them, by order of appearance in list
+    std::unordered_map<uint64_t, NETLIST_OBJECTS> groups;
+
+    auto groupKey = []( NETLIST_OBJECT* aLabel ) -> uint64_t
+    {
+        return ( uint64_t( uint32_t( aLabel->m_BusNetCode ) ) << 32 )
+               | uint32_t( aLabel->m_Member );
+    };
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        if( GetItem( ii )->IsLabelBusMemberType() )
+            groups[groupKey( GetItem( ii ) )].push_back( GetItem( ii ) );
+    }
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
@@ -653,192 +938,285 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
                 m_lastNetCode++;
             }
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+            auto group = groups.find( groupKey( Label ) );
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
+            // Only the first label of a group has to be connected to the next ones:
+            // once done, all the labels of the group are already on the same net.
+            if( group == groups.end() || group->second.front() != Label )
+                continue;
 
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
+            for( NETLIST_OBJECT* LabelInTst : group->second )
+            {
+                if( LabelInTst == Label )
+                    continue;
 
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
+                if( LabelInTst->GetNet() == 0 )
+                    // Append this object to the current net
+                    LabelInTst->SetNet( Label->GetNet() );
+                else
+                    // Merge the 2 net codes, they are connected.
+                    propagateNetCode( LabelInTst->GetNet(), Label->GetNet() );
             }
+
+            groups.erase( group );
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+int NETLIST_OBJECT_LIST::resolveNetCode( std::vector<int>& aMerges, int aNetCode )
 {
-    if( aOldNetCode == aNewNetCode )
+    if( aNetCode <= 0 || aNetCode >= (int) aMerges.size() )
+        return aNetCode;
+
+    int netCode = aNetCode;
+
+    while( aMerges[netCode] != netCode )
+        netCode = aMerges[netCode];
+
+    // Shorten the chain for the next calls
+    while( aMerges[aNetCode] != netCode )
+    {
+        int next = aMerges[aNetCode];
+        aMerges[aNetCode] = netCode;
+        aNetCode = next;
+    }
+
+    return netCode;
+}
+
+
+void NETLIST_OBJECT_LIST::mergeNetCodes( std::vector<int>& aMerges,
+                                         int aOldNetCode, int aNewNetCode )
+{
+    aOldNetCode = resolveNetCode( aMerges, aOldNetCode );
+    aNewNetCode = resolveNetCode( aMerges, aNewNetCode );
+
+    if( aOldNetCode == aNewNetCode || aOldNetCode <= 0 )
         return;
 
-    if( aIsBus == false )    // Propagate NetCode
+    // Net codes never merged refer to themselves
+    int highest = std::max( aOldNetCode, aNewNetCode );
+
+    if( highest >= (int) aMerges.size() )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        size_t first = aMerges.size();
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
+        aMerges.resize( highest + 1 );
+        std::iota( aMerges.begin() + first, aMerges.end(), (int) first );
     }
-    else               // Propagate BusNetCode
+
+    // All the objects having aOldNetCode now have aNewNetCode
+    aMerges[aOldNetCode] = aNewNetCode;
+}
+
+
+void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode )
+{
+    mergeNetCodes( m_netCodeMerges, aOldNetCode, aNewNetCode );
+}
+
+
+void NETLIST_OBJECT_LIST::resolveNetCodes()
+{
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        NETLIST_OBJECT* object = GetItem( ii );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
+        object->SetNet( getNet( object ) );
+    }
+
+    m_netCodeMerges.clear();
+}
+
+
+static uint64_t pointKey( const wxPoint& aPoint )
+{
+    return ( uint64_t( uint32_t( aPoint.x ) ) << 32 ) | uint32_t( aPoint.y );
+}
+
+
+void NETLIST_OBJECT_LIST::buildSheetIndex( unsigned aIdxStart, unsigned aIdxEnd,
+                                           SHEET_INDEX& aIndex )
+{
+    aIndex = SHEET_INDEX();
+
+    for( unsigned ii = aIdxStart; ii < aIdxEnd; ii++ )
+    {
+        NETLIST_OBJECT* item = GetItem( ii );
+
+        aIndex.m_points[pointKey( item->m_Start )].push_back( item );
+
+        if( item->m_End != item->m_Start )
+            aIndex.m_points[pointKey( item->m_End )].push_back( item );
+
+        if( item->m_Type != NET_SEGMENT && item->m_Type != NET_BUS )
+            continue;
+
+        if( item->m_Start.y == item->m_End.y )
+            aIndex.m_horizontalSegments[item->m_Start.y].push_back( item );
+        else if( item->m_Start.x == item->m_End.x )
+            aIndex.m_verticalSegments[item->m_Start.x].push_back( item );
+        else
+            aIndex.m_otherSegments.push_back( item );
     }
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus,
+                                               SHEET_CONNECTIONS& aSheet )
 {
     int netCode;
 
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+    // Items connected to aRef have an end point at one of the end points of aRef
+    const NETLIST_OBJECTS* candidates[2] = { NULL, NULL };
+
+    auto it = aSheet.m_index.m_points.find( pointKey( aRef->m_Start ) );
+
+    if( it != aSheet.m_index.m_points.end() )
+        candidates[0] = &it->second;
+
+    if( aRef->m_End != aRef->m_Start )
     {
-        netCode = aRef->GetNet();
+        it = aSheet.m_index.m_points.find( pointKey( aRef->m_End ) );
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+        if( it != aSheet.m_index.m_points.end() )
+            candidates[1] = &it->second;
+    }
+
+    for( const NETLIST_OBJECTS* items : candidates )
+    {
+        if( !items )
+            continue;
 
+        for( NETLIST_OBJECT* item : *items )
+        {
             if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
                 continue;
 
-            switch( item->m_Type )
+            if( aIsBus == false )    // Objects other than BUS and BUSLABELS
             {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
+                netCode = aRef->GetNet();
+
+                switch( item->m_Type )
                 {
+                case NET_SEGMENT:
+                case NET_PIN:
+                case NET_LABEL:
+                case NET_HIERLABEL:
+                case NET_GLOBLABEL:
+                case NET_SHEETLABEL:
+                case NET_PINLABEL:
+                case NET_JUNCTION:
+                case NET_NOCONNECT:
                     if( item->GetNet() == 0 )
                         item->SetNet( netCode );
                     else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
+                        mergeNetCodes( aSheet.m_netCodeMerges, item->GetNet(), netCode );
+                    break;
+
+                case NET_BUS:
+                case NET_BUSLABELMEMBER:
+                case NET_SHEETBUSLABELMEMBER:
+                case NET_HIERBUSLABELMEMBER:
+                case NET_GLOBBUSLABELMEMBER:
+                case NET_ITEM_UNSPECIFIED:
+                    break;
                 }
-                break;
-
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
             }
-        }
-    }
-    else    // Object type BUS, BUSLABELS, and junctions.
-    {
-        netCode = aRef->m_BusNetCode;
-
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
-
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
-
-            switch( item->m_Type )
+            else    // Object type BUS, BUSLABELS, and junctions.
             {
-            case NET_ITEM_UNSPECIFIED:
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_NOCONNECT:
-                break;
+                netCode = aRef->m_BusNetCode;
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
+                switch( item->m_Type )
                 {
+                case NET_ITEM_UNSPECIFIED:
+                case NET_SEGMENT:
+                case NET_PIN:
+                case NET_LABEL:
+                case NET_HIERLABEL:
+                case NET_GLOBLABEL:
+                case NET_SHEETLABEL:
+                case NET_PINLABEL:
+                case NET_NOCONNECT:
+                    break;
+
+                case NET_BUS:
+                case NET_BUSLABELMEMBER:
+                case NET_SHEETBUSLABELMEMBER:
+                case NET_HIERBUSLABELMEMBER:
+                case NET_GLOBBUSLABELMEMBER:
+                case NET_JUNCTION:
                     if( item->m_BusNetCode == 0 )
                         item->m_BusNetCode = netCode;
                     else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
+                        mergeNetCodes( aSheet.m_busNetCodeMerges, item->m_BusNetCode, netCode );
+                    break;
                 }
-                break;
             }
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus,
+                                                 SHEET_CONNECTIONS& aSheet )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
-    {
-        NETLIST_OBJECT* segment = GetItem( i );
+    // Only the horizontal and vertical segments aligned with the junction can go
+    // through it
+    const NETLIST_OBJECTS* candidates[3] = { NULL, NULL, &aSheet.m_index.m_otherSegments };
+
+    auto hSegments = aSheet.m_index.m_horizontalSegments.find( aJonction->m_Start.y );
+
+    if( hSegments != aSheet.m_index.m_horizontalSegments.end() )
+        candidates[0] = &hSegments->second;
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
+    auto vSegments = aSheet.m_index.m_verticalSegments.find( aJonction->m_Start.x );
+
+    if( vSegments != aSheet.m_index.m_verticalSegments.end() )
+        candidates[1] = &vSegments->second;
+
+    for( const NETLIST_OBJECTS* segments : candidates )
+    {
+        if( !segments )
             continue;
 
-        if( aIsBus == IS_WIRE )
+        for( NETLIST_OBJECT* segment : *segments )
         {
-            if( segment->m_Type != NET_SEGMENT )
+            // if different sheets, obviously no physical connection between elements.
+            if( segment->m_SheetPath != aJonction->m_SheetPath )
                 continue;
-        }
-        else
-        {
-            if( segment->m_Type != NET_BUS )
-                continue;
-        }
 
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
-        {
-            // Propagation Netcode has all the objects of the same Netcode.
             if( aIsBus == IS_WIRE )
             {
-                if( segment->GetNet() )
-                    propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
-                else
-                    segment->SetNet( aJonction->GetNet() );
+                if( segment->m_Type != NET_SEGMENT )
+                    continue;
             }
             else
             {
-                if( segment->m_BusNetCode )
-                    propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
+                if( segment->m_Type != NET_BUS )
+                    continue;
+            }
+
+            if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
+            {
+                // Propagation Netcode has all the objects of the same Netcode.
+                if( aIsBus == IS_WIRE )
+                {
+                    if( segment->GetNet() )
+                        mergeNetCodes( aSheet.m_netCodeMerges, segment->GetNet(),
+                                       aJonction->GetNet() );
+                    else
+                        segment->SetNet( aJonction->GetNet() );
+                }
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                {
+                    if( segment->m_BusNetCode )
+                        mergeNetCodes( aSheet.m_busNetCodeMerges, segment->m_BusNetCode,
+                                       aJonction->m_BusNetCode );
+                    else
+                        segment->m_BusNetCode = aJonction->m_BusNetCode;
+                }
             }
         }
     }
@@ -850,11 +1228,15 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
     if( aLabelRef->GetNet() == 0 )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
-    {
-        NETLIST_OBJECT* item = GetItem( i );
+    // Only labels having the same name can be connected
+    auto labels = m_labelIndex.find( aLabelRef->m_Label );
+
+    if( labels == m_labelIndex.end() )
+        return;
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+    for( NETLIST_OBJECT* item : labels->second )
+    {
+        if( getNet( item ) == getNet( aLabelRef ) )
             continue;
 
         if( item->m_SheetPath != aLabelRef->m_SheetPath )
@@ -874,16 +1256,10 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
         // NET_LABEL are local to a sheet
         // NET_GLOBLABEL are global.
         // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
-        {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
-        }
+        if( item->GetNet() )
+            propagateNetCode( item->GetNet(), aLabelRef->GetNet() );
+        else
+            item->SetNet( aLabelRef->GetNet() );
     }
 }
 
@@ -424,6 +424,20 @@ void SCH_COMPONENT::ResolveAll( const SCH_COLLECTOR& aComponents, SYMBOL_LIB_TAB
     // sort it by lib part. Cmp will be grouped by same lib part.
     std::sort( cmp_list.begin(), cmp_list.end(), sort_by_libid );
 
+    // Load the libraries used by the components in parallel.  The errors are reported
+    // when the components are resolved below.
+    std::vector<wxString> nicknames;
+
+    for( SCH_COMPONENT* cmp : cmp_list )
+    {
+        wxString nickname = FROM_UTF8( cmp->m_lib_id.GetLibNickname() );
+
+        if( !nickname.IsEmpty() && ( nicknames.empty() || nicknames.back() != nickname ) )
+            nicknames.push_back( nickname );
+    }
+
+    aLibTable.PrefetchLibs( nicknames );
+
     LIB_ID curr_libid;
 
     for( unsigned ii = 0; ii < cmp_list.size (); ++ii )
@@ -33,6 +33,7 @@
 #include <richio.h>
 #include <core/typeinfo.h>
 #include <properties.h>
+#include <profile.h>
 
 #include <general.h>
 #include <lib_field.h>
@@ -140,7 +141,7 @@ static bool strCompare( const char* aString, const char* aLine, const char** aOu
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a valid integer.
  */
-static int parseInt( FILE_LINE_READER& aReader, const char* aLine, const char** aOutput = NULL )
+static int parseInt( LINE_READER& aReader, const char* aLine, const char** aOutput = NULL )
 {
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
@@ -184,7 +185,7 @@ static int parseInt( FILE_LINE_READER& aReader, const char* aLine, const char**
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a valid integer.
  */
-static unsigned long parseHex( FILE_LINE_READER& aReader, const char* aLine,
+static unsigned long parseHex( LINE_READER& aReader, const char* aLine,
                                const char** aOutput = NULL )
 {
     if( !*aLine )
@@ -232,7 +233,7 @@ static unsigned long parseHex( FILE_LINE_READER& aReader, const char* aLine,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a valid integer.
  */
-static double parseDouble( FILE_LINE_READER& aReader, const char* aLine,
+static double parseDouble( LINE_READER& aReader, const char* aLine,
                            const char** aOutput = NULL )
 {
     if( !*aLine )
@@ -275,7 +276,7 @@ static double parseDouble( FILE_LINE_READER& aReader, const char* aLine,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a a single character token.
  */
-static char parseChar( FILE_LINE_READER& aReader, const char* aCurrentToken,
+static char parseChar( LINE_READER& aReader, const char* aCurrentToken,
                        const char** aNextToken = NULL )
 {
     while( *aCurrentToken && isspace( *aCurrentToken ) )
@@ -317,7 +318,7 @@ static char parseChar( FILE_LINE_READER& aReader, const char* aCurrentToken,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the \a aCanBeEmpty is false and no string was parsed.
  */
-static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
+static void parseUnquotedString( wxString& aString, LINE_READER& aReader,
                                  const char* aCurrentToken, const char** aNextToken = NULL,
                                  bool aCanBeEmpty = false )
 {
@@ -381,7 +382,7 @@ static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the \a aCanBeEmpty is false and no string was parsed.
  */
-static void parseQuotedString( wxString& aString, FILE_LINE_READER& aReader,
+static void parseQuotedString( wxString& aString, LINE_READER& aReader,
                                const char* aCurrentToken, const char** aNextToken = NULL,
                                bool aCanBeEmpty = false )
 {
@@ -482,6 +483,7 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMajor;
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
+    size_t          m_deferredSize; // Size of the DRAW sections not parsed by Load().
 
     LIB_PART*       loadPart( FILE_LINE_READER& aReader );
     void            loadHeader( FILE_LINE_READER& aReader );
@@ -489,18 +491,20 @@ class SCH_LEGACY_PLUGIN_CACHE
     void            loadField( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
     void            loadDrawEntries( std::unique_ptr< LIB_PART >& aPart,
                                      FILE_LINE_READER&            aReader );
+    void            parseDrawEntries( LIB_PART* aPart, LIB_ITEMS& aItems, long aOffset,
+                                      unsigned aLineNumber );
     void            loadFootprintFilters( std::unique_ptr< LIB_PART >& aPart,
                                           FILE_LINE_READER&            aReader );
     void            loadDocs();
-    LIB_ARC*        loadArc( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_CIRCLE*     loadCircle( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_TEXT*       loadText( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_RECTANGLE*  loadRectangle( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_PIN*        loadPin( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_POLYLINE*   loadPolyLine( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_BEZIER*     loadBezier( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-
-    FILL_T          parseFillMode( FILE_LINE_READER& aReader, const char* aLine,
+    LIB_ARC*        loadArc( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_CIRCLE*     loadCircle( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_TEXT*       loadText( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_RECTANGLE*  loadRectangle( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_PIN*        loadPin( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_POLYLINE*   loadPolyLine( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_BEZIER*     loadBezier( LIB_PART* aPart, LINE_READER& aReader );
+
+    FILL_T          parseFillMode( LINE_READER& aReader, const char* aLine,
                                    const char** aOutput );
     bool            checkForDuplicates( wxString& aAliasName );
     LIB_ALIAS*      removeAlias( LIB_ALIAS* aAlias );
@@ -2032,6 +2036,7 @@ SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFi
     m_versionMajor = -1;
     m_versionMinor = -1;
     m_libType = LIBRARY_TYPE_EESCHEMA;
+    m_deferredSize = 0;
 }
 
 
@@ -2158,8 +2163,11 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file '%s'",
                 m_libFileName.GetFullPath() );
 
+    PROF_COUNTER     timer;
     FILE_LINE_READER reader( m_libFileName.GetFullPath() );
 
+    m_deferredSize = 0;
+
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
 
@@ -2227,6 +2235,11 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 
     if( USE_OLD_DOC_FILE_FORMAT( m_versionMajor, m_versionMinor ) )
         loadDocs();
+
+    wxLogTrace( traceSchLegacyPlugin,
+                "Loaded %u aliases of '%s' in %.1f ms, %u bytes of drawings deferred",
+                (unsigned) m_aliases.size(), m_libFileName.GetFullName(), timer.msecs(),
+                (unsigned) m_deferredSize );
 }
 
 
@@ -2694,41 +2707,124 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr< LIB_PART >& aPar
 
     wxCHECK_RET( strCompare( "DRAW", line, &line ), "Invalid DRAW section" );
 
+    // Most of the parts of a library are never drawn: the section is skipped here, and
+    // its graphic items and pins are read from the file the first time the part drawings
+    // are used.  Only the entry types are checked, so a broken library still fails to load.
+    long     offset = aReader.Tell();
+    unsigned lineNumber = aReader.LineNumber();
+
     line = aReader.ReadLine();
 
+    while( line )
+    {
+        if( strCompare( "ENDDRAW", line ) )
+        {
+            LIB_PART* part = aPart.get();
+
+            m_deferredSize += aReader.Tell() - offset;
+
+            aPart->SetDrawingsLoader( [this, part, offset, lineNumber]( LIB_ITEMS& aItems )
+                {
+                    try
+                    {
+                        parseDrawEntries( part, aItems, offset, lineNumber );
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        wxLogError( _( "Cannot load the drawings of symbol '%s':\n%s" ),
+                                    part->GetName(), ioe.What() );
+                    }
+                } );
+
+            return;
+        }
+
+        switch( line[0] )
+        {
+        case 'A':    // Arc
+        case 'C':    // Circle
+        case 'T':    // Text
+        case 'S':    // Square
+        case 'X':    // Pin Description
+        case 'P':    // Polyline
+        case 'B':    // Bezier Curves
+        case '#':    // Comment
+        case '\n':   // Empty line
+        case '\r':
+        case 0:
+            break;
+
+        default:
+            SCH_PARSE_ERROR( _( "undefined DRAW entry" ), aReader, line );
+        }
+
+        line = aReader.ReadLine();
+    }
+
+    SCH_PARSE_ERROR( _( "file ended prematurely loading component draw element" ), aReader, line );
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::parseDrawEntries( LIB_PART* aPart, LIB_ITEMS& aItems,
+                                                long aOffset, unsigned aLineNumber )
+{
+    // The section is found by its position in the file when the library was loaded.
+    if( IsFileChanged() )
+        THROW_IO_ERROR( wxString::Format( _( "library file '%s' changed since it was loaded" ),
+                                          GetFileName() ) );
+
+    FILE* fp = wxFopen( GetFileName(), wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename '%s' for reading" ),
+                                          GetFileName() ) );
+
+    // The lines are numbered as in the file, for the parse errors.
+    FILE_LINE_READER reader( fp, GetFileName(), true, aLineNumber );
+
+    if( fseek( fp, aOffset, SEEK_SET ) )
+        THROW_IO_ERROR( wxString::Format( _( "cannot read library file '%s'" ),
+                                          GetFileName() ) );
+
+    const char* line = reader.ReadLine();
+
     while( line )
     {
         if( strCompare( "ENDDRAW", line, &line ) )
+        {
+            // Reorder drawings: transparent polygons first, pins and text last.
+            aItems.sort();
             return;
+        }
 
         switch( line[0] )
         {
         case 'A':    // Arc
-            aPart->AddDrawItem( loadArc( aPart, aReader ) );
+            aItems.push_back( loadArc( aPart, reader ) );
             break;
 
         case 'C':    // Circle
-            aPart->AddDrawItem( loadCircle( aPart, aReader ) );
+            aItems.push_back( loadCircle( aPart, reader ) );
             break;
 
         case 'T':    // Text
-            aPart->AddDrawItem( loadText( aPart, aReader ) );
+            aItems.push_back( loadText( aPart, reader ) );
             break;
 
         case 'S':    // Square
-            aPart->AddDrawItem( loadRectangle( aPart, aReader ) );
+            aItems.push_back( loadRectangle( aPart, reader ) );
             break;
 
         case 'X':    // Pin Description
-            aPart->AddDrawItem( loadPin( aPart, aReader ) );
+            aItems.push_back( loadPin( aPart, reader ) );
             break;
 
         case 'P':    // Polyline
-            aPart->AddDrawItem( loadPolyLine( aPart, aReader ) );
+            aItems.push_back( loadPolyLine( aPart, reader ) );
             break;
 
         case 'B':    // Bezier Curves
-            aPart->AddDrawItem( loadBezier( aPart, aReader ) );
+            aItems.push_back( loadBezier( aPart, reader ) );
             break;
 
         case '#':    // Comment
@@ -2738,17 +2834,17 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr< LIB_PART >& aPar
             break;
 
         default:
-            SCH_PARSE_ERROR( _( "undefined DRAW entry" ), aReader, line );
+            SCH_PARSE_ERROR( _( "undefined DRAW entry" ), reader, line );
         }
 
-        line = aReader.ReadLine();
+        line = reader.ReadLine();
     }
 
-    SCH_PARSE_ERROR( _( "file ended prematurely loading component draw element" ), aReader, line );
+    SCH_PARSE_ERROR( _( "file ended prematurely loading component draw element" ), reader, line );
 }
 
 
-FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( FILE_LINE_READER& aReader, const char* aLine,
+FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( LINE_READER& aReader, const char* aLine,
                                                const char** aOutput )
 {
     FILL_T mode;
@@ -2775,14 +2871,14 @@ FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( FILE_LINE_READER& aReader, const
 }
 
 
-LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( std::unique_ptr< LIB_PART >& aPart,
-                                           FILE_LINE_READER&            aReader )
+LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( LIB_PART*    aPart,
+                                           LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "A", line, &line ), NULL, "Invalid LIB_ARC definition" );
 
-    std::unique_ptr< LIB_ARC > arc( new LIB_ARC( aPart.get() ) );
+    std::unique_ptr< LIB_ARC > arc( new LIB_ARC( aPart ) );
 
     wxPoint center;
 
@@ -2841,14 +2937,14 @@ LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( std::unique_ptr< LIB_PART >& aPart,
-                                                 FILE_LINE_READER&            aReader )
+LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( LIB_PART*    aPart,
+                                                 LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "C", line, &line ), NULL, "Invalid LIB_CIRCLE definition" );
 
-    std::unique_ptr< LIB_CIRCLE > circle( new LIB_CIRCLE( aPart.get() ) );
+    std::unique_ptr< LIB_CIRCLE > circle( new LIB_CIRCLE( aPart ) );
 
     wxPoint center;
 
@@ -2868,14 +2964,14 @@ LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( std::unique_ptr< LIB_PART >& aP
 }
 
 
-LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
-                                             FILE_LINE_READER&            aReader )
+LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( LIB_PART*    aPart,
+                                             LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "T", line, &line ), NULL, "Invalid LIB_TEXT definition" );
 
-    std::unique_ptr< LIB_TEXT > text( new LIB_TEXT( aPart.get() ) );
+    std::unique_ptr< LIB_TEXT > text( new LIB_TEXT( aPart ) );
 
     text->SetTextAngle( (double) parseInt( aReader, line, &line ) );
 
@@ -2975,14 +3071,14 @@ LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( std::unique_ptr< LIB_PART >& aPart,
-                                                       FILE_LINE_READER&            aReader )
+LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( LIB_PART*    aPart,
+                                                       LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "S", line, &line ), NULL, "Invalid LIB_RECTANGLE definition" );
 
-    std::unique_ptr< LIB_RECTANGLE > rectangle( new LIB_RECTANGLE( aPart.get() ) );
+    std::unique_ptr< LIB_RECTANGLE > rectangle( new LIB_RECTANGLE( aPart ) );
 
     wxPoint pos;
 
@@ -3007,14 +3103,14 @@ LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( std::unique_ptr< LIB_PART
 }
 
 
-LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
-                                           FILE_LINE_READER&            aReader )
+LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( LIB_PART*    aPart,
+                                           LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "X", line, &line ), NULL, "Invalid LIB_PIN definition" );
 
-    std::unique_ptr< LIB_PIN > pin( new LIB_PIN( aPart.get() ) );
+    std::unique_ptr< LIB_PIN > pin( new LIB_PIN( aPart ) );
 
     wxString name, number;
 
@@ -3194,14 +3290,14 @@ LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( std::unique_ptr< LIB_PART >& aPart,
-                                                     FILE_LINE_READER&            aReader )
+LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( LIB_PART*    aPart,
+                                                     LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "P", line, &line ), NULL, "Invalid LIB_POLYLINE definition" );
 
-    std::unique_ptr< LIB_POLYLINE > polyLine( new LIB_POLYLINE( aPart.get() ) );
+    std::unique_ptr< LIB_POLYLINE > polyLine( new LIB_POLYLINE( aPart ) );
 
     int points = parseInt( aReader, line, &line );
     polyLine->SetUnit( parseInt( aReader, line, &line ) );
@@ -3224,14 +3320,14 @@ LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( std::unique_ptr< LIB_PART >
 }
 
 
-LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( std::unique_ptr< LIB_PART >& aPart,
-                                                 FILE_LINE_READER&            aReader )
+LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( LIB_PART*    aPart,
+                                                 LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "B", line, &line ), NULL, "Invalid LIB_BEZIER definition" );
 
-    std::unique_ptr< LIB_BEZIER > bezier( new LIB_BEZIER( aPart.get() ) );
+    std::unique_ptr< LIB_BEZIER > bezier( new LIB_BEZIER( aPart ) );
 
     int points = parseInt( aReader, line, &line );
     bezier->SetUnit( parseInt( aReader, line, &line ) );
@@ -3284,6 +3380,11 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    // The drawings not used yet are read from the library file, which is about to be
+    // overwritten.
+    for( LIB_ALIAS_MAP::iterator it = m_aliases.begin();  it != m_aliases.end();  it++ )
+        it->second->GetPart()->LoadDrawings();
+
     std::unique_ptr< FILE_OUTPUTFORMATTER > formatter( new FILE_OUTPUTFORMATTER( m_libFileName.GetFullPath() ) );
     formatter->Print( 0, "%s %d.%d\n", LIBFILE_IDENT, LIB_VERSION_MAJOR, LIB_VERSION_MINOR );
     formatter->Print( 0, "#encoding utf-8\n");
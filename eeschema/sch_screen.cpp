@@ -92,12 +92,17 @@ static GRID_TYPE SchematicGridList[] = {
 };
 
 
+/// The last connectivity stamp given to a screen, see SCH_SCREEN::GetConnectivityStamp()
+static unsigned s_lastConnectivityStamp = 0;
+
+
 SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
     BASE_SCREEN( SCH_SCREEN_T ),
     KIWAY_HOLDER( aKiway ),
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    ConnectivityChanged();
 
     SetZoom( 32 );
 
@@ -149,15 +154,23 @@ void SCH_SCREEN::Clear()
 }
 
 
+void SCH_SCREEN::ConnectivityChanged()
+{
+    m_connectivityStamp = ++s_lastConnectivityStamp;
+}
+
+
 void SCH_SCREEN::FreeDrawList()
 {
     m_drawList.DeleteAll();
+    ConnectivityChanged();
 }
 
 
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     m_drawList.Remove( aItem );
+    ConnectivityChanged();
 }
 
 
@@ -166,6 +179,7 @@ void SCH_SCREEN::DeleteItem( SCH_ITEM* aItem )
     wxCHECK_RET( aItem, wxT( "Cannot delete invalid item from screen." ) );
 
     SetModify();
+    ConnectivityChanged();
 
     if( aItem->Type() == SCH_SHEET_PIN_T )
     {
@@ -263,6 +277,8 @@ void SCH_SCREEN::ExtractWires( DLIST< SCH_ITEM >& aList, bool aCreateCopy )
             break;
         }
     }
+
+    ConnectivityChanged();
 }
 
 
@@ -289,6 +305,7 @@ void SCH_SCREEN::ReplaceWires( DLIST< SCH_ITEM >& aWireList )
     }
 
     m_drawList.Append( aWireList );
+    ConnectivityChanged();
 }
 
 
@@ -550,6 +567,7 @@ void SCH_SCREEN::CheckComponentsToPartsLinks()
             SCH_COMPONENT::ResolveAll( c, libs );
 
             m_modification_sync = mod_hash;     // note the last mod_hash
+            ConnectivityChanged();              // pins may have changed
         }
     }
 }
@@ -954,6 +972,9 @@ bool SCH_SCREEN::BreakSegment( const wxPoint& aPoint )
         brokenSegments = true;
     }
 
+    if( brokenSegments )
+        ConnectivityChanged();
+
     return brokenSegments;
 }
 
@@ -1405,6 +1426,13 @@ void SCH_SCREENS::ClearAnnotation()
 }
 
 
+void SCH_SCREENS::ConnectivityChanged()
+{
+    for( size_t i = 0;  i < m_screens.size();  i++ )
+        m_screens[i]->ConnectivityChanged();
+}
+
+
 void SCH_SCREENS::SchematicCleanUp()
 {
     for( size_t i = 0;  i < m_screens.size();  i++ )
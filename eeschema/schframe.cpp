@@ -41,6 +41,7 @@
 #include <general.h>
 #include <eeschema_id.h>
 #include <netlist.h>
+#include <class_netlist_object.h>
 #include <lib_pin.h>
 #include <class_library.h>
 #include <schframe.h>
@@ -360,6 +361,7 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
     m_dlgFindReplace = NULL;
     m_findReplaceData = new wxFindReplaceData( wxFR_DOWN );
     m_undoItem = NULL;
+    m_netlistCache = NULL;
     m_hasAutoSave = true;
 
     SetForceHVLines( true );
@@ -447,11 +449,13 @@ SCH_EDIT_FRAME::~SCH_EDIT_FRAME()
 
     delete m_CurrentSheet;          // a SCH_SHEET_PATH, on the heap.
     delete m_undoItem;
+    delete m_netlistCache;
     delete g_RootSheet;
     delete m_findReplaceData;
 
     m_CurrentSheet = NULL;
     m_undoItem = NULL;
+    m_netlistCache = NULL;
     g_RootSheet = NULL;
     m_findReplaceData = NULL;
 }
@@ -763,6 +767,7 @@ void SCH_EDIT_FRAME::OnModify()
 {
     GetScreen()->SetModify();
     GetScreen()->SetSave();
+    GetScreen()->ConnectivityChanged();
 
     m_foundItems.SetForceSearch();
 
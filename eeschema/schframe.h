@@ -64,6 +64,7 @@ class DIALOG_SCH_FIND;
 class wxFindDialogEvent;
 class wxFindReplaceData;
 class SCHLIB_FILTER;
+class NETLIST_SHEET_CACHE;
 
 
 /// enum used in RotationMiroir()
@@ -142,6 +143,8 @@ private:
     SCH_COLLECTOR           m_collectedItems;     ///< List of collected items.
     SCH_FIND_COLLECTOR      m_foundItems;         ///< List of find/replace items.
     SCH_ITEM*               m_undoItem;           ///< Copy of the current item being edited.
+    NETLIST_SHEET_CACHE*    m_netlistCache;       ///< Items of the sheets of the last netlist,
+                                                  ///< see BuildNetListBase().
     wxString                m_simulatorCommand;   ///< Command line used to call the circuit
                                                   ///< simulator (gnucap, spice, ...)
     wxString                m_netListerCommand;   ///< Command line to call a custom net list
@@ -504,6 +507,8 @@ public:
      * netlist generation:
      * Creates a flat list which stores all connected objects, and mainly
      * pins and labels.
+     * The items of the sheets which were not modified since the previous call
+     * are reused, see NETLIST_SHEET_CACHE.
      * @param updateStatusText = decides if window StatusText should be modified
      * @return NETLIST_OBJECT_LIST* - caller owns the object.
      */
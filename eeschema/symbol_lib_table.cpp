@@ -30,6 +30,7 @@
 #include <lib_id.h>
 #include <lib_table_lexer.h>
 #include <symbol_lib_table.h>
+#include <symbol_libs_loader.h>
 #include <class_libentry.h>
 
 #define OPT_SEP     '|'         ///< options separator character
@@ -215,6 +216,61 @@ void SYMBOL_LIB_TABLE::EnumerateSymbolLib( const wxString& aNickname, wxArrayStr
 }
 
 
+bool SYMBOL_LIB_TABLE::PrefetchLibs( const std::vector<wxString>& aNicknames,
+                                     wxString* aErrors )
+{
+    std::vector<const SYMBOL_LIB_TABLE_ROW*> rows( aNicknames.size(), NULL );
+    std::vector<wxString>                    uris( aNicknames.size() );
+    std::vector<wxString>                    errors( aNicknames.size() );
+
+    // The plugins are instantiated and the URIs expanded here: the worker threads only
+    // read the libraries, each one with its own plugin.
+    for( size_t i = 0; i < aNicknames.size(); ++i )
+    {
+        try
+        {
+            rows[i] = FindRow( aNicknames[i] );
+            uris[i] = rows[i]->GetFullURI( true );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            errors[i] = ioe.What();
+        }
+    }
+
+    SYMBOL_LIBS_LOADER loader( aNicknames.size(), [&]( size_t aIndex )
+        {
+            const SYMBOL_LIB_TABLE_ROW* row = rows[aIndex];
+            wxArrayString               aliasNames;
+
+            if( row )
+                row->plugin->EnumerateSymbolLib( aliasNames, uris[aIndex], row->GetProperties() );
+        } );
+
+    bool ok = loader.Run();
+
+    for( size_t i = 0; i < aNicknames.size(); ++i )
+    {
+        const wxString& error = errors[i].IsEmpty() ? loader.GetError( i ) : errors[i];
+
+        if( error.IsEmpty() )
+            continue;
+
+        ok = false;
+
+        if( aErrors )
+        {
+            if( !aErrors->IsEmpty() )
+                *aErrors += '\n';
+
+            *aErrors += error;
+        }
+    }
+
+    return ok;
+}
+
+
 const SYMBOL_LIB_TABLE_ROW* SYMBOL_LIB_TABLE::FindRow( const wxString& aNickname )
 
 {
@@ -137,6 +137,19 @@ public:
      */
     void EnumerateSymbolLib( const wxString& aNickname, wxArrayString& aAliasNames );
 
+    /**
+     * Load the libraries given by @a aNicknames into their plugin caches, in parallel.
+     *
+     * Once loaded, the symbols of these libraries are found without reading the files.
+     *
+     * @param aNicknames are the names of the libraries to load.  They must be unique.
+     * @param aErrors, if not NULL, receives the errors of the libraries which could not be
+     *                loaded, in the order of @a aNicknames.
+     *
+     * @return true if all the libraries were loaded.
+     */
+    bool PrefetchLibs( const std::vector<wxString>& aNicknames, wxString* aErrors = NULL );
+
     /**
      * Load a #LIB_ALIAS having @a aAliasName from the library given by @a aNickname.
      *
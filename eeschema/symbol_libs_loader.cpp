@@ -0,0 +1,109 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+#include <common.h>
+#include <profile.h>
+#include <richio.h>
+#include <symbol_libs_loader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+/**
+ * Trace mask to log the symbol library loading times.
+ */
+static const wxChar traceSymbolLibsLoader[] = wxT( "KICAD_SYMBOL_LIBS_LOADER" );
+
+
+SYMBOL_LIBS_LOADER::SYMBOL_LIBS_LOADER( size_t aCount, const JOB& aJob ) :
+    m_count( aCount ),
+    m_job( aJob ),
+    m_errors( aCount )
+{
+}
+
+
+bool SYMBOL_LIBS_LOADER::Run( const PROGRESS& aProgress )
+{
+    // See FOOTPRINT_LIST_IMPL::JoinWorkers(): the locale is global, it is only safe to
+    // switch it here, before the threads are created, and to restore it after they finish.
+    LOCALE_IO                   toggle_locale;
+    PROF_COUNTER                timer;
+    std::atomic<size_t>         nextJob( 0 );
+    std::atomic<size_t>         doneCount( 0 );
+    std::atomic<bool>           failed( false );
+    std::vector<std::thread>    threads;
+
+    size_t threadCount = std::min<size_t>( m_count,
+                                           std::max( 1u, std::thread::hardware_concurrency() ) );
+
+    for( size_t i = 0; i < threadCount; ++i )
+    {
+        threads.push_back( std::thread( [&]() {
+            for( size_t job = nextJob++; job < m_count; job = nextJob++ )
+            {
+                try
+                {
+                    m_job( job );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    m_errors[job] = ioe.What();
+                    failed = true;
+                }
+                catch( const std::exception& se )
+                {
+                    m_errors[job] = FROM_UTF8( se.what() );
+                    failed = true;
+                }
+
+                doneCount++;
+            }
+        } ) );
+    }
+
+    if( aProgress )
+    {
+        while( doneCount < m_count )
+        {
+            aProgress( doneCount );
+            std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        }
+    }
+
+    for( auto& thread : threads )
+        thread.join();
+
+    if( aProgress )
+        aProgress( m_count );
+
+    wxLogTrace( traceSymbolLibsLoader,
+                wxT( "Loaded %u symbol libraries with %u threads in %.1f ms" ),
+                (unsigned) m_count, (unsigned) threadCount, timer.msecs() );
+
+    return !failed;
+}
@@ -0,0 +1,77 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _SYMBOL_LIBS_LOADER_H_
+#define _SYMBOL_LIBS_LOADER_H_
+
+#include <functional>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Class SYMBOL_LIBS_LOADER
+ * loads a set of symbol libraries with a pool of worker threads.
+ *
+ * Each library is loaded by a job, identified by its index, which may throw an IO_ERROR.
+ * The jobs store their results by index, and the errors are kept by index too, so the
+ * caller can merge both in a deterministic order whatever the thread that ran a job.
+ *
+ * The locale is switched to "C" by the calling thread for the whole load: LOCALE_IO is
+ * only thread safe when created before the worker threads and destroyed after they finish.
+ */
+class SYMBOL_LIBS_LOADER
+{
+public:
+    typedef std::function<void( size_t aIndex )> JOB;
+    typedef std::function<void( size_t aDone )>  PROGRESS;
+
+    /**
+     * @param aCount is the number of libraries to load.
+     * @param aJob loads the library \a aIndex, and is called from the worker threads.
+     */
+    SYMBOL_LIBS_LOADER( size_t aCount, const JOB& aJob );
+
+    /**
+     * Run all the jobs and return when they are finished.
+     *
+     * @param aProgress, if not empty, is called from the calling thread with the number
+     *                   of finished jobs while the workers run, e.g. to update a progress
+     *                   dialog.
+     * @return true if no job failed.
+     */
+    bool Run( const PROGRESS& aProgress = PROGRESS() );
+
+    /**
+     * @return the error message of the job \a aIndex, or an empty string if it succeeded.
+     */
+    const wxString& GetError( size_t aIndex ) const { return m_errors[aIndex]; }
+
+private:
+    size_t                  m_count;
+    JOB                     m_job;
+    std::vector<wxString>   m_errors;
+};
+
+#endif  // _SYMBOL_LIBS_LOADER_H_
@@ -34,7 +34,8 @@
 
 COMPONENT_TREE::COMPONENT_TREE( wxWindow* aParent,
         CMP_TREE_MODEL_ADAPTER::PTR& aAdapter, WIDGETS aWidgets )
-    : wxPanel( aParent ), m_adapter( aAdapter ), m_query_ctrl( nullptr ), m_details_ctrl( nullptr )
+    : wxPanel( aParent ), m_adapter( aAdapter ), m_query_ctrl( nullptr ), m_details_ctrl( nullptr ),
+      m_query_pending( false )
 {
     auto sizer = new wxBoxSizer( wxVERTICAL );
 
@@ -145,8 +146,13 @@ void COMPONENT_TREE::onInitDialog( wxInitDialogEvent& aEvent )
 
 void COMPONENT_TREE::onQueryText( wxCommandEvent& aEvent )
 {
-    m_adapter->UpdateSearchString( m_query_ctrl->GetLineText( 0 ) );
-    postPreselectEvent();
+    // The search runs once the pending events are processed, so keystrokes typed while a
+    // search is running do not start a search each: only the last text is searched.
+    if( !m_query_pending )
+    {
+        m_query_pending = true;
+        CallAfter( &COMPONENT_TREE::updateSearch );
+    }
 
     // Required to avoid interaction with SetHint()
     // See documentation for wxTextEntry::SetHint
@@ -154,8 +160,21 @@ void COMPONENT_TREE::onQueryText( wxCommandEvent& aEvent )
 }
 
 
+void COMPONENT_TREE::updateSearch()
+{
+    if( !m_query_pending )
+        return;     // already done by onQueryEnter()
+
+    m_query_pending = false;
+    m_adapter->UpdateSearchString( m_query_ctrl->GetLineText( 0 ) );
+    postPreselectEvent();
+}
+
+
 void COMPONENT_TREE::onQueryEnter( wxCommandEvent& aEvent )
 {
+    updateSearch();
+
     if( GetSelectedAlias() )
         postSelectEvent();
 }
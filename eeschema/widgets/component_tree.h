@@ -74,6 +74,11 @@ protected:
      */
     void postSelectEvent();
 
+    /**
+     * Update the tree for the current search text, see onQueryText().
+     */
+    void updateSearch();
+
     // Event handlers
     void onInitDialog( wxInitDialogEvent& aEvent );
 
@@ -92,6 +97,9 @@ protected:
     wxTextCtrl*     m_query_ctrl;
     wxDataViewCtrl* m_tree_ctrl;
     wxHtmlWindow*   m_details_ctrl;
+
+    ///> A search for the query text is waiting for the pending events to be processed
+    bool            m_query_pending;
 };
 
 ///> Custom event sent when a new component is preselected
@@ -216,6 +216,8 @@ void GERBVIEW_FRAME::Block_Move()
             if( gerb_item->HitTest( GetScreen()->m_BlockLocate ) )
                 gerb_item->MoveAB( delta );
         }
+
+        gerber->InvalidateItemsIndex();
     }
 
     m_canvas->Refresh( true );
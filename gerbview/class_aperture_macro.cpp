@@ -59,7 +59,7 @@ static wxPoint mapPt( double x, double y, bool isMetric )
 }
 
 
-bool AM_PRIMITIVE::IsAMPrimitiveExposureOn(GERBER_DRAW_ITEM* aParent) const
+bool AM_PRIMITIVE::IsAMPrimitiveExposureOn( const GERBER_DRAW_ITEM* aParent ) const
 {
     /*
      * Some but not all primitives use the first parameter as an exposure control.
@@ -94,7 +94,7 @@ bool AM_PRIMITIVE::IsAMPrimitiveExposureOn(GERBER_DRAW_ITEM* aParent) const
 
 const int seg_per_circle = 64;   // Number of segments to approximate a circle
 
-void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
+void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent,
                                    SHAPE_POLY_SET& aShapeBuffer,
                                    wxPoint aShapePos )
 {
@@ -103,8 +103,8 @@ void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
                                 aShapeBuffer.Append( polybuffer[jj].x, polybuffer[jj].y );}
 
     // Draw the primitive shape for flashed items.
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
-    polybuffer.clear();
+    // Not static: the shapes of several images can be converted concurrently
+    std::vector<wxPoint> polybuffer;
 
     wxPoint curPos = aShapePos;
     D_CODE* tool   = aParent->GetDcodeDescr();
@@ -432,7 +432,7 @@ void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
  * because circles are very easy to draw (no rotation problem) so convert them in polygons,
  * and draw them as polygons is not a good idea.
  */
-void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
+void AM_PRIMITIVE::ConvertShapeToPolygon( const GERBER_DRAW_ITEM* aParent,
                                           std::vector<wxPoint>& aBuffer )
 {
     D_CODE* tool = aParent->GetDcodeDescr();
@@ -642,6 +642,31 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
     }
 }
 
+void APERTURE_MACRO::TransformShapeToPolygon( const GERBER_DRAW_ITEM* aParent,
+                                              SHAPE_POLY_SET& aShapeBuffer,
+                                              const wxPoint& aShapePos )
+{
+    SHAPE_POLY_SET holeBuffer;
+
+    for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
+         prim_macro != primitives.end(); ++prim_macro )
+    {
+        if( prim_macro->IsAMPrimitiveExposureOn( aParent ) )
+            prim_macro->DrawBasicShape( aParent, aShapeBuffer, aShapePos );
+        else
+        {
+            prim_macro->DrawBasicShape( aParent, holeBuffer, aShapePos );
+
+            if( holeBuffer.OutlineCount() )     // we have a new hole in shape: remove the hole
+            {
+                aShapeBuffer.BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
+                holeBuffer.RemoveAllContours();
+            }
+        }
+    }
+}
+
+
 /** GetShapeDim
  * Calculate a value that can be used to evaluate the size of text
  * when displaying the D-Code of an item
@@ -757,33 +782,15 @@ void APERTURE_MACRO::DrawApertureMacroShape( GERBER_DRAW_ITEM* aParent,
                                              wxPoint aShapePos, bool aFilledShape )
 {
     SHAPE_POLY_SET shapeBuffer;
-    SHAPE_POLY_SET holeBuffer;
-    bool hasHole = false;
-
-    for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
-         prim_macro != primitives.end(); ++prim_macro )
-    {
-        if( prim_macro->IsAMPrimitiveExposureOn( aParent ) )
-            prim_macro->DrawBasicShape( aParent, shapeBuffer, aShapePos );
-        else
-        {
-            prim_macro->DrawBasicShape( aParent, holeBuffer, aShapePos );
 
-            if( holeBuffer.OutlineCount() )     // we have a new hole in shape: remove the hole
-            {
-                shapeBuffer.BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
-                holeBuffer.RemoveAllContours();
-                hasHole = true;
-            }
-        }
-    }
+    TransformShapeToPolygon( aParent, shapeBuffer, aShapePos );
 
     if( shapeBuffer.OutlineCount() == 0 )
         return;
 
     // If a hole is defined inside a polygon, we must fracture the polygon
     // to be able to drawn it (i.e link holes by overlapping edges)
-    if( hasHole )
+    if( shapeBuffer.HasHoles() )
         shapeBuffer.Fracture( SHAPE_POLY_SET::PM_FAST );
 
     for( int ii = 0; ii < shapeBuffer.OutlineCount(); ii++ )
@@ -820,6 +827,28 @@ int APERTURE_MACRO::GetShapeDim( GERBER_DRAW_ITEM* aParent )
 }
 
 
+EDA_RECT APERTURE_MACRO::GetBoundingBox( const GERBER_DRAW_ITEM* aParent,
+                                         const wxPoint& aShapePos )
+{
+    SHAPE_POLY_SET shapeBuffer;
+
+    for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
+         prim_macro != primitives.end(); ++prim_macro )
+    {
+        if( prim_macro->IsAMPrimitiveExposureOn( aParent ) )
+            prim_macro->DrawBasicShape( aParent, shapeBuffer, aShapePos );
+    }
+
+    if( shapeBuffer.OutlineCount() == 0 )
+        return EDA_RECT( aParent->GetABPosition( aShapePos ), wxSize( 1, 1 ) );
+
+    BOX2I bbox = shapeBuffer.BBox();
+
+    return EDA_RECT( wxPoint( bbox.GetX(), bbox.GetY() ),
+                     wxSize( bbox.GetWidth() + 1, bbox.GetHeight() + 1 ) );
+}
+
+
 /**
  * function GetLocalParam
  * Usually, parameters are defined inside the aperture primitive
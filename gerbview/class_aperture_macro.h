@@ -113,7 +113,7 @@ public: AM_PRIMITIVE( bool aGerbMetric, AM_PRIMITIVE_ID aId = AMP_UNKNOWN )
      * In a aperture macro shape, a basic primitive with exposure off is a hole in the shape
      * it is NOT a negative shape
      */
-    bool  IsAMPrimitiveExposureOn( GERBER_DRAW_ITEM* aParent ) const;
+    bool  IsAMPrimitiveExposureOn( const GERBER_DRAW_ITEM* aParent ) const;
 
     /* Draw functions: */
 
@@ -136,7 +136,7 @@ public: AM_PRIMITIVE( bool aGerbMetric, AM_PRIMITIVE_ID aId = AMP_UNKNOWN )
      * @param aShapeBuffer = a SHAPE_POLY_SET to put the shape converted to a polygon
      * @param aShapePos = the actual shape position
      */
-    void DrawBasicShape( GERBER_DRAW_ITEM* aParent, SHAPE_POLY_SET& aShapeBuffer,
+    void DrawBasicShape( const GERBER_DRAW_ITEM* aParent, SHAPE_POLY_SET& aShapeBuffer,
                          wxPoint aShapePos );
 private:
 
@@ -147,7 +147,7 @@ private:
      * Useful when a shape is not a graphic primitive (shape with hole,
      * rotated shape ... ) and cannot be easily drawn.
      */
-    void ConvertShapeToPolygon( GERBER_DRAW_ITEM* aParent, std::vector<wxPoint>& aBuffer );
+    void ConvertShapeToPolygon( const GERBER_DRAW_ITEM* aParent, std::vector<wxPoint>& aBuffer );
 };
 
 
@@ -197,6 +197,18 @@ struct APERTURE_MACRO
     void DrawApertureMacroShape( GERBER_DRAW_ITEM* aParent, EDA_RECT* aClipBox, wxDC* aDC,
                                  COLOR4D aColor, wxPoint aShapePos, bool aFilledShape );
 
+    /**
+     * Function TransformShapeToPolygon
+     * converts the shape flashed at aShapePos to polygons, in draw (AB) axis.
+     * The primitives with exposure off are removed from the shape, so the polygons
+     * can have holes.
+     * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
+     * @param aShapeBuffer = a SHAPE_POLY_SET to put the shape converted to polygons
+     * @param aShapePos = the actual shape position
+     */
+    void TransformShapeToPolygon( const GERBER_DRAW_ITEM* aParent,
+                                  SHAPE_POLY_SET& aShapeBuffer, const wxPoint& aShapePos );
+
     /**
      * Function GetShapeDim
      * Calculate a value that can be used to evaluate the size of text
@@ -210,6 +222,15 @@ struct APERTURE_MACRO
      * @return a dimension, or -1 if no dim to calculate
      */
     int  GetShapeDim( GERBER_DRAW_ITEM* aParent );
+
+    /**
+     * Function GetBoundingBox
+     * @return the bounding box of the shape flashed at aShapePos, in draw (AB) axis.
+     * Holes are ignored: they are always inside the shape.
+     * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
+     * @param aShapePos = the actual shape position
+     */
+    EDA_RECT GetBoundingBox( const GERBER_DRAW_ITEM* aParent, const wxPoint& aShapePos );
 };
 
 
@@ -76,16 +76,19 @@ EDA_RECT GBR_LAYOUT::ComputeBoundingBox()
         if( gerber == NULL )    // Graphic layer not yet used
             continue;
 
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
+        // The items index knows the bounding box of all its items
+        GERBER_ITEMS_INDEX& index = gerber->GetItemsIndex();
+
+        if( index.GetCount() == 0 )
+            continue;
+
+        if( first_item )
         {
-            if( first_item )
-            {
-                bbox = item->GetBoundingBox();
-                first_item = false;
-            }
-            else
-                bbox.Merge( item->GetBoundingBox() );
+            bbox = index.GetBoundingBox();
+            first_item = false;
         }
+        else
+            bbox.Merge( index.GetBoundingBox() );
     }
 
     SetBoundingBox( bbox );
@@ -179,6 +182,15 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
 
     bool doBlit = false; // this flag requests an image transfer to actual screen when true.
 
+    // Items smaller than this size (one pixel, in internal units) are drawn as a dot.
+    // Not when printing: the printer resolution is much better than the screen resolution.
+    int dotSize = 0;
+
+    if( !aDisplayOptions->m_IsPrinting && scale > 0.0 )
+        dotSize = KiROUND( 1.0 / scale );
+
+    std::vector<const GERBER_ITEMS_INDEX::ENTRY*> drawnItems;
+
     bool end = false;
 
     // Draw graphic layers from bottom to top, and the active layer is on the top of others.
@@ -285,10 +297,22 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
         if( aDrawMode == GR_OR && !gerber->HasNegativeItems() )
             layerdrawMode = GR_OR;
 
+        // Only the items inside the screen are drawn, in file order.  When printing, the
+        // clip box is not the printed area, so all items are drawn.
+        GERBER_ITEMS_INDEX& index = gerber->GetItemsIndex();
+
+        if( aDisplayOptions->m_IsPrinting )
+            index.Query( index.GetBoundingBox(), drawnItems );
+        else
+            index.Query( drawBox, drawnItems );
+
         // Now we can draw the current layer to the bitmap buffer
         // When needed, the previous bitmap is already copied to the screen buffer.
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
+        for( unsigned ii = 0; ii < drawnItems.size(); ++ii )
         {
+            GERBER_DRAW_ITEM* item = drawnItems[ii]->m_Item;
+            const EDA_RECT&   itemBox = drawnItems[ii]->m_BoundingBox;
+
             if( item->GetLayer() != layer )
                 continue;
 
@@ -309,7 +333,11 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
                 netHighlight == item->GetNetAttributes().m_Netname )
                 DrawModeAddHighlight( &drawMode);
 
-            item->Draw( aPanel, plotDC, drawMode, wxPoint(0,0), aDisplayOptions );
+            if( itemBox.GetWidth() < dotSize && itemBox.GetHeight() < dotSize )
+                item->DrawAsDot( aPanel, plotDC, drawMode, itemBox, aDisplayOptions );
+            else
+                item->Draw( aPanel, plotDC, drawMode, wxPoint(0,0), aDisplayOptions );
+
             doBlit = true;
         }
     }
@@ -370,6 +398,8 @@ void GBR_LAYOUT::DrawItemsDCodeID( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
     int         width;
     wxString    Line;
 
+    std::vector<const GERBER_ITEMS_INDEX::ENTRY*> drawnItems;
+
     GRSetDrawMode( aDC, aDrawMode );
 
     for( unsigned layer = 0; layer < GetImagesList()->ImagesMaxCount(); ++layer )
@@ -382,8 +412,11 @@ void GBR_LAYOUT::DrawItemsDCodeID( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
         if( ! gerber->m_IsVisible )
             continue;
 
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item != NULL; item = item->Next() )
+        gerber->GetItemsIndex().Query( *aPanel->GetClipBox(), drawnItems );
+
+        for( unsigned ii = 0; ii < drawnItems.size(); ++ii )
         {
+            GERBER_DRAW_ITEM* item = drawnItems[ii]->m_Item;
 
             if( item->m_DCode <= 0 )
                 continue;
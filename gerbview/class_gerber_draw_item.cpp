@@ -30,6 +30,8 @@
 #include <gr_basic.h>
 #include <common.h>
 #include <trigo.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/shape_poly_set.h>
 #include <class_drawpanel.h>
 #include <msgpanel.h>
 #include <gerbview_frame.h>
@@ -203,7 +205,7 @@ wxString GERBER_DRAW_ITEM::ShowGBRShape()
 }
 
 
-D_CODE* GERBER_DRAW_ITEM::GetDcodeDescr()
+D_CODE* GERBER_DRAW_ITEM::GetDcodeDescr() const
 {
     if( (m_DCode < FIRST_DCODE) || (m_DCode > LAST_DCODE) )
         return NULL;
@@ -220,18 +222,60 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
     // return a rectangle which is (pos,dim) in nature.  therefore the +1
     EDA_RECT bbox( m_Start, wxSize( 1, 1 ) );
 
-    bbox.Inflate( m_Size.x / 2, m_Size.y / 2 );
+    // The box must enclose all the drawn shape, because it is used to cull the items
+    // outside the screen (see GBR_LAYOUT::Draw()).  Calculate it in XY gerber axis first.
+    switch( m_Shape )
+    {
+    case GBR_POLYGON:
+        for( unsigned ii = 0; ii < m_PolyCorners.size(); ii++ )
+            bbox.Merge( m_PolyCorners[ii] );
+        break;
 
-    // calculate the corners coordinates in current gerber axis orientations
-    wxPoint org = GetABPosition( bbox.GetOrigin() );
-    wxPoint end = GetABPosition( bbox.GetEnd() );
+    case GBR_CIRCLE:
+        bbox.Inflate( KiROUND( GetLineLength( m_Start, m_End ) ) + m_Size.x / 2 );
+        break;
 
-    // Set the corners position:
-    bbox.SetOrigin( org );
-    bbox.SetEnd( end );
-    bbox.Normalize();
+    case GBR_ARC:
+        // The full circle: a bit larger than needed, but good enough
+        bbox = EDA_RECT( m_ArcCentre, wxSize( 1, 1 ) );
+        bbox.Inflate( KiROUND( GetLineLength( m_ArcCentre, m_Start ) ) + m_Size.x / 2 );
+        break;
+
+    case GBR_SEGMENT:
+        bbox.Merge( m_End );
+
+        // The pen can be a rectangle: use its half diagonal
+        bbox.Inflate( ( std::abs( m_Size.x ) + std::abs( m_Size.y ) ) / 2 );
+        break;
+
+    case GBR_SPOT_MACRO:
+    {
+        D_CODE* code = GetDcodeDescr();
 
-    return bbox;
+        // The macro shape is built in AB axis
+        if( code && code->GetMacro() )
+            return code->GetMacro()->GetBoundingBox( this, m_Start );
+    }
+        // Fall through
+    default:        // Other flashed shapes, possibly rotated
+        bbox.Inflate( ( std::abs( m_Size.x ) + std::abs( m_Size.y ) ) / 2 );
+        break;
+    }
+
+    // calculate the corners coordinates in current gerber axis orientations.
+    // The axis can be rotated, so all the 4 corners are needed
+    wxPoint corners[4] =
+    {
+        bbox.GetOrigin(), wxPoint( bbox.GetRight(), bbox.GetY() ),
+        bbox.GetEnd(), wxPoint( bbox.GetX(), bbox.GetBottom() )
+    };
+
+    EDA_RECT abBox( GetABPosition( corners[0] ), wxSize( 1, 1 ) );
+
+    for( int ii = 1; ii < 4; ii++ )
+        abBox.Merge( GetABPosition( corners[ii] ) );
+
+    return abBox;
 }
 
 
@@ -282,23 +326,11 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
     if( d_codeDescr == NULL )
         d_codeDescr = &dummyD_CODE;
 
-    COLOR4D color = m_GerberImageFile->GetPositiveDrawColor();
+    COLOR4D color = GetDrawColor( aDrawMode, aDrawOptions );
 
-    if( ( aDrawMode & GR_HIGHLIGHT ) && !( aDrawMode & GR_AND ) )
-        color.SetToLegacyHighlightColor();
-
-    /* isDark is true if flash is positive and should use a drawing
-     *   color other than the background color, else use the background color
-     *   when drawing so that an erasure happens.
-     */
+    // isDark is true if flash is positive, see GetDrawColor()
     bool isDark = !(m_LayerNegative ^ m_GerberImageFile->m_ImageNegative);
 
-    if( !isDark )
-    {
-        // draw in background color ("negative" color)
-        color = aDrawOptions->m_NegativeDrawColor;
-    }
-
     GRSetDrawMode( aDC, aDrawMode );
 
     isFilled = aDrawOptions->m_DisplayLinesFill;
@@ -411,6 +443,42 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
 }
 
 
+COLOR4D GERBER_DRAW_ITEM::GetDrawColor( GR_DRAWMODE aDrawMode,
+                                        GBR_DISPLAY_OPTIONS* aDrawOptions ) const
+{
+    COLOR4D color = m_GerberImageFile->GetPositiveDrawColor();
+
+    if( ( aDrawMode & GR_HIGHLIGHT ) && !( aDrawMode & GR_AND ) )
+        color.SetToLegacyHighlightColor();
+
+    /* isDark is true if flash is positive and should use a drawing
+     *   color other than the background color, else use the background color
+     *   when drawing so that an erasure happens.
+     */
+    bool isDark = !(m_LayerNegative ^ m_GerberImageFile->m_ImageNegative);
+
+    if( !isDark )
+    {
+        // draw in background color ("negative" color)
+        color = aDrawOptions->m_NegativeDrawColor;
+    }
+
+    return color;
+}
+
+
+void GERBER_DRAW_ITEM::DrawAsDot( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
+                                  const EDA_RECT& aBoundingBox,
+                                  GBR_DISPLAY_OPTIONS* aDrawOptions )
+{
+    wxPoint center = aBoundingBox.Centre();
+
+    GRSetDrawMode( aDC, aDrawMode );
+    GRPutPixel( aPanel->GetClipBox(), aDC, center.x, center.y,
+                GetDrawColor( aDrawMode, aDrawOptions ) );
+}
+
+
 void GERBER_DRAW_ITEM::ConvertSegmentToPolygon( )
 {
     m_PolyCorners.clear();
@@ -475,6 +543,92 @@ void GERBER_DRAW_ITEM::ConvertSegmentToPolygon( )
 }
 
 
+#define SEGS_CNT 32     // number of segments to approximate a circle
+
+void GERBER_DRAW_ITEM::TransformShapeToPolygon( SHAPE_POLY_SET& aBuffer )
+{
+    D_CODE* code = GetDcodeDescr();
+
+    switch( m_Shape )
+    {
+    case GBR_POLYGON:
+        aBuffer.NewOutline();
+
+        for( unsigned ii = 0; ii < m_PolyCorners.size(); ii++ )
+        {
+            wxPoint corner = GetABPosition( m_PolyCorners[ii] );
+            aBuffer.Append( corner.x, corner.y );
+        }
+        break;
+
+    case GBR_CIRCLE:
+        TransformRingToPolygon( aBuffer, GetABPosition( m_Start ),
+                                KiROUND( GetLineLength( m_Start, m_End ) ), SEGS_CNT, m_Size.x );
+        break;
+
+    case GBR_ARC:
+    {
+        // The arc is drawn counterclockwise from start to end, see GRArc1()
+        wxPoint start  = GetABPosition( m_Start );
+        wxPoint end    = GetABPosition( m_End );
+        wxPoint centre = GetABPosition( m_ArcCentre );
+
+        double angle = ArcTangente( start.y - centre.y, start.x - centre.x )
+                       - ArcTangente( end.y - centre.y, end.x - centre.x );
+        NORMALIZE_ANGLE_POS( angle );
+
+        if( angle == 0 )    // same start and end points: a full circle
+            angle = 3600;
+
+        // A positive angle is clockwise in TransformArcToPolygon(): go from end to start
+        TransformArcToPolygon( aBuffer, centre, end, angle, SEGS_CNT, m_Size.x );
+    }
+        break;
+
+    case GBR_SEGMENT:
+        // Same pen shapes as Draw()
+        if( code && code->m_Shape == APT_RECT )
+        {
+            if( m_PolyCorners.size() == 0 )
+                ConvertSegmentToPolygon();
+
+            aBuffer.NewOutline();
+
+            for( unsigned ii = 0; ii < m_PolyCorners.size(); ii++ )
+            {
+                wxPoint corner = GetABPosition( m_PolyCorners[ii] );
+                aBuffer.Append( corner.x, corner.y );
+            }
+        }
+        else
+        {
+            TransformRoundedEndsSegmentToPolygon( aBuffer, GetABPosition( m_Start ),
+                                                  GetABPosition( m_End ), SEGS_CNT, m_Size.x );
+        }
+        break;
+
+    case GBR_SPOT_CIRCLE:
+    case GBR_SPOT_RECT:
+    case GBR_SPOT_OVAL:
+    case GBR_SPOT_POLY:
+    case GBR_SPOT_MACRO:
+        if( code )
+            code->TransformFlashedShapeToPolygon( this, aBuffer, m_Start );
+        else
+        {
+            // Same default shape as Draw(), but not static: items of several images can
+            // be converted concurrently
+            D_CODE dummyD_CODE( 0 );
+            dummyD_CODE.TransformFlashedShapeToPolygon( this, aBuffer, m_Start );
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
 void GERBER_DRAW_ITEM::DrawGbrPoly( EDA_RECT*      aClipBox,
                                     wxDC*          aDC,
                                     COLOR4D        aColor,
@@ -41,6 +41,7 @@ class GBR_LAYOUT;
 class D_CODE;
 class MSG_PANEL_ITEM;
 class GBR_DISPLAY_OPTIONS;
+class SHAPE_POLY_SET;
 
 
 /* Shapes id for basic shapes ( .m_Shape member ) */
@@ -201,7 +202,7 @@ public:
      * returns the GetDcodeDescr of this object, or NULL.
      * @return D_CODE* - a pointer to the DCode description (for flashed items).
      */
-    D_CODE* GetDcodeDescr();
+    D_CODE* GetDcodeDescr() const;
 
     const EDA_RECT GetBoundingBox() const override;
 
@@ -209,6 +210,22 @@ public:
     void Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
                GR_DRAWMODE aDrawMode, const wxPoint&aOffset, GBR_DISPLAY_OPTIONS* aDrawOptions );
 
+    /**
+     * Function DrawAsDot
+     * draws the item as a single dot, at the center of its bounding box.
+     * Used when the item is smaller than a pixel at the current zoom.
+     * @param aBoundingBox = the item bounding box, as returned by GetBoundingBox()
+     */
+    void DrawAsDot( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
+                    const EDA_RECT& aBoundingBox, GBR_DISPLAY_OPTIONS* aDrawOptions );
+
+    /**
+     * Function GetDrawColor
+     * @return the color used to draw the item: the layer color, its highlighted
+     * version, or the background color for negative items.
+     */
+    COLOR4D GetDrawColor( GR_DRAWMODE aDrawMode, GBR_DISPLAY_OPTIONS* aDrawOptions ) const;
+
     /**
      * Function ConvertSegmentToPolygon
      * convert a line to an equivalent polygon.
@@ -217,6 +234,15 @@ public:
      */
     void ConvertSegmentToPolygon();
 
+    /**
+     * Function TransformShapeToPolygon
+     * converts the shape of the item, as drawn, to polygons in draw (AB) axis.
+     * Arcs and circles are approximated by segments.  The polarity of the item is not
+     * used: the caller adds or removes the shape from the image.
+     * @param aBuffer = a SHAPE_POLY_SET to add the shape to
+     */
+    void TransformShapeToPolygon( SHAPE_POLY_SET& aBuffer );
+
     /**
      * Function DrawGbrPoly
      * a helper function used to draw the polygon stored in m_PolyCorners
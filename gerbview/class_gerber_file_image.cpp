@@ -126,6 +126,15 @@ GERBER_DRAW_ITEM * GERBER_FILE_IMAGE::GetItemsList()
     return m_Drawings;
 }
 
+
+GERBER_ITEMS_INDEX& GERBER_FILE_IMAGE::GetItemsIndex()
+{
+    if( !m_itemsIndex.IsBuilt() )
+        m_itemsIndex.Build( m_Drawings );
+
+    return m_itemsIndex;
+}
+
 D_CODE* GERBER_FILE_IMAGE::GetDCODE( int aDCODE, bool aCreateIfNoExist )
 {
     unsigned ndx = aDCODE - FIRST_DCODE;
@@ -173,6 +182,7 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
     m_MD5_value.Empty();                            // MD5 value found in a %TF.MD5 command
     m_PartString.Empty();                           // string found in a %TF.Part command
     m_hasNegativeItems    = -1;                     // set to uninitialized
+    m_itemsIndex.Clear();                           // will be rebuilt when drawn
     m_ImageJustifyOffset  = wxPoint(0,0);           // Image justify Offset
     m_ImageJustifyXCenter = false;                  // Image Justify Center on X axis (default = false)
     m_ImageJustifyYCenter = false;                  // Image Justify Center on Y axis (default = false)
@@ -31,6 +31,7 @@
 #include <dcode.h>
 #include <class_gerber_draw_item.h>
 #include <class_aperture_macro.h>
+#include <class_gerber_items_index.h>
 #include <gbr_netlist_metadata.h>
 
 // An useful macro used when reading gerber files;
@@ -178,6 +179,8 @@ private:
                                                                 // -1 = negative items are
                                                                 // 0 = no negative items found
                                                                 // 1 = have negative items found
+    GERBER_ITEMS_INDEX m_itemsIndex;                            // spatial index of m_Drawings, built when
+                                                                // the items are drawn
 
 public:
     GERBER_FILE_IMAGE( int layer );
@@ -211,6 +214,19 @@ public:
      */
     GERBER_DRAW_ITEM * GetItemsList();
 
+    /**
+     * Function GetItemsIndex
+     * @return the spatial index of the items list, (re)built if it was invalidated
+     */
+    GERBER_ITEMS_INDEX& GetItemsIndex();
+
+    /**
+     * Function InvalidateItemsIndex
+     * must be called when items are added, removed or moved, because the index cannot
+     * detect it.
+     */
+    void InvalidateItemsIndex() { m_itemsIndex.Clear(); }
+
     /**
      * Function GetLayerParams
      * @return the current layers params
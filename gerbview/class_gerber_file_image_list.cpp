@@ -33,11 +33,20 @@
 #include <gerbview_frame.h>
 #include <class_gerber_file_image.h>
 #include <class_gerber_file_image_list.h>
+#include <class_excellon.h>
 #include <class_X2_gerber_attributes.h>
+#include <common.h>
+#include <profile.h>
 
 #include <map>
 
 
+/**
+ * Trace mask to log the gerber and drill files loading times.
+ */
+static const wxChar traceGerberLoad[] = wxT( "KICAD_GERBER_LOAD" );
+
+
 // The global image list:
 GERBER_FILE_IMAGE_LIST s_GERBER_List;
 
@@ -99,6 +108,61 @@ int GERBER_FILE_IMAGE_LIST::AddGbrImage( GERBER_FILE_IMAGE* aGbrImage, int aIdx
 }
 
 
+std::vector<GERBER_FILE_IMAGE*> GERBER_FILE_IMAGE_LIST::LoadFiles(
+        const wxArrayString& aFileNames, const std::vector<bool>& aDrillFiles )
+{
+    wxASSERT( aFileNames.GetCount() == aDrillFiles.size() );
+
+    std::vector<GERBER_FILE_IMAGE*> images( aFileNames.GetCount(), NULL );
+    PROF_COUNTER timer;
+
+    // The locale is global: it is only safe to switch it here, before the threads are
+    // created.  The readers' own LOCALE_IO do nothing while this one exists.
+    LOCALE_IO toggle_locale;
+
+    // Each file is read in its own image, and the images do not share anything
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < (int) aFileNames.GetCount(); ++ii )
+    {
+        // The graphic layer is not known yet: it is set when the image is added to a list
+        GERBER_FILE_IMAGE* image;
+
+        if( aDrillFiles[ii] )
+            image = new EXCELLON_IMAGE( 0 );
+        else
+            image = new GERBER_FILE_IMAGE( 0 );
+
+        bool success;
+
+        // An exception must not leave the parallel loop: keep what was read, and the error
+        try
+        {
+            if( aDrillFiles[ii] )
+                success = static_cast<EXCELLON_IMAGE*>( image )->LoadFile( aFileNames[ii] );
+            else
+                success = image->LoadGerberFile( aFileNames[ii] );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            image->AddMessageToList( ioe.What() );
+            success = true;
+        }
+
+        if( success )
+            images[ii] = image;
+        else
+            delete image;
+    }
+
+    wxLogTrace( traceGerberLoad, wxT( "Read %u files in %.1f ms" ),
+                (unsigned) aFileNames.GetCount(), timer.msecs() );
+
+    return images;
+}
+
+
 void GERBER_FILE_IMAGE_LIST::DeleteAllImages()
 {
     for( unsigned idx = 0; idx < m_GERBER_List.size(); ++idx )
@@ -28,6 +28,8 @@
 #include <vector>
 #include <set>
 
+#include <wx/arrstr.h>
+
 #include <class_gerber_draw_item.h>
 #include <class_aperture_macro.h>
 
@@ -83,6 +85,19 @@ public:
      */
     int AddGbrImage( GERBER_FILE_IMAGE* aGbrImage, int aIdx );
 
+    /**
+     * Function LoadFiles
+     * reads Gerber and Excellon drill files concurrently, each one in a new image.
+     * The images are not added to any list: the caller adds them with AddGbrImage(), in
+     * the order it wants, or deletes them.
+     * @param aFileNames = the full file names
+     * @param aDrillFiles = for each file, true to read it as a Excellon drill file
+     * @return the images, in the aFileNames order.  An image is NULL if its file cannot
+     * be opened.  The other messages of the reader are in the image messages list.
+     */
+    static std::vector<GERBER_FILE_IMAGE*> LoadFiles( const wxArrayString& aFileNames,
+                                                      const std::vector<bool>& aDrillFiles );
+
 
     /**
      * remove all loaded data in list, and delete all images. Memory is freed
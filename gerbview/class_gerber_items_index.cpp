@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file class_gerber_items_index.cpp
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+
+#include <class_gerber_items_index.h>
+#include <class_gerber_draw_item.h>
+
+#include <algorithm>
+
+
+/**
+ * Trace mask to log the gerber items index build times.
+ */
+static const wxChar traceGerberItemsIndex[] = wxT( "KICAD_GERBER_ITEMS_INDEX" );
+
+
+GERBER_ITEMS_INDEX::GERBER_ITEMS_INDEX() :
+    m_built( false )
+{
+}
+
+
+void GERBER_ITEMS_INDEX::Clear()
+{
+    m_tree.RemoveAll();
+    m_entries.clear();
+    m_boundingBox = EDA_RECT();
+    m_built = false;
+}
+
+
+void GERBER_ITEMS_INDEX::Build( GERBER_DRAW_ITEM* aFirstItem )
+{
+    PROF_COUNTER timer;
+
+    Clear();
+
+    for( GERBER_DRAW_ITEM* item = aFirstItem; item; item = item->Next() )
+    {
+        ENTRY entry;
+
+        entry.m_Item = item;
+        entry.m_BoundingBox = item->GetBoundingBox();
+
+        if( m_entries.empty() )
+            m_boundingBox = entry.m_BoundingBox;
+        else
+            m_boundingBox.Merge( entry.m_BoundingBox );
+
+        const int mmin[2] = { entry.m_BoundingBox.GetX(), entry.m_BoundingBox.GetY() };
+        const int mmax[2] = { entry.m_BoundingBox.GetRight(), entry.m_BoundingBox.GetBottom() };
+
+        m_tree.Insert( mmin, mmax, (int) m_entries.size() );
+        m_entries.push_back( entry );
+    }
+
+    m_built = true;
+
+    wxLogTrace( traceGerberItemsIndex, wxT( "Indexed %u gerber items in %.1f ms" ),
+                (unsigned) m_entries.size(), timer.msecs() );
+}
+
+
+/**
+ * Collects the indexes of the found entries, see RTree::Search()
+ */
+struct GERBER_ITEMS_COLLECTOR
+{
+    std::vector<int>& m_found;
+
+    GERBER_ITEMS_COLLECTOR( std::vector<int>& aFound ) : m_found( aFound ) {}
+
+    bool operator()( int aIndex )
+    {
+        m_found.push_back( aIndex );
+        return true;
+    }
+};
+
+
+void GERBER_ITEMS_INDEX::Query( const EDA_RECT& aArea, std::vector<const ENTRY*>& aResult )
+{
+    aResult.clear();
+
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    // All the items are inside the area: no need to search the tree
+    if( area.Contains( m_boundingBox ) )
+    {
+        aResult.reserve( m_entries.size() );
+
+        for( unsigned ii = 0; ii < m_entries.size(); ii++ )
+            aResult.push_back( &m_entries[ii] );
+
+        return;
+    }
+
+    std::vector<int>        found;
+    GERBER_ITEMS_COLLECTOR  collector( found );
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    m_tree.Search( mmin, mmax, collector );
+
+    // Restore the file order
+    std::sort( found.begin(), found.end() );
+
+    aResult.reserve( found.size() );
+
+    for( unsigned ii = 0; ii < found.size(); ii++ )
+        aResult.push_back( &m_entries[found[ii]] );
+}
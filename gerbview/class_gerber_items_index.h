@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file class_gerber_items_index.h
+ * @brief Spatial index of the items of a gerber image, used to draw only visible items.
+ */
+
+#ifndef CLASS_GERBER_ITEMS_INDEX_H
+#define CLASS_GERBER_ITEMS_INDEX_H
+
+#include <vector>
+
+#include <class_eda_rect.h>
+#include <geometry/rtree.h>
+
+class GERBER_DRAW_ITEM;
+
+
+/**
+ * Class GERBER_ITEMS_INDEX
+ * is a R-tree of the draw items of a GERBER_FILE_IMAGE, with the bounding box of each item.
+ * A query returns the items in the file order, because a negative item erases only the
+ * items drawn before it.
+ */
+class GERBER_ITEMS_INDEX
+{
+public:
+    struct ENTRY
+    {
+        GERBER_DRAW_ITEM*   m_Item;
+        EDA_RECT            m_BoundingBox;      ///< in draw (AB) axis
+    };
+
+    GERBER_ITEMS_INDEX();
+
+    /**
+     * Function Build
+     * indexes the item list starting at aFirstItem.
+     */
+    void Build( GERBER_DRAW_ITEM* aFirstItem );
+
+    void Clear();
+
+    /**
+     * Function IsBuilt
+     * @return true if the index was built, and is not cleared since.  The index does not
+     * follow the items: it must be cleared when they are added, removed or moved.
+     */
+    bool IsBuilt() const { return m_built; }
+
+    /**
+     * Function Query
+     * finds the items whose bounding box intersects aArea.
+     * @param aResult = the found entries, in file order
+     */
+    void Query( const EDA_RECT& aArea, std::vector<const ENTRY*>& aResult );
+
+    /**
+     * Function GetBoundingBox
+     * @return the bounding box of all the items
+     */
+    const EDA_RECT& GetBoundingBox() const { return m_boundingBox; }
+
+    unsigned GetCount() const { return m_entries.size(); }
+
+private:
+    bool                        m_built;
+    std::vector<ENTRY>          m_entries;      // in file order
+    RTree<int, int, 2, double>  m_tree;         // indexes in m_entries
+    EDA_RECT                    m_boundingBox;
+};
+
+#endif  // CLASS_GERBER_ITEMS_INDEX_H
@@ -32,6 +32,9 @@
 #include <common.h>
 #include <class_drawpanel.h>
 #include <trigo.h>
+#include <macros.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/shape_poly_set.h>
 
 #include <gerbview_frame.h>
 #include <class_gerber_file_image.h>
@@ -429,6 +432,113 @@ void D_CODE::ConvertShapeToPolygon()
 }
 
 
+// A helper function for D_CODE::TransformFlashedShapeToPolygon().
+// Add a rectangle of size aSize centered on aCenter, in draw (AB) axis
+static void addABRectangle( const GERBER_DRAW_ITEM* aParent, SHAPE_POLY_SET& aBuffer,
+                            const wxPoint& aCenter, const wxSize& aSize )
+{
+    // The draw axis can be rotated: convert the 4 corners
+    wxPoint corners[4] =
+    {
+        wxPoint( -aSize.x / 2, -aSize.y / 2 ), wxPoint( aSize.x / 2, -aSize.y / 2 ),
+        wxPoint( aSize.x / 2, aSize.y / 2 ), wxPoint( -aSize.x / 2, aSize.y / 2 )
+    };
+
+    aBuffer.NewOutline();
+
+    for( int ii = 0; ii < 4; ii++ )
+    {
+        wxPoint corner = aParent->GetABPosition( aCenter + corners[ii] );
+        aBuffer.Append( corner.x, corner.y );
+    }
+}
+
+
+void D_CODE::TransformFlashedShapeToPolygon( const GERBER_DRAW_ITEM* aParent,
+                                             SHAPE_POLY_SET& aBuffer,
+                                             const wxPoint& aShapePos )
+{
+    SHAPE_POLY_SET shape;
+    wxPoint center = aParent->GetABPosition( aShapePos );
+
+    switch( m_Shape )
+    {
+    case APT_MACRO:
+        if( GetMacro() )
+            GetMacro()->TransformShapeToPolygon( aParent, aBuffer, aShapePos );
+
+        return;
+
+    case APT_CIRCLE:
+        TransformCircleToPolygon( shape, center, m_Size.x / 2, SEGS_CNT );
+        break;
+
+    case APT_RECT:
+        addABRectangle( aParent, shape, aShapePos, m_Size );
+        break;
+
+    case APT_OVAL:
+    {
+        wxPoint start = aShapePos;
+        wxPoint end   = aShapePos;
+        int width;
+
+        if( m_Size.x > m_Size.y )   // horizontal oval
+        {
+            int delta = (m_Size.x - m_Size.y) / 2;
+            start.x -= delta;
+            end.x   += delta;
+            width    = m_Size.y;
+        }
+        else   // vertical oval
+        {
+            int delta = (m_Size.y - m_Size.x) / 2;
+            start.y -= delta;
+            end.y   += delta;
+            width    = m_Size.x;
+        }
+
+        TransformRoundedEndsSegmentToPolygon( shape, aParent->GetABPosition( start ),
+                                              aParent->GetABPosition( end ),
+                                              SEGS_CNT, width );
+    }
+        break;
+
+    case APT_POLYGON:
+    {
+        // Same vertices as ConvertShapeToPolygon(): the first one is on X axis
+        int edges = Clamp( 3, m_EdgesCount, 12 );
+        double rotation = m_Rotation * 10;
+
+        shape.NewOutline();
+
+        for( int ii = 0; ii < edges; ii++ )
+        {
+            wxPoint corner( m_Size.x >> 1, 0 );
+            RotatePoint( &corner, ii * 3600.0 / edges - rotation );
+            corner = aParent->GetABPosition( aShapePos + corner );
+            shape.Append( corner.x, corner.y );
+        }
+    }
+        break;
+    }
+
+    if( m_DrillShape != APT_DEF_NO_HOLE && shape.OutlineCount() )
+    {
+        SHAPE_POLY_SET hole;
+
+        if( m_DrillShape == APT_DEF_ROUND_HOLE )
+            TransformCircleToPolygon( hole, center, m_Drill.x / 2, SEGS_CNT );
+        else
+            addABRectangle( aParent, hole, aShapePos, m_Drill );
+
+        shape.BooleanSubtract( hole, SHAPE_POLY_SET::PM_FAST );
+    }
+
+    aBuffer.Append( shape );
+}
+
+
 // The helper function for D_CODE::ConvertShapeToPolygon().
 // Add a hole to a polygon
 static void addHoleToPolygon( std::vector<wxPoint>& aBuffer,
@@ -39,6 +39,7 @@ using KIGFX::COLOR4D;
 
 class wxDC;
 class GERBER_DRAW_ITEM;
+class SHAPE_POLY_SET;
 
 
 /**
@@ -196,6 +197,17 @@ public:
                              EDA_RECT* aClipBox, wxDC* aDC, COLOR4D aColor,
                              bool aFilled, const wxPoint& aPosition );
 
+    /**
+     * Function TransformFlashedShapeToPolygon
+     * converts the dcode shape flashed at aShapePos to polygons, in draw (AB) axis.
+     * Unlike ConvertShapeToPolygon(), the hole, if any, is a true hole of the polygon.
+     * @param aParent = the flashed GERBER_DRAW_ITEM
+     * @param aBuffer = a SHAPE_POLY_SET to add the shape to
+     * @param aShapePos = the actual shape position
+     */
+    void TransformFlashedShapeToPolygon( const GERBER_DRAW_ITEM* aParent,
+                                         SHAPE_POLY_SET& aBuffer, const wxPoint& aShapePos );
+
     /**
      * Function ConvertShapeToPolygon
      * convert a shape to an equivalent polygon.
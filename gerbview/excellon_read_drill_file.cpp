@@ -64,7 +64,6 @@
 
 #include <fctsys.h>
 #include <common.h>
-#include <confirm.h>
 
 #include <gerbview.h>
 #include <gerbview_frame.h>
@@ -76,8 +75,6 @@
 
 #include <cmath>
 
-#include <html_messagebox.h>
-
 // Default format for dimensions: they are the default values, not the actual values
 // number of digits in mantissa:
 static const int fmtMantissaMM = 3;
@@ -157,45 +154,6 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
-{
-    wxString msg;
-    int layerId = getActiveLayer();      // current layer used in GerbView
-    GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
-    EXCELLON_IMAGE* drill_Layer = (EXCELLON_IMAGE*) images->GetGbrImage( layerId );
-
-    if( drill_Layer == NULL )
-    {
-        drill_Layer = new EXCELLON_IMAGE( layerId );
-        layerId = images->AddGbrImage( drill_Layer, layerId );
-    }
-
-    if( layerId < 0 )
-    {
-        DisplayError( this, _( "No room to load file" ) );
-        return false;
-    }
-
-    // Read the Excellon drill file:
-    bool success = drill_Layer->LoadFile( aFullFileName );
-
-    if( !success )
-    {
-        msg.Printf( _( "File %s not found" ), GetChars( aFullFileName ) );
-        DisplayError( this, msg );
-        return false;
-    }
-
-    // Display errors list
-    if( drill_Layer->GetMessages().size() > 0 )
-    {
-        HTML_MESSAGE_BOX dlg( this, _( "Error reading EXCELLON drill file" ) );
-        dlg.ListSet( drill_Layer->GetMessages() );
-        dlg.ShowModal();
-    }
-    return success;
-}
-
 /*
  * Read a EXCELLON file.
  * Gerber classes are used because there is likeness between Gerber files
@@ -220,6 +178,11 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     if( m_Current_File == NULL )
         return false;
 
+    // Read the file by large blocks.  The buffer must exist until the file is closed,
+    // so it is created before the reader.
+    std::vector<char> readBuffer( GERBER_FILE_READ_BUFSIZE );
+    setvbuf( m_Current_File, &readBuffer[0], _IOFBF, readBuffer.size() );
+
     m_FileName = aFullFileName;
 
     LOCALE_IO toggleIo;
@@ -293,6 +256,9 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    // The items were added while reading
+    InvalidateItemsIndex();
+
     m_InUse = true;
 
     return true;
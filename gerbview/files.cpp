@@ -39,6 +39,7 @@
 #include <gerbview_frame.h>
 #include <gerbview_id.h>
 #include <class_gerber_file_image.h>
+#include <class_gerber_file_image_list.h>
 #include <class_gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 
@@ -202,14 +203,6 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
         m_mruPath = currentPath;
     }
 
-    // Read gerber files: each file is loaded on a new GerbView layer
-    bool success = true;
-    int layer = getActiveLayer();
-
-    // Manage errors when loading files
-    wxString msg;
-    WX_STRING_REPORTER reporter( &msg );
-
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
         filename = filenamesList[ii];
@@ -217,39 +210,29 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
         if( !filename.IsAbsolute() )
             filename.SetPath( currentPath );
 
-        m_lastFileName = filename.GetFullPath();
+        filenamesList[ii] = filename.GetFullPath();
+    }
 
-        setActiveLayer( layer, false );
+    // Read gerber files: each file is loaded on a new GerbView layer
+    std::vector<bool> drillFiles( filenamesList.GetCount(), false );
+    std::vector<int> layers;
 
-        if( Read_GERBER_File( filename.GetFullPath() ) )
-        {
-            UpdateFileHistory( m_lastFileName );
+    // Manage errors when loading files
+    wxString msg;
+    WX_STRING_REPORTER reporter( &msg );
 
-            layer = getNextAvailableLayer( layer );
+    bool success = LoadListOfFiles( filenamesList, drillFiles, reporter, &layers );
 
-            if( layer == NO_AVAILABLE_LAYERS && ii < filenamesList.GetCount()-1 )
-            {
-                success = false;
-                reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
-
-                // Report the name of not loaded files:
-                ii += 1;
-                while( ii < filenamesList.GetCount() )
-                {
-                    filename = filenamesList[ii++];
-                    wxString txt;
-                    txt.Printf( MSG_NOT_LOADED,
-                                GetChars( filename.GetFullName() ) );
-                    reporter.Report( txt, REPORTER::RPT_ERROR );
-                }
-                break;
-            }
+    for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
+    {
+        if( layers[ii] == NO_AVAILABLE_LAYERS )
+            continue;
 
-            setActiveLayer( layer, false );
-        }
+        m_lastFileName = filenamesList[ii];
+        UpdateFileHistory( m_lastFileName );
     }
 
-    if( !success )
+    if( !msg.IsEmpty() )
     {
         HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
         mbox.ListSet( msg );
@@ -305,14 +288,6 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
         m_mruPath = currentPath;
     }
 
-    // Read Excellon drill files: each file is loaded on a new GerbView layer
-    bool success = true;
-    int layer = getActiveLayer();
-
-    // Manage errors when loading files
-    wxString msg;
-    WX_STRING_REPORTER reporter( &msg );
-
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
         filename = filenamesList[ii];
@@ -320,42 +295,33 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
         if( !filename.IsAbsolute() )
             filename.SetPath( currentPath );
 
-        m_lastFileName = filename.GetFullPath();
+        filenamesList[ii] = filename.GetFullPath();
+    }
 
-        setActiveLayer( layer, false );
+    // Read Excellon drill files: each file is loaded on a new GerbView layer
+    std::vector<bool> drillFiles( filenamesList.GetCount(), true );
+    std::vector<int> layers;
 
-        if( Read_EXCELLON_File( filename.GetFullPath() ) )
-        {
-            // Update the list of recent drill files.
-            UpdateFileHistory( filename.GetFullPath(),  &m_drillFileHistory );
+    // Manage errors when loading files
+    wxString msg;
+    WX_STRING_REPORTER reporter( &msg );
 
-            layer = getNextAvailableLayer( layer );
+    bool success = LoadListOfFiles( filenamesList, drillFiles, reporter, &layers );
 
-            if( layer == NO_AVAILABLE_LAYERS && ii < filenamesList.GetCount()-1 )
-            {
-                success = false;
-                reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
-
-                // Report the name of not loaded files:
-                ii += 1;
-                while( ii < filenamesList.GetCount() )
-                {
-                    filename = filenamesList[ii++];
-                    wxString txt;
-                    txt.Printf( MSG_NOT_LOADED,
-                                GetChars( filename.GetFullName() ) );
-                    reporter.Report( txt, REPORTER::RPT_ERROR );
-                }
-                break;
-            }
+    for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
+    {
+        if( layers[ii] == NO_AVAILABLE_LAYERS )
+            continue;
 
-            setActiveLayer( layer, false );
-        }
+        m_lastFileName = filenamesList[ii];
+
+        // Update the list of recent drill files.
+        UpdateFileHistory( m_lastFileName, &m_drillFileHistory );
     }
 
-    if( !success )
+    if( !msg.IsEmpty() )
     {
-        HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
+        HTML_MESSAGE_BOX mbox( this, _( "Error reading EXCELLON drill file" ) );
         mbox.ListSet( msg );
         mbox.ShowModal();
     }
@@ -372,6 +338,110 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 }
 
 
+bool GERBVIEW_FRAME::LoadListOfFiles( const wxArrayString& aFileNames,
+                                      const std::vector<bool>& aDrillFiles,
+                                      REPORTER& aReporter, std::vector<int>* aLayers,
+                                      const wxArrayString* aImageNames )
+{
+    wxString msg;
+    bool success = true;
+    bool no_more_layer = false;
+    bool reported_no_more_layer = false;
+
+    if( aLayers )
+        aLayers->assign( aFileNames.GetCount(), NO_AVAILABLE_LAYERS );
+
+    // The files are read concurrently, but the images are put on the graphic layers
+    // in the list order, so the result does not depend on the read times.
+    std::vector<GERBER_FILE_IMAGE*> images = GERBER_FILE_IMAGE_LIST::LoadFiles( aFileNames,
+                                                                                aDrillFiles );
+
+    for( unsigned ii = 0; ii < images.size(); ii++ )
+    {
+        wxString imageName = aImageNames ? (*aImageNames)[ii] : aFileNames[ii];
+        wxFileName filename( imageName );
+        GERBER_FILE_IMAGE* image = images[ii];
+
+        if( image == NULL )
+        {
+            success = false;
+            msg.Printf( _( "<b>File '%s' not found</b>\n" ), GetChars( imageName ) );
+            aReporter.Report( msg, REPORTER::RPT_ERROR );
+            continue;
+        }
+
+        // A Gerber file replaces the image of the active layer, as it did when the files were
+        // read one at a time.  A drill file does not replace an image.
+        int layer = NO_AVAILABLE_LAYERS;
+
+        if( !no_more_layer )
+            layer = aDrillFiles[ii] ? getNextAvailableLayer( getActiveLayer() ) : getActiveLayer();
+
+        if( layer == NO_AVAILABLE_LAYERS )
+        {
+            success = false;
+
+            if( !reported_no_more_layer )
+                aReporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+
+            reported_no_more_layer = true;
+
+            // Report the name of not loaded files:
+            msg.Printf( MSG_NOT_LOADED, GetChars( filename.GetFullName() ) );
+            aReporter.Report( msg, REPORTER::RPT_ERROR );
+
+            delete image;
+            continue;
+        }
+
+        if( GetGbrImage( layer ) )
+        {
+            SetCurItem( NULL );
+            GetImagesList()->DeleteImage( layer );
+        }
+
+        image->m_FileName = imageName;
+        image->m_GraphicLayer = layer;
+        GetImagesList()->AddGbrImage( image, layer );
+
+        if( aLayers )
+            (*aLayers)[ii] = layer;
+
+        // Display errors list
+        const wxArrayString& messages = image->GetMessages();
+
+        for( unsigned jj = 0; jj < messages.GetCount(); jj++ )
+        {
+            msg.Printf( wxT( "<i>%s:</i> %s\n" ), GetChars( filename.GetFullName() ),
+                        GetChars( messages[jj] ) );
+            aReporter.Report( msg, REPORTER::RPT_WARNING );
+        }
+
+        /* if the gerber file is only a RS274D file
+         * (i.e. without any aperture information), warn the user:
+         */
+        if( !aDrillFiles[ii] && !image->m_Has_DCode )
+        {
+            msg.Printf( _( "<i>%s:</i> Warning: this file has no D-Code definition. "
+                           "It is perhaps an old RS274D file, "
+                           "therefore the size of items is undefined\n" ),
+                        GetChars( filename.GetFullName() ) );
+            aReporter.Report( msg, REPORTER::RPT_WARNING );
+        }
+
+        // The next file goes on the next free layer
+        layer = getNextAvailableLayer( layer );
+
+        if( layer != NO_AVAILABLE_LAYERS )
+            setActiveLayer( layer, false );
+        else
+            no_more_layer = true;
+    }
+
+    return success;
+}
+
+
 bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aReporter )
 {
     wxString msg;
@@ -396,19 +466,18 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
     // Update the list of recent zip files.
     UpdateFileHistory( aFullFileName, &m_zipFileHistory );
 
-    // The unzipped file in only a temporary file. Give it a filename
+    // The unzipped files are only temporary files. Give them a filename
     // which cannot conflict with an usual filename.
-    // TODO: make Read_GERBER_File() and Read_EXCELLON_File() able to
-    // accept a stream, and avoid using a temp file.
-    wxFileName temp_fn( "$tempfile.tmp" );
-    temp_fn.MakeAbsolute( unzipDir );
-    wxString unzipped_tempfile = temp_fn.GetFullPath();
-
+    // TODO: make GERBER_FILE_IMAGE::LoadGerberFile() and EXCELLON_IMAGE::LoadFile() able to
+    // accept a stream, and avoid using temp files.
+    // All the files are extracted first, to be read concurrently by LoadListOfFiles().
+    wxArrayString tempfiles;
+    wxArrayString entryNames;
+    std::vector<bool> drillFiles;
 
     bool success = true;
     wxZipInputStream zipArchive( zipFile );
     wxZipEntry* entry;
-    bool reported_no_more_layer = false;
 
     while( ( entry = zipArchive.GetNextEntry() ) )
     {
@@ -416,6 +485,8 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
         wxFileName uzfn = fname;
         wxString curr_ext = uzfn.GetExt().Lower();
 
+        delete entry;
+
         // The archive contains Gerber and/or Excellon drill files. Use the right loader.
         // However it can contain a few other files (reports, pdf files...),
         // which will be skipped.
@@ -429,93 +500,53 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
             if( aReporter )
             {
                 msg.Printf( _( "Info: skip file <i>'%s'</i> (unknown type)\n" ),
-                            GetChars( entry->GetName() ) );
+                            GetChars( fname ) );
                 aReporter->Report( msg, REPORTER::RPT_WARNING );
             }
 
             continue;
         }
 
-        int layer = getActiveLayer();
+        wxFileName temp_fn( wxString::Format( wxT( "$tempfile%u.tmp" ),
+                                              (unsigned) tempfiles.GetCount() ) );
+        temp_fn.MakeAbsolute( unzipDir );
+        wxString unzipped_tempfile = temp_fn.GetFullPath();
 
-        if( layer == NO_AVAILABLE_LAYERS )
+        // Create the unzipped temporary file:
+        wxFFileOutputStream temporary_ofile( unzipped_tempfile );
+
+        if( temporary_ofile.Ok() )
+            temporary_ofile.Write( zipArchive );
+        else
         {
             success = false;
 
             if( aReporter )
             {
-                if( !reported_no_more_layer )
-                    aReporter->Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
-
-                reported_no_more_layer = true;
-
-                // Report the name of not loaded files:
-                msg.Printf( MSG_NOT_LOADED, GetChars( entry->GetName() ) );
+                msg.Printf( _( "<b>Unable to create temporary file '%s'</b>\n"),
+                            GetChars( unzipped_tempfile ) );
                 aReporter->Report( msg, REPORTER::RPT_ERROR );
             }
 
-            delete entry;
             continue;
         }
 
-        // Create the unzipped temporary file:
-        {
-            wxFFileOutputStream temporary_ofile( unzipped_tempfile );
-
-            if( temporary_ofile.Ok() )
-                temporary_ofile.Write( zipArchive );
-            else
-            {
-                success = false;
-
-                if( aReporter )
-                {
-                    msg.Printf( _( "<b>Unable to create temporary file '%s'</b>\n"),
-                                GetChars( unzipped_tempfile ) );
-                    aReporter->Report( msg, REPORTER::RPT_ERROR );
-                }
-            }
-        }
-
-        bool read_ok = true;
-
-        if( curr_ext[0] == 'g' || curr_ext == "pho" )
-        {
-            // Read gerber files: each file is loaded on a new GerbView layer
-            read_ok = Read_GERBER_File( unzipped_tempfile );
-        }
-        else // if( curr_ext == "drl" )
-        {
-            read_ok = Read_EXCELLON_File( unzipped_tempfile );
-        }
-
-        delete entry;
-
-        // The unzipped file is only a temporary file, delete it.
-        wxRemoveFile( unzipped_tempfile );
-
-        if( !read_ok )
-        {
-            success = false;
+        tempfiles.Add( unzipped_tempfile );
+        entryNames.Add( fname );
+        drillFiles.push_back( curr_ext == "drl" );
+    }
 
-            if( aReporter )
-            {
-                msg.Printf( _("<b>unzipped file %s read error</b>\n"),
-                            GetChars( unzipped_tempfile ) );
-                aReporter->Report( msg, REPORTER::RPT_ERROR );
-            }
-        }
-        else
-        {
-            GERBER_FILE_IMAGE* gerber_image = GetGbrImage( layer );
+    // The images are named from the archive entries, not from the temporary files
+    wxString ignored_msg;
+    WX_STRING_REPORTER dummy_reporter( &ignored_msg );
 
-            if( gerber_image )
-                gerber_image->m_FileName = fname;
+    if( !LoadListOfFiles( tempfiles, drillFiles, aReporter ? *aReporter : dummy_reporter,
+                          NULL, &entryNames ) )
+        success = false;
 
-            layer = getNextAvailableLayer( layer );
-            setActiveLayer( layer, false );
-        }
-    }
+    // The unzipped files are only temporary files, delete them.
+    for( unsigned ii = 0; ii < tempfiles.GetCount(); ii++ )
+        wxRemoveFile( tempfiles[ii] );
 
     return success;
 }
@@ -0,0 +1,445 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_compare.cpp
+ */
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+#include <reporter.h>
+#include <profile.h>
+#include <convert_to_biu.h>
+
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <gerber_compare.h>
+#include <class_gerber_file_image.h>
+#include <class_gerber_file_image_list.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+/**
+ * Trace mask to log the comparison times.
+ */
+static const wxChar traceGerberCompare[] = wxT( "KICAD_GERBER_COMPARE" );
+
+#define ITEMS_PER_TILE  200     // approximate count of items in a tile
+#define MAX_TILES       32      // max count of tiles in each direction
+#define MAX_REPORTED_REGIONS 50 // the other regions are only counted in the report
+
+
+GERBER_IMAGE_COMPARE::GERBER_IMAGE_COMPARE() :
+    m_diffArea( 0.0 )
+{
+}
+
+
+void GERBER_IMAGE_COMPARE::convertImage( GERBER_FILE_IMAGE* aImage, IMAGE_SHAPES& aShapes )
+{
+    aShapes.m_items.clear();
+    aShapes.m_negative = aImage->m_ImageNegative;
+
+    for( GERBER_DRAW_ITEM* item = aImage->GetItemsList(); item; item = item->Next() )
+    {
+        aShapes.m_items.push_back( ITEM_SHAPE() );
+        ITEM_SHAPE& shape = aShapes.m_items.back();
+
+        item->TransformShapeToPolygon( shape.m_Shape );
+
+        if( shape.m_Shape.OutlineCount() == 0 )
+        {
+            aShapes.m_items.pop_back();
+            continue;
+        }
+
+        shape.m_BoundingBox = shape.m_Shape.BBox();
+
+        // Same polarity as GERBER_DRAW_ITEM::GetDrawColor()
+        shape.m_Dark = !( item->GetLayerPolarity() ^ aImage->m_ImageNegative );
+    }
+}
+
+
+void GERBER_IMAGE_COMPARE::buildTile( const IMAGE_SHAPES& aShapes, const std::vector<int>& aItems,
+                                      const SHAPE_POLY_SET& aTile, SHAPE_POLY_SET& aResult )
+{
+    aResult.RemoveAllContours();
+
+    // The background of a negative image is drawn, see GBR_LAYOUT::Draw()
+    if( aShapes.m_negative )
+        aResult = aTile;
+
+    // The consecutive items of same polarity are added or removed in one operation
+    SHAPE_POLY_SET batch;
+    bool batchDark = true;
+
+    for( unsigned ii = 0; ii <= aItems.size(); ii++ )
+    {
+        const ITEM_SHAPE* item = ii < aItems.size() ? &aShapes.m_items[aItems[ii]] : NULL;
+
+        if( batch.OutlineCount() && ( !item || item->m_Dark != batchDark ) )
+        {
+            if( batchDark )
+                aResult.BooleanAdd( batch, SHAPE_POLY_SET::PM_FAST );
+            else
+                aResult.BooleanSubtract( batch, SHAPE_POLY_SET::PM_FAST );
+
+            batch.RemoveAllContours();
+        }
+
+        if( item )
+        {
+            batch.Append( item->m_Shape );
+            batchDark = item->m_Dark;
+        }
+    }
+
+    aResult.BooleanIntersection( aTile, SHAPE_POLY_SET::PM_FAST );
+}
+
+
+int GERBER_IMAGE_COMPARE::Compare( GERBER_FILE_IMAGE* aReference, GERBER_FILE_IMAGE* aOther,
+                                   double aMinArea )
+{
+    PROF_COUNTER timer;
+    IMAGE_SHAPES shapes[2];
+
+    m_regions.clear();
+    m_diff.RemoveAllContours();
+    m_diffArea = 0.0;
+
+    // The images do not share anything
+#ifdef USE_OPENMP
+    #pragma omp parallel for
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < 2; ii++ )
+        convertImage( ii == 0 ? aReference : aOther, shapes[ii] );
+
+    // The compared area encloses the items of both images
+    BOX2I area;
+    bool  emptyArea = true;
+
+    for( int ii = 0; ii < 2; ii++ )
+    {
+        for( unsigned jj = 0; jj < shapes[ii].m_items.size(); jj++ )
+        {
+            if( emptyArea )
+                area = shapes[ii].m_items[jj].m_BoundingBox;
+            else
+                area.Merge( shapes[ii].m_items[jj].m_BoundingBox );
+
+            emptyArea = false;
+        }
+    }
+
+    if( emptyArea )
+        return 0;
+
+    // Split the area in tiles of about ITEMS_PER_TILE items, which are computed concurrently
+    unsigned itemCount = shapes[0].m_items.size() + shapes[1].m_items.size();
+    int tileCount = Clamp( 1, KiROUND( sqrt( (double) itemCount / ITEMS_PER_TILE ) ),
+                           MAX_TILES );
+    int tileWidth  = area.GetWidth() / tileCount + 1;
+    int tileHeight = area.GetHeight() / tileCount + 1;
+
+    // The items of each tile, in file order
+    std::vector< std::vector<int> > tileItems[2];
+
+    for( int ii = 0; ii < 2; ii++ )
+    {
+        tileItems[ii].resize( tileCount * tileCount );
+
+        for( unsigned jj = 0; jj < shapes[ii].m_items.size(); jj++ )
+        {
+            const BOX2I& bbox = shapes[ii].m_items[jj].m_BoundingBox;
+
+            int firstCol = Clamp( 0, ( bbox.GetX() - area.GetX() ) / tileWidth, tileCount - 1 );
+            int lastCol  = Clamp( 0, ( bbox.GetRight() - area.GetX() ) / tileWidth,
+                                  tileCount - 1 );
+            int firstRow = Clamp( 0, ( bbox.GetY() - area.GetY() ) / tileHeight, tileCount - 1 );
+            int lastRow  = Clamp( 0, ( bbox.GetBottom() - area.GetY() ) / tileHeight,
+                                  tileCount - 1 );
+
+            for( int row = firstRow; row <= lastRow; row++ )
+            {
+                for( int col = firstCol; col <= lastCol; col++ )
+                    tileItems[ii][row * tileCount + col].push_back( jj );
+            }
+        }
+    }
+
+    std::vector<SHAPE_POLY_SET> tileDiffs( tileCount * tileCount );
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int tile = 0; tile < tileCount * tileCount; tile++ )
+    {
+        int x = area.GetX() + ( tile % tileCount ) * tileWidth;
+        int y = area.GetY() + ( tile / tileCount ) * tileHeight;
+
+        SHAPE_POLY_SET tileRect;
+        tileRect.NewOutline();
+        tileRect.Append( x, y );
+        tileRect.Append( x + tileWidth, y );
+        tileRect.Append( x + tileWidth, y + tileHeight );
+        tileRect.Append( x, y + tileHeight );
+
+        SHAPE_POLY_SET reference;
+        SHAPE_POLY_SET other;
+
+        buildTile( shapes[0], tileItems[0][tile], tileRect, reference );
+        buildTile( shapes[1], tileItems[1][tile], tileRect, other );
+
+        // The XOR of the tile images: ( reference - other ) + ( other - reference )
+        SHAPE_POLY_SET& diff = tileDiffs[tile];
+
+        diff = reference;
+        diff.BooleanSubtract( other, SHAPE_POLY_SET::PM_FAST );
+        other.BooleanSubtract( reference, SHAPE_POLY_SET::PM_FAST );
+        diff.BooleanAdd( other, SHAPE_POLY_SET::PM_FAST );
+    }
+
+    // Join the regions split by the tile borders
+    for( unsigned ii = 0; ii < tileDiffs.size(); ii++ )
+        m_diff.Append( tileDiffs[ii] );
+
+    m_diff.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    for( int ii = 0; ii < m_diff.OutlineCount(); ii++ )
+    {
+        double regionArea = std::abs( m_diff.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < m_diff.HoleCount( ii ); jj++ )
+            regionArea -= std::abs( m_diff.CHole( ii, jj ).Area() );
+
+        if( regionArea <= 0.0 || regionArea < aMinArea )
+            continue;
+
+        BOX2I bbox = m_diff.COutline( ii ).BBox();
+        DIFF_REGION region;
+
+        region.m_BoundingBox = EDA_RECT( wxPoint( bbox.GetX(), bbox.GetY() ),
+                                         wxSize( bbox.GetWidth(), bbox.GetHeight() ) );
+        region.m_Area = regionArea;
+
+        m_regions.push_back( region );
+        m_diffArea += regionArea;
+    }
+
+    std::sort( m_regions.begin(), m_regions.end(),
+               []( const DIFF_REGION& a, const DIFF_REGION& b )
+               {
+                   return a.m_Area > b.m_Area;
+               } );
+
+    wxLogTrace( traceGerberCompare, wxT( "Compared %u items in %d tiles in %.1f ms" ),
+                itemCount, tileCount * tileCount, timer.msecs() );
+
+    return m_regions.size();
+}
+
+
+/**
+ * @return true if aFileName is a gerber or drill file, from its extension.  Same rules as
+ * the zip archive loader, see GERBVIEW_FRAME::unarchiveFiles()
+ */
+static bool isGerberFile( const wxFileName& aFileName )
+{
+    wxString ext = aFileName.GetExt().Lower();
+
+    return ( !ext.IsEmpty() && ext[0] == 'g' ) || ext == "pho" || ext == "drl";
+}
+
+
+/**
+ * Finds the gerber files of aReferenceDir which are also in aOtherDir, and reports the
+ * files found only in one directory.
+ * @return true if both directories have the same gerber files
+ */
+static bool matchDirectoryFiles( const wxString& aReferenceDir, const wxString& aOtherDir,
+                                 wxArrayString& aReferences, wxArrayString& aOthers,
+                                 REPORTER& aReporter )
+{
+    bool success = true;
+    wxArrayString files;
+
+    wxDir::GetAllFiles( aReferenceDir, &files, wxEmptyString, wxDIR_FILES );
+    files.Sort();
+
+    for( unsigned ii = 0; ii < files.GetCount(); ii++ )
+    {
+        wxFileName reference( files[ii] );
+
+        if( !isGerberFile( reference ) )
+            continue;
+
+        wxFileName other( aOtherDir, reference.GetFullName() );
+
+        if( !other.FileExists() )
+        {
+            aReporter.Report( wxString::Format( _( "%s: missing in '%s'." ),
+                                                GetChars( reference.GetFullName() ),
+                                                GetChars( aOtherDir ) ),
+                              REPORTER::RPT_ERROR );
+            success = false;
+            continue;
+        }
+
+        aReferences.Add( reference.GetFullPath() );
+        aOthers.Add( other.GetFullPath() );
+    }
+
+    files.Clear();
+    wxDir::GetAllFiles( aOtherDir, &files, wxEmptyString, wxDIR_FILES );
+    files.Sort();
+
+    for( unsigned ii = 0; ii < files.GetCount(); ii++ )
+    {
+        wxFileName other( files[ii] );
+
+        if( isGerberFile( other )
+            && !wxFileName( aReferenceDir, other.GetFullName() ).FileExists() )
+        {
+            aReporter.Report( wxString::Format( _( "%s: missing in '%s'." ),
+                                                GetChars( other.GetFullName() ),
+                                                GetChars( aReferenceDir ) ),
+                              REPORTER::RPT_ERROR );
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+
+bool CompareGerberFiles( const wxString& aReference, const wxString& aOther, double aMinArea,
+                         REPORTER& aReporter )
+{
+    wxArrayString references;
+    wxArrayString others;
+    bool success = true;
+
+    if( wxDirExists( aReference ) && wxDirExists( aOther ) )
+    {
+        success = matchDirectoryFiles( aReference, aOther, references, others, aReporter );
+    }
+    else if( wxFileExists( aReference ) && wxFileExists( aOther ) )
+    {
+        references.Add( aReference );
+        others.Add( aOther );
+    }
+    else
+    {
+        aReporter.Report( wxString::Format( _( "'%s' and '%s' must be two files or two "
+                                               "directories." ),
+                                            GetChars( aReference ), GetChars( aOther ) ),
+                          REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    // All the files are read at once, concurrently
+    wxArrayString fileNames;
+    std::vector<bool> drillFiles;
+
+    for( unsigned ii = 0; ii < references.GetCount(); ii++ )
+    {
+        fileNames.Add( references[ii] );
+        fileNames.Add( others[ii] );
+
+        // Same rule as GERBVIEW_FRAME::OpenProjectFiles(): .drl files are drill files
+        bool drill = wxFileName( references[ii] ).GetExt().Lower() == "drl";
+        drillFiles.push_back( drill );
+        drillFiles.push_back( drill );
+    }
+
+    std::vector<GERBER_FILE_IMAGE*> images = GERBER_FILE_IMAGE_LIST::LoadFiles( fileNames,
+                                                                                drillFiles );
+    GERBER_IMAGE_COMPARE compare;
+
+    for( unsigned ii = 0; ii < references.GetCount(); ii++ )
+    {
+        GERBER_FILE_IMAGE* reference = images[2 * ii];
+        GERBER_FILE_IMAGE* other = images[2 * ii + 1];
+        wxString name = wxFileName( references[ii] ).GetFullName();
+
+        if( !reference || !other )
+        {
+            aReporter.Report( wxString::Format( _( "%s: file '%s' cannot be read." ),
+                                                GetChars( name ),
+                                                GetChars( reference ? others[ii]
+                                                                    : references[ii] ) ),
+                              REPORTER::RPT_ERROR );
+            success = false;
+            continue;
+        }
+
+        int count = compare.Compare( reference, other, aMinArea * IU_PER_MM * IU_PER_MM );
+
+        if( count == 0 )
+        {
+            aReporter.Report( wxString::Format( _( "%s: no difference." ), GetChars( name ) ),
+                              REPORTER::RPT_INFO );
+            continue;
+        }
+
+        success = false;
+
+        aReporter.Report( wxString::Format( _( "%s: %d differing regions, %.6f mm2." ),
+                                            GetChars( name ), count,
+                                            compare.GetDiffArea() / IU_PER_MM / IU_PER_MM ),
+                          REPORTER::RPT_WARNING );
+
+        const std::vector<GERBER_IMAGE_COMPARE::DIFF_REGION>& regions = compare.GetRegions();
+
+        for( int jj = 0; jj < count && jj < MAX_REPORTED_REGIONS; jj++ )
+        {
+            const EDA_RECT& bbox = regions[jj].m_BoundingBox;
+
+            // The draw axis is top to bottom: report the lower left corner in gerber axis
+            aReporter.Report( wxString::Format( _( "    at (%.4f, %.4f) mm, size %.4f x %.4f mm, "
+                                                   "area %.6f mm2" ),
+                                                bbox.GetX() / IU_PER_MM,
+                                                -bbox.GetBottom() / IU_PER_MM,
+                                                bbox.GetWidth() / IU_PER_MM,
+                                                bbox.GetHeight() / IU_PER_MM,
+                                                regions[jj].m_Area / IU_PER_MM / IU_PER_MM ),
+                              REPORTER::RPT_WARNING );
+        }
+
+        if( count > MAX_REPORTED_REGIONS )
+            aReporter.Report( wxString::Format( _( "    and %d smaller regions" ),
+                                                count - MAX_REPORTED_REGIONS ),
+                              REPORTER::RPT_WARNING );
+    }
+
+    for( unsigned ii = 0; ii < images.size(); ii++ )
+        delete images[ii];
+
+    return success;
+}
@@ -0,0 +1,138 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_compare.h
+ * @brief Comparison of gerber images, using polygon boolean operations.
+ */
+
+#ifndef GERBER_COMPARE_H
+#define GERBER_COMPARE_H
+
+#include <vector>
+
+#include <wx/string.h>
+
+#include <class_eda_rect.h>
+#include <geometry/shape_poly_set.h>
+
+class GERBER_FILE_IMAGE;
+class REPORTER;
+
+
+/**
+ * Class GERBER_IMAGE_COMPARE
+ * computes the differences between two gerber images: the regions which are drawn
+ * in only one of them (the XOR of the images).
+ *
+ * Each item is converted to polygons, as it is drawn.  The images are then built in tiles,
+ * with the items in file order, so the negative items erase only the items drawn before
+ * them.  The tiles are independent, and are computed concurrently.
+ */
+class GERBER_IMAGE_COMPARE
+{
+public:
+    struct DIFF_REGION
+    {
+        EDA_RECT    m_BoundingBox;      ///< in draw (AB) axis
+        double      m_Area;             ///< in internal units squared
+    };
+
+    GERBER_IMAGE_COMPARE();
+
+    /**
+     * Function Compare
+     * computes the differences between aReference and aOther.
+     * @param aMinArea = the differing regions smaller than this area (in internal units
+     *                   squared) are ignored
+     * @return the count of differing regions
+     */
+    int Compare( GERBER_FILE_IMAGE* aReference, GERBER_FILE_IMAGE* aOther, double aMinArea );
+
+    /**
+     * Function GetRegions
+     * @return the differing regions found by the last Compare(), sorted by decreasing area
+     */
+    const std::vector<DIFF_REGION>& GetRegions() const { return m_regions; }
+
+    /**
+     * Function GetDiff
+     * @return the polygons of the differences found by the last Compare(), including the
+     * regions smaller than the minimum area
+     */
+    const SHAPE_POLY_SET& GetDiff() const { return m_diff; }
+
+    /**
+     * Function GetDiffArea
+     * @return the total area of the differing regions
+     */
+    double GetDiffArea() const { return m_diffArea; }
+
+private:
+    /// The polygons of an item, with its polarity
+    struct ITEM_SHAPE
+    {
+        SHAPE_POLY_SET  m_Shape;
+        BOX2I           m_BoundingBox;
+        bool            m_Dark;         ///< false for negative items, which erase the image
+    };
+
+    struct IMAGE_SHAPES
+    {
+        std::vector<ITEM_SHAPE> m_items;    ///< in file order
+        bool                    m_negative; ///< the image background is drawn
+    };
+
+    static void convertImage( GERBER_FILE_IMAGE* aImage, IMAGE_SHAPES& aShapes );
+
+    /**
+     * Builds the image of aShapes inside aTile, from the items of aItems.
+     */
+    static void buildTile( const IMAGE_SHAPES& aShapes, const std::vector<int>& aItems,
+                           const SHAPE_POLY_SET& aTile, SHAPE_POLY_SET& aResult );
+
+    std::vector<DIFF_REGION>    m_regions;
+    SHAPE_POLY_SET              m_diff;
+    double                      m_diffArea;
+};
+
+
+/**
+ * Function CompareGerberFiles
+ * compares the gerber and drill files of aReference with the ones of aOther, and reports
+ * the differing regions and their area.  aReference and aOther are two files, or two
+ * directories: the files of the directories are matched by name.
+ *
+ * It is exported by the gerbview kiface (see KIFACE_COMPARE_GERBER_FILES) for the
+ * gerbview_compare command line launcher.  It needs neither a program (Pgm()) nor a frame.
+ * @param aMinArea = the differing regions smaller than this area, in mm squared, are ignored
+ * @return true if the files are the same
+ */
+bool CompareGerberFiles( const wxString& aReference, const wxString& aOther, double aMinArea,
+                         REPORTER& aReporter );
+
+/// The type of CompareGerberFiles(), as returned by KIFACE::IfaceOrAddress()
+typedef bool GERBER_FILES_COMPARER( const wxString& aReference, const wxString& aOther,
+                                    double aMinArea, REPORTER& aReporter );
+
+#endif  // GERBER_COMPARE_H
@@ -28,12 +28,14 @@
 
 #include <fctsys.h>
 #include <kiface_i.h>
+#include <kiface_ids.h>
 #include <pgm_base.h>
 #include <class_drawpanel.h>
 
 #include <gerbview.h>
 #include <hotkeys.h>
 #include <gerbview_frame.h>
+#include <gerber_compare.h>
 
 // Colors for layers and items
 COLORS_DESIGN_SETTINGS g_ColorsSettings;
@@ -96,7 +98,14 @@ static struct IFACE : public KIFACE_I
      */
     void* IfaceOrAddress( int aDataId ) override
     {
-        return NULL;
+        switch( aDataId )
+        {
+        case KIFACE_COMPARE_GERBER_FILES:
+            return (void*) &CompareGerberFiles;
+
+        default:
+            return NULL;
+        }
     }
 
 } kiface( "gerbview", KIWAY::FACE_GERBVIEW );
@@ -38,6 +38,9 @@
 */
 #define GERBER_BUFZ     4000
 
+// Size of the stdio buffer used to read gerber and drill files
+#define GERBER_FILE_READ_BUFSIZE ( 256 * 1024 )
+
 /// List of page sizes
 extern const wxChar* g_GerberPageSizeList[8];
 
@@ -0,0 +1,128 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerbview_compare.cpp
+ * @brief A command line launcher comparing gerber files, for instance regenerated files
+ * with released ones.
+ *
+ * The comparison itself (see gerber_compare.h) is done by the gerbview kiface, without
+ * any window.  The exit code is 0 when the files are the same, 1 when they differ, and 2
+ * when the comparison cannot be run.
+ */
+
+#include <fctsys.h>
+#include <kiway.h>
+#include <kiface_ids.h>
+#include <batch_launcher.h>
+#include <gerber_compare.h>
+
+#include <wx/app.h>
+#include <wx/cmdline.h>
+
+
+class GERBVIEW_COMPARE : public wxAppConsole
+{
+public:
+    GERBVIEW_COMPARE() : m_minArea( 0.0 ) {}
+
+    virtual int OnRun() override;
+    virtual void OnInitCmdLine( wxCmdLineParser& parser ) override;
+    virtual bool OnCmdLineParsed( wxCmdLineParser& parser ) override;
+
+private:
+    wxString m_reference;
+    wxString m_other;
+    double   m_minArea;     // in mm squared
+};
+
+
+static const wxCmdLineEntryDesc cmdLineDesc[] =
+{
+    { wxCMD_LINE_OPTION, "a", "min-area",
+        "ignore the differing regions smaller than this area, in mm2",
+        wxCMD_LINE_VAL_DOUBLE, 0 },
+    { wxCMD_LINE_PARAM, NULL, NULL, "reference_file_or_directory",
+        wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_MANDATORY },
+    { wxCMD_LINE_PARAM, NULL, NULL, "file_or_directory",
+        wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_MANDATORY },
+    { wxCMD_LINE_SWITCH, "h", NULL, "display this message",
+        wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_NONE }
+};
+
+
+wxIMPLEMENT_APP_CONSOLE( GERBVIEW_COMPARE );
+
+
+void GERBVIEW_COMPARE::OnInitCmdLine( wxCmdLineParser& parser )
+{
+    parser.SetDesc( cmdLineDesc );
+    parser.SetSwitchChars( "-" );
+}
+
+
+bool GERBVIEW_COMPARE::OnCmdLineParsed( wxCmdLineParser& parser )
+{
+    if( parser.GetParamCount() < 2 )
+    {
+        parser.Usage();
+        return false;
+    }
+
+    m_reference = parser.GetParam( 0 );
+    m_other = parser.GetParam( 1 );
+
+    if( parser.Found( "min-area", &m_minArea ) && m_minArea < 0.0 )
+    {
+        parser.Usage();
+        return false;
+    }
+
+    return true;
+}
+
+
+int GERBVIEW_COMPARE::OnRun()
+{
+    STDIO_REPORTER reporter;
+
+    KIFACE* kiface = LoadBatchKiface( wxT( "gerbview" ), reporter );
+
+    if( !kiface )
+        return 2;
+
+    GERBER_FILES_COMPARER* comparer =
+            (GERBER_FILES_COMPARER*) kiface->IfaceOrAddress( KIFACE_COMPARE_GERBER_FILES );
+
+    if( !comparer )
+    {
+        reporter.Report( _( "The kiface library does not export the gerber comparison." ),
+                         REPORTER::RPT_ERROR );
+        return 2;
+    }
+
+    bool same = comparer( m_reference, m_other, m_minArea, reporter );
+
+    return same ? 0 : 1;
+}
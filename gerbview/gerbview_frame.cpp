@@ -46,6 +46,8 @@
 #include <class_gerber_file_image.h>
 #include <class_gerber_file_image_list.h>
 #include <dialog_helpers.h>
+#include <reporter.h>
+#include <html_messagebox.h>
 #include <class_DCodeSelectionbox.h>
 #include <class_gerbview_layer_widget.h>
 
@@ -217,24 +219,49 @@ bool GERBVIEW_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
             return true;
         }
 
-        const unsigned limit = std::min( unsigned( aFileSet.size() ),
-                                         unsigned( GERBER_DRAWLAYERS_COUNT ) );
+        wxArrayString fileNames;
+        std::vector<bool> drillFiles;
 
-        int layer = 0;
-
-        for( unsigned i=0;  i<limit;  ++i, ++layer )
+        for( unsigned i = 0; i < aFileSet.size(); ++i )
         {
-            setActiveLayer( layer );
-
             // Try to guess the type of file by its ext
             // if it is .drl (Kicad files), it is a drill file
             wxFileName fn( aFileSet[i] );
-            wxString ext = fn.GetExt();
 
-            if( ext == "drl" )
-                LoadExcellonFiles( aFileSet[i] );
-            else
-                LoadGerberFiles( aFileSet[i] );
+            fileNames.Add( aFileSet[i] );
+            drillFiles.push_back( fn.GetExt() == "drl" );
+        }
+
+        // All the files are read at once, on the layers following the first one
+        setActiveLayer( 0, false );
+
+        wxString msg;
+        WX_STRING_REPORTER reporter( &msg );
+
+        std::vector<int> layers;
+
+        LoadListOfFiles( fileNames, drillFiles, reporter, &layers );
+
+        for( unsigned i = 0; i < fileNames.GetCount(); ++i )
+        {
+            if( layers[i] == NO_AVAILABLE_LAYERS )
+                continue;
+
+            m_lastFileName = fileNames[i];
+            UpdateFileHistory( m_lastFileName, drillFiles[i] ? &m_drillFileHistory : NULL );
+        }
+
+        // Synchronize layers tools with actual active layer:
+        ReFillLayerWidget();
+        setActiveLayer( getActiveLayer() );
+        m_LayersManager->UpdateLayerIcons();
+        syncLayerBox();
+
+        if( !msg.IsEmpty() )
+        {
+            HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
+            mbox.ListSet( msg );
+            mbox.ShowModal();
         }
     }
 
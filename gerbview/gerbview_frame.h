@@ -621,7 +621,6 @@ public:
      * @return true if file was opened successfully.
      */
     bool                LoadGerberFiles( const wxString& aFileName );
-    bool                Read_GERBER_File( const wxString&   GERBER_FullFileName );
 
     /**
      * function LoadExcellonFiles
@@ -632,7 +631,28 @@ public:
      * @return true if file was opened successfully.
      */
     bool                LoadExcellonFiles( const wxString& aFileName );
-    bool                Read_EXCELLON_File( const wxString& aFullFileName );
+
+    /**
+     * function LoadListOfFiles
+     * Load Gerber and drill files.  The files are read concurrently, and put on the graphic
+     * layers in the list order: a Gerber file replaces the image of the active layer, a drill
+     * file goes to the first free layer from the active layer.  After each file, the active
+     * layer is the next free layer; the remaining files are not loaded when there is none.
+     * @param aFileNames = the full file names
+     * @param aDrillFiles = for each file, true if it is an Excellon drill file
+     * @param aReporter = a REPORTER to collect the error messages and the messages of the
+     *                    files readers
+     * @param aLayers = if not NULL, receives the graphic layer of each file, or
+     *                  NO_AVAILABLE_LAYERS when it is not loaded
+     * @param aImageNames = if not NULL, the names given to the images and used in messages
+     *                      instead of the file names (for files extracted from an archive)
+     * @return true if all the files were loaded
+     */
+    bool                LoadListOfFiles( const wxArrayString& aFileNames,
+                                         const std::vector<bool>& aDrillFiles,
+                                         REPORTER& aReporter,
+                                         std::vector<int>* aLayers = NULL,
+                                         const wxArrayString* aImageNames = NULL );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
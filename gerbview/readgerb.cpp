@@ -24,65 +24,14 @@
 
 #include <fctsys.h>
 #include <common.h>
-#include <confirm.h>
 #include <kicad_string.h>
 #include <gerbview.h>
 #include <gerbview_frame.h>
 #include <class_gerber_file_image.h>
 #include <class_gerber_file_image_list.h>
 
-#include <html_messagebox.h>
 #include <macros.h>
 
-/* Read a gerber file, RS274D, RS274X or RS274X2 format.
- */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
-{
-    wxString msg;
-
-    int layer = getActiveLayer();
-    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
-    GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
-
-    if( gerber == NULL )
-    {
-        gerber = new GERBER_FILE_IMAGE( layer );
-        images->AddGbrImage( gerber, layer );
-    }
-
-    /* Read the gerber file */
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
-
-    if( !success )
-    {
-        msg.Printf( _( "File <%s> not found" ), GetChars( GERBER_FullFileName ) );
-        DisplayError( this, msg, 10 );
-        return false;
-    }
-
-    // Display errors list
-    if( gerber->GetMessages().size() > 0 )
-    {
-        HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(gerber->GetMessages());
-        dlg.ShowModal();
-    }
-
-    /* if the gerber file is only a RS274D file
-     * (i.e. without any aperture information), wran the user:
-     */
-    if( !gerber->m_Has_DCode )
-    {
-        msg = _("Warning: this file has no D-Code definition\n"
-                "It is perhaps an old RS274D file\n"
-                "Therefore the size of items is undefined");
-        wxMessageBox( msg );
-    }
-
-    return true;
-}
-
-
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
     int      G_command = 0;        // command number for G commands like G04
@@ -99,13 +48,13 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     if( m_Current_File == 0 )
         return false;
 
-    m_FileName = aFullFileName;
-
-    wxString path = wxPathOnly( aFullFileName );
+    // Gerber files can be very large: read them by large blocks.
+    // The buffer must exist until the file is closed.
+    std::vector<char> readBuffer( GERBER_FILE_READ_BUFSIZE );
+    setvbuf( m_Current_File, &readBuffer[0], _IOFBF, readBuffer.size() );
 
-    // This change is needed to load included files, if exists:
-    if( path != wxEmptyString )
-        wxSetWorkingDirectory( path );
+    // Note: the included files, if exist, are searched in the path of this file
+    m_FileName = aFullFileName;
 
     LOCALE_IO toggleIo;
 
@@ -206,6 +155,9 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     fclose( m_Current_File );
 
+    // The items were added, and the regions completed, while reading
+    InvalidateItemsIndex();
+
     m_InUse = true;
 
     return true;
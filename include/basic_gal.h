@@ -30,6 +30,7 @@
 #include <gal/stroke_font.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <newstroke_font.h>
+#include <ki_mutex.h>
 
 class PLOTTER;
 
@@ -116,6 +117,8 @@ public:
      */
     virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
 
+    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+
     /** Start and end points are defined as 2D-Vectors.
      * @param aStartPoint   is the start point of the line.
      * @param aEndPoint     is the end point of the line.
@@ -147,6 +150,9 @@ private:
     // Apply the roation/translation transform to aPoint
     const VECTOR2D transform( const VECTOR2D& aPoint ) const;
 
+    // Draw a polyline whose corners are already transformed
+    void doDrawPolyline( std::vector<wxPoint>& aLocalPointList );
+
     // A clip box, to clip drawings in a wxDC (mandatory to avoid draw issues)
     EDA_RECT  m_clipBox;        // The clip box
     bool      m_isClipped;      // Allows/disallows clipping
@@ -164,4 +170,7 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/// Lock of basic_gal, which is shared by all the threads drawing or plotting texts.
+extern MUTEX basic_gal_lock;
+
 #endif      // define BASIC_GAL_H
@@ -0,0 +1,64 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file batch_launcher.h
+ * @brief Helpers of the command line launchers which run a kiface without any window.
+ *
+ * The launchers compile common/batch_launcher.cpp themselves, as the programs do with
+ * single_top.cpp: they link nothing but wxWidgets.
+ */
+
+#ifndef BATCH_LAUNCHER_H
+#define BATCH_LAUNCHER_H
+
+#include <reporter.h>
+
+struct KIFACE;
+
+
+/**
+ * Class STDIO_REPORTER
+ * prints the messages on the standard output, and the errors on the standard error.
+ */
+class STDIO_REPORTER : public REPORTER
+{
+public:
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override;
+};
+
+
+/**
+ * Function LoadBatchKiface
+ * loads the kiface of a program from the directory of the running executable (see
+ * KIWAY::dso_search_path()).  The kiface is not started and there is no program, so
+ * only the functions which need neither can be used.  It stays loaded until exit, as
+ * KIWAY does.
+ *
+ * @param aName is the name of the program, e.g. "pcbnew".
+ * @param aReporter gets the error if the kiface cannot be loaded.
+ * @return the kiface, or NULL on error.
+ */
+KIFACE* LoadBatchKiface( const wxString& aName, REPORTER& aReporter );
+
+#endif  // BATCH_LAUNCHER_H
@@ -321,6 +321,29 @@ public:
         }
     }
 
+    /**
+     * Function SetMaxUndoMemory
+     * sets the memory limit of both the undo and the redo lists.  When a list grows
+     * beyond the limit, its oldest commands are deleted.
+     * @param aBytes The limit, in bytes, of each list. 0 disables the limit.
+     */
+    void SetMaxUndoMemory( size_t aBytes )
+    {
+        m_UndoList.SetMemoryLimit( aBytes );
+        m_RedoList.SetMemoryLimit( aBytes );
+    }
+
+    size_t GetMaxUndoMemory() const { return m_UndoList.GetMemoryLimit(); }
+
+    /**
+     * Function GetUndoRedoMemoryUsage
+     * @return The estimated memory held by the undo and redo lists, in bytes.
+     */
+    size_t GetUndoRedoMemoryUsage() const
+    {
+        return m_UndoList.GetMemoryUsage() + m_RedoList.GetMemoryUsage();
+    }
+
     void SetModify()        { m_FlagModified = true; }
     void ClrModify()        { m_FlagModified = false; }
     void SetSave()          { m_FlagSave = true; }
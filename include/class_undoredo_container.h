@@ -94,6 +94,12 @@ private:
                                         * copy of an active item) and m_Link points the active
                                         * item in schematic */
 
+    wxPoint        m_moveVector;       /* translation of this item, for UR_MOVED pickers
+                                        * which do not use the list-wide m_TransformPoint.
+                                        * This allows moved items to be undone without
+                                        * keeping a copy of each of them */
+    bool           m_hasMoveVector;    // true if m_moveVector has been set
+
 public:
     ITEM_PICKER( EDA_ITEM* aItem = NULL, UNDO_REDO_T aUndoRedoStatus = UR_UNSPECIFIED );
 
@@ -118,6 +124,16 @@ public:
     void SetLink( EDA_ITEM* aItem ) { m_link = aItem; }
 
     EDA_ITEM* GetLink() const { return m_link; }
+
+    void SetMoveVector( const wxPoint& aMoveVector )
+    {
+        m_moveVector = aMoveVector;
+        m_hasMoveVector = true;
+    }
+
+    bool HasMoveVector() const { return m_hasMoveVector; }
+
+    const wxPoint& GetMoveVector() const { return m_moveVector; }
 };
 
 
@@ -136,6 +152,8 @@ public:
 
 private:
     std::vector <ITEM_PICKER> m_ItemsList;
+    size_t m_memoryUsage;         /* estimated heap memory held by the item copies of
+                                   * this command, in bytes */
 
 public:
     PICKED_ITEMS_LIST();
@@ -297,6 +315,25 @@ public:
      * @param aSource The list of items to copy to the list.
      */
     void CopyList( const PICKED_ITEMS_LIST& aSource );
+
+    /**
+     * Function SetMemoryUsage
+     * stores the estimated memory held by the copies owned by this command.
+     * The estimate is made by the editor creating the command, as only it knows
+     * the size of its items.
+     * @param aBytes The estimated size, in bytes.
+     */
+    void SetMemoryUsage( size_t aBytes ) { m_memoryUsage = aBytes; }
+
+    /**
+     * Function GetMemoryUsage
+     * @return The estimated memory held by this command, in bytes: the pickers
+     * themselves plus the estimate given by SetMemoryUsage().
+     */
+    size_t GetMemoryUsage() const
+    {
+        return m_memoryUsage + m_ItemsList.size() * sizeof( ITEM_PICKER );
+    }
 };
 
 
@@ -310,6 +347,9 @@ class UNDO_REDO_CONTAINER
 public:
     std::vector <PICKED_ITEMS_LIST*> m_CommandsList;   // the list of possible undo/redo commands
 
+private:
+    size_t m_memoryLimit;       // max memory the commands may use, in bytes. 0 = no limit
+
 public:
 
     UNDO_REDO_CONTAINER();
@@ -320,6 +360,24 @@ public:
     PICKED_ITEMS_LIST* PopCommand();
 
     void ClearCommandList();
+
+    /**
+     * Function GetMemoryUsage
+     * @return The estimated memory held by all the commands of the list, in bytes.
+     */
+    size_t GetMemoryUsage() const;
+
+    void SetMemoryLimit( size_t aBytes ) { m_memoryLimit = aBytes; }
+
+    size_t GetMemoryLimit() const { return m_memoryLimit; }
+
+    /**
+     * Function GetExcessCommandCount
+     * @return The number of old commands to remove so the list fits in the memory
+     * limit.  The most recent command is never counted, even if it alone exceeds
+     * the limit.
+     */
+    int GetExcessCommandCount() const;
 };
 
 
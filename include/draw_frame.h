@@ -87,6 +87,8 @@ protected:
                                             // is at scale = 1
     int         m_UndoRedoCountMax;         ///< default Undo/Redo command Max depth, to be handed
                                             // to screens
+    long        m_UndoRedoMemoryMax;        ///< default Undo/Redo memory limit in MiB, to be
+                                            // handed to screens. 0 = no limit
 
     /// The area to draw on.
     EDA_DRAW_PANEL* m_canvas;
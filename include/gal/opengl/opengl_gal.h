@@ -384,6 +384,12 @@ private:
      */
     void drawPolygon( GLdouble* aPoints, int aPointCount );
 
+    /**
+     * @brief Draws a filled polygon set using its cached triangulation.
+     * @param aPolySet is the polygon set, its triangulation has to be up to date.
+     */
+    void drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet );
+
     /**
      * @brief Draws a single character using bitmap font.
      * Its main purpose is to be used in BitmapText() function.
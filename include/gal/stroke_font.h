@@ -30,6 +30,8 @@
 #define STROKE_FONT_H_
 
 #include <deque>
+#include <memory>
+#include <vector>
 #include <utf8.h>
 
 #include <eda_text.h>
@@ -39,9 +41,78 @@
 namespace KIGFX
 {
 class GAL;
+struct SHAPED_TEXT_LINE;
 
-typedef std::deque< std::deque<VECTOR2D> > GLYPH;
-typedef std::vector<GLYPH>                 GLYPH_LIST;
+/**
+ * @brief Class GLYPH_TABLE holds the decoded glyphs of a stroke font.
+ *
+ * The points of all the strokes of all the glyphs are stored in a single contiguous array,
+ * offset tables give the first stroke of each glyph and the first point of each stroke.
+ * A table is read-only once built, so it is shared by all the STROKE_FONT instances using
+ * the same font data (see GLYPH_TABLE::Get()).
+ */
+class GLYPH_TABLE
+{
+public:
+    /**
+     * @brief Decode a font in the Hershey-like newstroke format.
+     *
+     * @param aNewStrokeFont is the pointer to the font data.
+     * @param aNewStrokeFontSize is the size of the font data.
+     */
+    GLYPH_TABLE( const char* const aNewStrokeFont[], int aNewStrokeFontSize );
+
+    /**
+     * @brief Return the decoded table for a font, decoding it on the first request only.
+     * This function is thread safe.
+     *
+     * @param aNewStrokeFont is the pointer to the font data.
+     * @param aNewStrokeFontSize is the size of the font data.
+     */
+    static std::shared_ptr<const GLYPH_TABLE> Get( const char* const aNewStrokeFont[],
+                                                   int aNewStrokeFontSize );
+
+    int GlyphCount() const
+    {
+        return m_boundingBoxes.size();
+    }
+
+    ///> Returns the bounding box of the aGlyph-th glyph
+    const BOX2D& BoundingBox( int aGlyph ) const
+    {
+        return m_boundingBoxes[aGlyph];
+    }
+
+    ///> Returns the index of the first stroke of the aGlyph-th glyph
+    int FirstStroke( int aGlyph ) const
+    {
+        return m_glyphStrokes[aGlyph];
+    }
+
+    ///> Returns the index following the last stroke of the aGlyph-th glyph
+    int EndStroke( int aGlyph ) const
+    {
+        return m_glyphStrokes[aGlyph + 1];
+    }
+
+    ///> Returns the points of the aStroke-th stroke
+    const VECTOR2D* StrokePoints( int aStroke ) const
+    {
+        return &m_points[ m_strokePoints[aStroke] ];
+    }
+
+    ///> Returns the number of points of the aStroke-th stroke
+    int StrokePointCount( int aStroke ) const
+    {
+        return m_strokePoints[aStroke + 1] - m_strokePoints[aStroke];
+    }
+
+private:
+    std::vector<VECTOR2D>   m_points;           ///< Points of all the strokes
+    std::vector<int>        m_strokePoints;     ///< Index of the first point of each stroke
+    std::vector<int>        m_glyphStrokes;     ///< Index of the first stroke of each glyph
+    std::vector<BOX2D>      m_boundingBoxes;    ///< Bounding boxes of the glyphs
+};
 
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
@@ -51,6 +122,7 @@ typedef std::vector<GLYPH>                 GLYPH_LIST;
 class STROKE_FONT
 {
     friend class GAL;
+    friend class GLYPH_TABLE;
 
 public:
     /// Constructor
@@ -126,8 +198,7 @@ public:
 
 private:
     GAL*                m_gal;                  ///< Pointer to the GAL
-    GLYPH_LIST          m_glyphs;               ///< Glyph list
-    std::vector<BOX2D>  m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+    std::shared_ptr<const GLYPH_TABLE> m_glyphs;    ///< Decoded glyphs, shared between fonts
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -153,13 +224,18 @@ private:
     int getInterline() const;
 
     /**
-     * @brief Compute the bounding box of a given glyph.
-     *
-     * @param aGlyph is the glyph.
-     * @param aGlyphBoundingX is the x-component of the bounding box size.
-     * @return is the complete bounding box size.
+     * @brief Returns the index of the glyph to draw for a character, the index of
+     * '?' if the font has no glyph for it.
      */
-    BOX2D computeBoundingBox( const GLYPH& aGlyph, const VECTOR2D& aGlyphBoundingX ) const;
+    int glyphIndex( int aChar ) const
+    {
+        int dd = aChar - ' ';
+
+        if( dd >= m_glyphs->GlyphCount() || dd < 0 )
+            dd = '?' - ' ';
+
+        return dd;
+    }
 
     /**
      * @brief Draws a single line of text. Multiline texts should be split before using the
@@ -169,6 +245,14 @@ private:
      */
     void drawSingleLineText( const UTF8& aText );
 
+    /**
+     * @brief Lays out a single line of text using the current GAL text attributes, or
+     * returns the cached layout of a line previously shaped with the same attributes.
+     *
+     * @param aText is the text to be shaped (one line).
+     */
+    std::shared_ptr<const SHAPED_TEXT_LINE> shapeSingleLineText( const UTF8& aText ) const;
+
     /**
      * @brief Returns number of lines for a given text.
      *
@@ -317,6 +317,14 @@ public:
      */
     int Length() const;
 
+    /**
+     * Function Area()
+     *
+     * Returns the area enclosed by the line chain, which is considered closed.
+     * @return area of the line chain. Its sign depends on the orientation of the chain.
+     */
+    double Area() const;
+
     /**
      * Function Append()
      *
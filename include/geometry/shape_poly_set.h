@@ -28,6 +28,8 @@
 
 #include <vector>
 #include <cstdio>
+#include <cstdint>
+#include <memory>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
@@ -57,6 +59,66 @@ class SHAPE_POLY_SET : public SHAPE
         ///> the remaining (if any), are the holes
         typedef std::vector<SHAPE_LINE_CHAIN> POLYGON;
 
+        /**
+         * Class TRIANGULATED_POLYGON
+         *
+         * Triangle mesh of a single polygon (outline with holes) of the set. Vertices are
+         * stored once and referenced by index from the triangles, so the mesh can be fed
+         * directly to a vertex buffer.
+         */
+        class TRIANGULATED_POLYGON
+        {
+        public:
+            struct TRI
+            {
+                TRI( int aA = 0, int aB = 0, int aC = 0 ) : a( aA ), b( aB ), c( aC )
+                {
+                }
+
+                int a, b, c;
+            };
+
+            void Clear()
+            {
+                m_vertices.clear();
+                m_triangles.clear();
+            }
+
+            int AddVertex( const VECTOR2I& aP )
+            {
+                m_vertices.push_back( aP );
+                return m_vertices.size() - 1;
+            }
+
+            void AddTriangle( int aA, int aB, int aC )
+            {
+                m_triangles.push_back( TRI( aA, aB, aC ) );
+            }
+
+            void GetTriangle( int aIndex, VECTOR2I& aA, VECTOR2I& aB, VECTOR2I& aC ) const
+            {
+                const TRI& tri = m_triangles[aIndex];
+
+                aA = m_vertices[tri.a];
+                aB = m_vertices[tri.b];
+                aC = m_vertices[tri.c];
+            }
+
+            int GetTriangleCount() const
+            {
+                return m_triangles.size();
+            }
+
+            int GetVertexCount() const
+            {
+                return m_vertices.size();
+            }
+
+        private:
+            std::vector<VECTOR2I> m_vertices;
+            std::vector<TRI> m_triangles;
+        };
+
         /**
          * Struct VERTEX_INDEX
          *
@@ -979,6 +1041,38 @@ class SHAPE_POLY_SET : public SHAPE
          */
         bool IsVertexInHole( int aGlobalIdx );
 
+        /**
+         * Function CacheTriangulation
+         * (re)computes the triangle mesh of the set if it is missing or was made stale by a
+         * modification of the polygons. The mesh is kept alongside the polygons and shared
+         * (not recomputed) by copies of this set, so the GAL, the 3D viewer and the exporters
+         * can reuse the same triangulation of e.g. a zone fill.
+         * The cache is not protected against concurrent access: callers triangulating the
+         * same set from several threads must synchronize.
+         * @return bool - true if a valid triangulation is available.
+         */
+        bool CacheTriangulation() const;
+
+        /**
+         * Function IsTriangulationUpToDate
+         * @return bool - true if a triangulation has been cached and the polygons were not
+         *              modified since.
+         */
+        bool IsTriangulationUpToDate() const;
+
+        ///> Returns the number of triangulated polygons in the cache. It may differ from
+        ///> OutlineCount(), as the set is simplified before being triangulated.
+        unsigned int TriangulatedPolyCount() const
+        {
+            return m_triangulatedPolys.size();
+        }
+
+        ///> Returns the cached triangle mesh of the aIndex-th triangulated polygon
+        const TRIANGULATED_POLYGON* TriangulatedPolygon( int aIndex ) const
+        {
+            return m_triangulatedPolys[aIndex].get();
+        }
+
     private:
 
         SHAPE_LINE_CHAIN& getContourForCorner( int aCornerId, int& aIndexWithinContour );
@@ -1025,6 +1119,13 @@ class SHAPE_POLY_SET : public SHAPE
          */
         bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex ) const;
 
+        ///> Computes a checksum of all the vertices in the set, used to detect modifications
+        ///> made through the non-const accessors since the triangulation was cached.
+        uint64_t checksum() const;
+
+        ///> Triangulates the polygon with holes aPoly into aResult.
+        static bool triangulateSingle( const POLYGON& aPoly, TRIANGULATED_POLYGON& aResult );
+
         /**
          * Operations ChamferPolygon and FilletPolygon are computed under the private chamferFillet
          * method; this enum is defined to make the necessary distinction when calling this method
@@ -1056,6 +1157,17 @@ class SHAPE_POLY_SET : public SHAPE
         typedef std::vector<POLYGON> Polyset;
 
         Polyset m_polys;
+
+        typedef std::vector< std::shared_ptr<const TRIANGULATED_POLYGON> > TRIANGULATED_POLYS;
+
+        ///> Cached triangulation, shared between copies of the set
+        mutable TRIANGULATED_POLYS m_triangulatedPolys;
+
+        ///> Checksum of m_polys when m_triangulatedPolys was computed
+        mutable uint64_t m_triangulationChecksum;
+
+        ///> True if m_triangulatedPolys holds a triangulation (possibly stale)
+        mutable bool m_triangulationValid;
 };
 
 #endif
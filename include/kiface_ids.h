@@ -44,6 +44,19 @@ enum KIFACE_ADDR_ID : int
      * Caller takes ownership
      */
     KIFACE_G_FOOTPRINT_TABLE, ///<
+
+    /**
+     * Return the address of the function creating the fabrication outputs of a board
+     * from a manifest file, from pcbnew.
+     * Type is FAB_MANIFEST_RUNNER*, see pcbnew/fab_manifest.h
+     */
+    KIFACE_RUN_FAB_MANIFEST,
+
+    /**
+     * Return the address of the function comparing gerber files, from gerbview.
+     * Type is GERBER_FILES_COMPARER*, see gerbview/gerber_compare.h
+     */
+    KIFACE_COMPARE_GERBER_FILES,
 };
 
 #endif // KIFACE_IDS
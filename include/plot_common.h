@@ -33,6 +33,7 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <drawtxt.h>
 #include <class_page_info.h>
@@ -1179,18 +1180,47 @@ protected:
     // The last aperture attribute generated (only one aperture attribute can be set)
     int           m_apertureAttribute;
 
-    FILE* workFile;
-    FILE* finalFile;
-    wxString m_workFilename;
-
     /**
-     * Generate the table of D codes
+     * Write the definition (%ADD) of a new aperture, preceded by its aperture
+     * attribute if it differs from the current one
      */
-    void writeApertureList();
+    void writeApertureDefinition( const APERTURE& aAperture );
 
     std::vector<APERTURE>           apertures;
     std::vector<APERTURE>::iterator currentAperture;
 
+    /// The key of an aperture in m_apertureIndex
+    struct APERTURE_KEY
+    {
+        int m_Type;
+        int m_SizeX;
+        int m_SizeY;
+        int m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_SizeX == aOther.m_SizeX
+                   && m_SizeY == aOther.m_SizeY
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        std::size_t operator()( const APERTURE_KEY& aKey ) const
+        {
+            std::size_t seed = std::hash<int>()( aKey.m_Type );
+
+            for( int v : { aKey.m_SizeX, aKey.m_SizeY, aKey.m_ApertureAttribute } )
+                seed ^= std::hash<int>()( v ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+            return seed;
+        }
+    };
+
+    /// Index in apertures of each aperture, used by getAperture to avoid a linear search
+    std::unordered_map<APERTURE_KEY, size_t, APERTURE_KEY_HASH> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
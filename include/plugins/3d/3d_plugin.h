@@ -122,7 +122,8 @@ KICAD_PLUGIN_EXPORT char const* GetFileFilter( int aIndex );
 KICAD_PLUGIN_EXPORT bool CanRender( void );
 
 /**
- * reads a model file and creates a generic display structure
+ * reads a model file and creates a generic display structure; it may be called
+ * by several threads at once, so a plugin which is not reentrant locks it
  *
  * @param aFileName is the full path of the model file
  * @return a SCENEGRAPH pointer to the display structure if the model
@@ -244,6 +244,16 @@ public:
         rewind( fp );
         lineNum = 0;
     }
+
+    /**
+     * Function Tell
+     * returns the position of the next line in the file, so that a reader can be
+     * started there later, with fseek(), to read the same lines again.
+     */
+    long Tell() const
+    {
+        return ftell( fp );
+    }
 };
 
 
@@ -92,6 +92,13 @@ public:
      */
     void Remove( VIEW_ITEM* aItem );
 
+    /**
+     * Function Remove()
+     * Removes a set of VIEW_ITEMs from the view. The list of all items is updated in a single
+     * pass, so it is much faster than removing the items one by one.
+     * @param aItems: items to be removed. Caller must dispose the removed items if necessary
+     */
+    void Remove( const std::vector<VIEW_ITEM*>& aItems );
 
     /**
      * Function Query()
@@ -726,6 +733,9 @@ private:
      */
     void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
 
+    /// Removes an item from the layer trees and frees its GAL groups
+    void removeFromLayers( VIEW_ITEM* aItem );
+
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
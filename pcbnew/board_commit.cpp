@@ -31,14 +31,22 @@
 #include <board_commit.h>
 #include <tools/pcb_tool.h>
 #include <connectivity.h>
+#include <profile.h>
 
 #include <functional>
+#include <unordered_set>
 using namespace std::placeholders;
 
+/**
+ * Trace mask to log the time spent in each phase of BOARD_COMMIT::Push().
+ */
+static const wxChar traceBoardCommit[] = wxT( "KicadBoardCommit" );
+
 BOARD_COMMIT::BOARD_COMMIT( PCB_TOOL* aTool )
 {
     m_toolMgr = aTool->GetManager();
     m_editModules = aTool->EditingModules();
+    m_translationOnly = false;
 }
 
 
@@ -46,6 +54,7 @@ BOARD_COMMIT::BOARD_COMMIT( PCB_BASE_FRAME* aFrame )
 {
     m_toolMgr = aFrame->GetToolManager();
     m_editModules = aFrame->IsType( FRAME_PCB_MODULE_EDITOR );
+    m_translationOnly = false;
 }
 
 
@@ -64,8 +73,34 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
     auto connectivity = board->GetConnectivity();
     std::set<EDA_ITEM*> savedModules;
 
+    // View and connectivity updates are gathered while the board is modified, and applied
+    // in bulk afterwards: removing items from the view one by one is linear in the number
+    // of items in the view.
+    std::vector<KIGFX::VIEW_ITEM*> viewRemoved;
+    std::vector<BOARD_ITEM*> viewAdded;
+    std::unordered_set<BOARD_ITEM*> pendingAdded;
+    std::vector<BOARD_ITEM*> connUpdated;
+
+    auto addToView = [&] ( BOARD_ITEM* aItem )
+    {
+        viewAdded.push_back( aItem );
+        pendingAdded.insert( aItem );
+    };
+
+    auto removeFromView = [&] ( BOARD_ITEM* aItem )
+    {
+        // An item added by this commit is not in the view yet
+        if( pendingAdded.erase( aItem ) == 0 )
+            viewRemoved.push_back( aItem );
+    };
+
     if( Empty() )
+    {
+        m_translationOnly = false;
         return;
+    }
+
+    PROF_COUNTER phaseCounter;
 
     for( COMMIT_LINE& ent : m_changes )
     {
@@ -124,7 +159,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
                     if( boardItem->Type() == PCB_MODULE_T )
                     {
                         MODULE* mod = static_cast<MODULE*>( boardItem );
-                        mod->RunOnChildren( std::bind( &KIGFX::VIEW::Add, view, _1, -1 ) );
+                        mod->RunOnChildren( addToView );
                     }
                 }
                 else
@@ -136,7 +171,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
                         board->m_Modules->Add( boardItem );
                 }
 
-                view->Add( boardItem );
+                addToView( boardItem );
                 break;
             }
 
@@ -187,7 +222,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 
                     if( remove )
                     {
-                        view->Remove( boardItem );
+                        // The item is deleted right away, so it has to leave the view now
+                        if( pendingAdded.erase( boardItem ) == 0 )
+                            view->Remove( boardItem );
 
                         if( !( changeFlags & CHT_DONE ) )
                         {
@@ -212,7 +249,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
                 case PCB_MARKER_T:              // a marker used to show something
                 case PCB_ZONE_T:                // SEG_ZONE items are now deprecated
                 case PCB_ZONE_AREA_T:
-                    view->Remove( boardItem );
+                    removeFromView( boardItem );
 
                     if( !( changeFlags & CHT_DONE ) )
                         board->Remove( boardItem );
@@ -227,9 +264,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 
                     MODULE* module = static_cast<MODULE*>( boardItem );
                     module->ClearFlags();
-                    module->RunOnChildren( std::bind( &KIGFX::VIEW::Remove, view, _1 ) );
+                    module->RunOnChildren( removeFromView );
 
-                    view->Remove( module );
+                    removeFromView( module );
 
                     if( !( changeFlags & CHT_DONE ) )
                         board->Remove( module );
@@ -248,12 +285,31 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 
             case CHT_MODIFY:
             {
+                BOARD_ITEM* copy = static_cast<BOARD_ITEM*>( ent.m_copy );
+                assert( copy );
+                bool storeMoveVector = false;
+
                 if( !m_editModules && aCreateUndoEntry )
                 {
-                    ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
-                    assert( ent.m_copy );
-                    itemWrapper.SetLink( ent.m_copy );
-                    undoList.PushItem( itemWrapper );
+                    wxPoint moveVector = boardItem->GetPosition() - copy->GetPosition();
+
+                    // A move vector is enough to undo the change only if the staged item is
+                    // the one which was moved: when a pad or a text is dragged, its parent
+                    // footprint is staged and does not move, so its copy has to be kept.
+                    storeMoveVector = m_translationOnly && moveVector != wxPoint( 0, 0 );
+
+                    if( storeMoveVector )
+                    {
+                        ITEM_PICKER itemWrapper( boardItem, UR_MOVED );
+                        itemWrapper.SetMoveVector( moveVector );
+                        undoList.PushItem( itemWrapper );
+                    }
+                    else
+                    {
+                        ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
+                        itemWrapper.SetLink( copy );
+                        undoList.PushItem( itemWrapper );
+                    }
                 }
 
                 if( boardItem->Type() == PCB_MODULE_T )
@@ -263,8 +319,15 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
                 }
 
                 view->Update ( boardItem );
-                connectivity->MarkItemNetAsDirty( static_cast<BOARD_ITEM*>( ent.m_copy ) );
-                connectivity->Update( boardItem );
+                connectivity->MarkItemNetAsDirty( copy );
+                connUpdated.push_back( boardItem );
+
+                if( storeMoveVector )
+                {
+                    delete copy;
+                    ent.m_copy = nullptr;
+                }
+
                 break;
             }
 
@@ -274,18 +337,46 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
         }
     }
 
+    double modelTime = phaseCounter.msecs();
+    phaseCounter.Start();
+
+    view->Remove( viewRemoved );
+
+    for( BOARD_ITEM* item : viewAdded )
+    {
+        if( pendingAdded.count( item ) )
+            view->Add( item );
+    }
+
+    double viewTime = phaseCounter.msecs();
+    phaseCounter.Start();
+
+    for( BOARD_ITEM* item : connUpdated )
+        connectivity->Update( item );
+
+    double connectivityTime = phaseCounter.msecs();
+
     if( !m_editModules && aCreateUndoEntry )
         frame->SaveCopyInUndoList( undoList, UR_UNSPECIFIED );
 
     if( TOOL_MANAGER* toolMgr = frame->GetToolManager() )
         toolMgr->PostEvent( { TC_MESSAGE, TA_MODEL_CHANGE, AS_GLOBAL } );
 
+    phaseCounter.Start();
+
     if ( !m_editModules )
         connectivity->RecalculateRatsnest();
 
+    double ratsnestTime = phaseCounter.msecs();
+
+    wxLogTrace( traceBoardCommit,
+                wxT( "Push of %u changes: model %.3f ms, view %.3f ms, connectivity %.3f ms, ratsnest %.3f ms" ),
+                (unsigned) m_changes.size(), modelTime, viewTime, connectivityTime, ratsnestTime );
+
     frame->OnModify();
     frame->UpdateMsgPanel();
 
+    m_translationOnly = false;
     clear();
 }
 
@@ -383,5 +474,6 @@ void BOARD_COMMIT::Revert()
     if ( !m_editModules )
         connectivity->RecalculateRatsnest();
 
+    m_translationOnly = false;
     clear();
 }
@@ -43,9 +43,17 @@ public:
     virtual void Push( const wxString& aMessage = wxT( "A commit" ), bool aCreateUndoEntry = true ) override;
     virtual void Revert() override;
 
+    ///> Declares that the items modified in this commit have only been moved. Push() then
+    ///> stores move vectors in the undo buffer instead of copies of the items.
+    void SetTranslationOnly( bool aTranslationOnly )
+    {
+        m_translationOnly = aTranslationOnly;
+    }
+
 private:
     TOOL_MANAGER* m_toolMgr;
     bool m_editModules;
+    bool m_translationOnly;
     virtual EDA_ITEM* parentObject( EDA_ITEM* aItem ) const override;
 };
 
@@ -50,9 +50,10 @@
 // These variables are parameters used in addTextSegmToPoly.
 // But addTextSegmToPoly is a call-back function,
 // so we cannot send them as arguments.
-static int s_textWidth;
-static int s_textCircle2SegmentCount;
-static SHAPE_POLY_SET* s_cornerBuffer;
+// They are per thread: the layers of a board can be plotted by several threads.
+static thread_local int s_textWidth;
+static thread_local int s_textCircle2SegmentCount;
+static thread_local SHAPE_POLY_SET* s_cornerBuffer;
 
 // This is a call back function, used by DrawGraphicText to draw the 3D text shape:
 static void addTextSegmToPoly( int x0, int y0, int xf, int yf )
@@ -800,6 +800,8 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    std::vector<BOARD_LAYER_PLOT> plots;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -825,26 +827,32 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
                            m_board->GetLayerName( layer ),
                            file_ext );
 
-        LOCALE_IO toggle;
+        BOARD_LAYER_PLOT plot;
+
+        plot.m_layer = layer;
+        plot.m_fullFileName = fn.GetFullPath();
+        plot.m_created = false;
+
+        plots.push_back( plot );
+    }
 
-        BOARD*      board = m_parent->GetBoard();
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+    // The layers are plotted concurrently, the diags are reported afterwards,
+    // in the layer order
+    PlotBoardLayers( m_parent->GetBoard(), &m_plotOpts, plots );
 
+    for( const BOARD_LAYER_PLOT& plot : plots )
+    {
         // Print diags in messages box:
         wxString msg;
 
-        if( plotter )
+        if( plot.m_created )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file '%s' created." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Plot file '%s' created." ), GetChars( plot.m_fullFileName ) );
             reporter.Report( msg, REPORTER::RPT_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file '%s'." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Unable to create file '%s'." ), GetChars( plot.m_fullFileName ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
         }
     }
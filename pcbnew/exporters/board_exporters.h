@@ -0,0 +1,86 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_exporters.h
+ * @brief Exporters working on a board only, without an editor frame.
+ *
+ * They are used by the PCB_EDIT_FRAME commands, and by the fabrication outputs
+ * batch runner (see fab_manifest.h), which has no frame and no project.
+ */
+
+#ifndef BOARD_EXPORTERS_H_
+#define BOARD_EXPORTERS_H_
+
+#include <wx/string.h>
+
+class BOARD;
+class S3D_CACHE;
+
+// Sides of the footprint position files
+#define PCB_BACK_SIDE 0
+#define PCB_FRONT_SIDE 1
+#define PCB_BOTH_SIDES 2
+
+
+/**
+ * Function CreateFootprintsPositionFile
+ * creates a footprint position (pick and place) file.
+ * @param aBoard = the board
+ * @param aFullFileName = the file to create. If empty, the file is not created, only
+ *                        the count of footprints to place is returned.
+ * @param aUnitsMM = true for mm units, false for inches
+ * @param aForceSmdItems = true to mark as SMD the footprints having only SMD pads.
+ *                         This modifies the board.
+ * @param aSide = PCB_BACK_SIDE, PCB_FRONT_SIDE or PCB_BOTH_SIDES
+ * @param aFormatCSV = true for a CSV file, false for the ascii format
+ * @param aBoardModified = if not NULL, set to true when aForceSmdItems changed a footprint
+ * @return the count of footprints in the file, or -1 if the file cannot be created
+ */
+int CreateFootprintsPositionFile( BOARD* aBoard, const wxString& aFullFileName,
+                                  bool aUnitsMM, bool aForceSmdItems, int aSide,
+                                  bool aFormatCSV, bool* aBoardModified = NULL );
+
+/**
+ * Function CreateD356File
+ * creates an IPC-D-356 netlist test file.
+ * @return false if the file cannot be created
+ */
+bool CreateD356File( BOARD* aPcb, const wxString& aFullFileName );
+
+/**
+ * Function ExportBoardToVRML
+ * exports the board to a VRML file, see PCB_EDIT_FRAME::ExportVRML_File() for the
+ * export options.  Only one board is exported at a time: concurrent calls are serialized.
+ * @param aCache = the 3D model cache used to find the footprint models
+ * @param aProjectDir = the project directory, used to build relative model paths
+ * @param aErrorMsg = if not NULL, receives the error message when the export fails
+ * @return true if the export succeeded
+ */
+bool ExportBoardToVRML( BOARD* aPcb, S3D_CACHE* aCache, const wxString& aProjectDir,
+                        const wxString& aFullFileName, double aMMtoWRMLunit,
+                        bool aExport3DFiles, bool aUseRelativePaths, bool aUsePlainPCB,
+                        const wxString& a3D_Subdir, double aXRef, double aYRef,
+                        wxString* aErrorMsg = NULL );
+
+#endif  // BOARD_EXPORTERS_H_
@@ -38,6 +38,7 @@
 #include <macros.h>
 
 #include <pcbnew.h>
+#include <board_exporters.h>
 
 #include <class_board.h>
 #include <class_module.h>
@@ -353,7 +354,6 @@ void PCB_EDIT_FRAME::GenD356File( wxCommandEvent& aEvent )
 {
     wxFileName  fn = GetBoard()->GetFileName();
     wxString    msg, ext, wildcard;
-    FILE*       file;
 
     ext = wxT( "d356" );
     wildcard = _( "IPC-D-356 Test Files (.d356)|*.d356" );
@@ -368,21 +368,29 @@ void PCB_EDIT_FRAME::GenD356File( wxCommandEvent& aEvent )
     if( dlg.ShowModal() == wxID_CANCEL )
         return;
 
-    if( ( file = wxFopen( dlg.GetPath(), wxT( "wt" ) ) ) == NULL )
+    if( !CreateD356File( GetBoard(), dlg.GetPath() ) )
     {
         msg = _( "Unable to create " ) + dlg.GetPath();
         DisplayError( this, msg ); return;
     }
+}
+
+
+bool CreateD356File( BOARD* aPcb, const wxString& aFullFileName )
+{
+    FILE*       file;
+
+    if( ( file = wxFopen( aFullFileName, wxT( "wt" ) ) ) == NULL )
+        return false;
 
     LOCALE_IO       toggle;     // Switch the locale to standard C
 
     // This will contain everything needed for the 356 file
     std::vector <D356_RECORD> d356_records;
-    BOARD* pcb = GetBoard();
 
-    build_via_testpoints( pcb, d356_records );
+    build_via_testpoints( aPcb, d356_records );
 
-    build_pad_testpoints( pcb, d356_records );
+    build_pad_testpoints( aPcb, d356_records );
 
     // Code 00 AFAIK is ASCII, CUST 0 is decimils/degrees
     // CUST 1 would be metric but gerbtool simply ignores it!
@@ -393,4 +401,6 @@ void PCB_EDIT_FRAME::GenD356File( wxCommandEvent& aEvent )
     fprintf( file, "999\n" );
 
     fclose( file );
+
+    return true;
 }
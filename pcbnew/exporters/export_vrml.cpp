@@ -28,6 +28,7 @@
 #include <exception>
 #include <fstream>
 #include <iomanip>
+#include <map>
 #include <vector>
 #include <wx/dir.h>
 
@@ -47,6 +48,8 @@
 #include "streamwrapper.h"
 #include "vrml_layer.h"
 #include "wxPcbStruct.h"
+#include "board_exporters.h"
+#include "ki_mutex.h"
 #include "../../kicad/kicad.h"
 
 // minimum width (mm) of a VRML line
@@ -159,6 +162,10 @@ public:
 
     std::list< SGNODE* > m_components;
 
+    // the 3D model files already copied or converted to the 3D subdirectory, by model
+    // file name; the exported file name is empty if the model could not be exported
+    std::map< wxString, wxString > m_exportedModels;
+
     bool m_plainPCB;
 
     double m_minLineWidth;    // minimum width of a VRML line segment
@@ -418,8 +425,40 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
 static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     const char* aFileName, OSTREAM* aOutputFile )
 {
+    // The layers are independent: tesselate them all first, concurrently.
+    // Tesselate() renumbers the vertices of the holes, and the triangles of a layer
+    // refer to this numbering until they are written, so each layer but the board
+    // is given its own copy of the holes.
+    VRML_LAYER* layers[] =
+    {
+        &aModel.m_board,
+        &aModel.m_top_copper, &aModel.m_top_tin,
+        &aModel.m_bot_copper, &aModel.m_bot_tin,
+        &aModel.m_top_silk, &aModel.m_bot_silk,
+        &aModel.m_plated_holes
+    };
+
+    const int   layerCount = aModel.m_plainPCB ? 1 : DIM( layers );
+    VRML_LAYER  holes[DIM( layers ) - 1];
+
+    for( int ii = 1; ii < layerCount; ++ii )
+    {
+        if( layers[ii] != &aModel.m_plated_holes )
+            holes[ii - 1].AppendContours( aModel.m_holes );
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < layerCount; ++ii )
+    {
+        if( layers[ii] == &aModel.m_plated_holes )
+            layers[ii]->Tesselate( NULL, true );
+        else
+            layers[ii]->Tesselate( ii == 0 ? &aModel.m_holes : &holes[ii - 1] );
+    }
+
     // VRML_LAYER board;
-    aModel.m_board.Tesselate( &aModel.m_holes );
     double brdz = aModel.m_brd_thickness / 2.0
                   - ( Millimeter2iu( ART_OFFSET / 2.0 ) ) * BOARD_SCALE;
 
@@ -442,7 +481,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_top_copper;
-    aModel.m_top_copper.Tesselate( &aModel.m_holes );
 
     if( USE_INLINES )
     {
@@ -457,7 +495,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_top_tin;
-    aModel.m_top_tin.Tesselate( &aModel.m_holes );
 
     if( USE_INLINES )
     {
@@ -474,7 +511,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_bot_copper;
-    aModel.m_bot_copper.Tesselate( &aModel.m_holes );
 
     if( USE_INLINES )
     {
@@ -489,7 +525,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_bot_tin;
-    aModel.m_bot_tin.Tesselate( &aModel.m_holes );
 
     if( USE_INLINES )
     {
@@ -507,7 +542,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER PTH;
-    aModel.m_plated_holes.Tesselate( NULL, true );
 
     if( USE_INLINES )
     {
@@ -524,7 +558,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_top_silk;
-    aModel.m_top_silk.Tesselate( &aModel.m_holes );
 
     if( USE_INLINES )
     {
@@ -538,7 +571,6 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
 
     // VRML_LAYER m_bot_silk;
-    aModel.m_bot_silk.Tesselate( &aModel.m_holes );
 
     if( USE_INLINES )
     {
@@ -805,7 +837,7 @@ static void export_vrml_board( MODEL_VRML& aModel, BOARD* aPcb )
     {
         msg << "\n\n" <<
             _( "Unable to calculate the board outlines; fall back to using the board boundary box." );
-        wxMessageBox( msg );
+        wxLogWarning( msg );
     }
 
     int seg;
@@ -836,7 +868,7 @@ static void export_vrml_board( MODEL_VRML& aModel, BOARD* aPcb )
             {
                 msg << "\n\n" <<
                   _( "VRML Export Failed: Could not add holes to contours." );
-                wxMessageBox( msg );
+                wxLogError( msg );
 
                 return;
             }
@@ -1265,6 +1297,39 @@ static void compose_quat( double q1[4], double q2[4], double qr[4] )
 }
 
 
+// Copy (VRML files) or convert (other formats) a 3D model file to the 3D subdirectory,
+// if the destination is not up to date.  Returns false if the model could not be written.
+static bool export_vrml_model_file( const wxFileName& aSrcFile, const wxFileName& aDstFile,
+                                    SGNODE* aModel3D )
+{
+    // copy the file if necessary
+    wxDateTime srcModTime = aSrcFile.GetModificationTime();
+    wxDateTime destModTime = srcModTime;
+
+    destModTime.SetToCurrent();
+
+    if( aDstFile.FileExists() )
+        destModTime = aDstFile.GetModificationTime();
+
+    if( srcModTime == destModTime )
+        return true;
+
+    wxLogDebug( "Copying 3D model %s to %s.",
+                GetChars( aSrcFile.GetFullPath() ),
+                GetChars( aDstFile.GetFullPath() ) );
+
+    wxString fileExt = aSrcFile.GetExt();
+    fileExt.LowerCase();
+
+    // copy VRML models and use the scenegraph library to
+    // translate other model types
+    if( fileExt == "wrl" )
+        return wxCopyFile( aSrcFile.GetFullPath(), aDstFile.GetFullPath() );
+
+    return S3D::WriteVRML( aDstFile.GetFullPath().ToUTF8(), true, aModel3D, USE_DEFS, true );
+}
+
+
 static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
     MODULE* aModule, std::ostream* aOutputFile )
 {
@@ -1307,17 +1372,12 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
     std::list<S3D_INFO>::iterator sM = aModule->Models().begin();
     std::list<S3D_INFO>::iterator eM = aModule->Models().end();
 
-    wxFileName subdir( SUBDIR_3D, "" );
-
-    while( sM != eM )
+    for( ; sM != eM; ++sM )
     {
         SGNODE* mod3d = (SGNODE*) cache->Load( sM->m_Filename );
 
         if( NULL == mod3d )
-        {
-            ++sM;
             continue;
-        }
 
         /* Calculate 3D shape rotation:
          * this is the rotation parameters, with an additional 180 deg rotation
@@ -1369,44 +1429,32 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
 
         if( USE_INLINES )
         {
-            wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
-            wxFileName dstFile;
-            dstFile.SetPath( SUBDIR_3D );
-            dstFile.SetName( srcFile.GetName() );
-            dstFile.SetExt( "wrl"  );
+            // a model is copied or converted once per export, not once per footprint
+            std::map< wxString, wxString >::iterator exported =
+                    aModel.m_exportedModels.find( sM->m_Filename );
 
-            // copy the file if necessary
-            wxDateTime srcModTime = srcFile.GetModificationTime();
-            wxDateTime destModTime = srcModTime;
+            if( exported == aModel.m_exportedModels.end() )
+            {
+                wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
+                wxFileName dstFile;
+                dstFile.SetPath( SUBDIR_3D );
+                dstFile.SetName( srcFile.GetName() );
+                dstFile.SetExt( "wrl"  );
 
-            destModTime.SetToCurrent();
+                wxString dstName;
 
-            if( dstFile.FileExists() )
-                destModTime = dstFile.GetModificationTime();
+                if( export_vrml_model_file( srcFile, dstFile, mod3d ) )
+                    dstName = dstFile.GetFullPath();
 
-            if( srcModTime != destModTime )
-            {
-                wxLogDebug( "Copying 3D model %s to %s.",
-                            GetChars( srcFile.GetFullPath() ),
-                            GetChars( dstFile.GetFullPath() ) );
-
-                wxString fileExt = srcFile.GetExt();
-                fileExt.LowerCase();
-
-                // copy VRML models and use the scenegraph library to
-                // translate other model types
-                if( fileExt == "wrl" )
-                {
-                    if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
-                        continue;
-                }
-                else
-                {
-                    if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d, USE_DEFS, true ) )
-                        continue;
-                }
+                exported = aModel.m_exportedModels.insert(
+                        std::make_pair( sM->m_Filename, dstName ) ).first;
             }
 
+            if( exported->second.IsEmpty() )
+                continue;
+
+            wxFileName dstFile( exported->second );
+
             (*aOutputFile) << "Transform {\n";
 
             // only write a rotation if it is >= 0.1 deg
@@ -1464,8 +1512,6 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             }
 
         }
-
-        ++sM;
     }
 }
 
@@ -1475,15 +1521,39 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
                                       bool aUsePlainPCB, const wxString& a3D_Subdir,
                                       double aXRef, double aYRef )
 {
-    BOARD*          pcb = GetBoard();
+    wxString error;
+
+    bool ok = ExportBoardToVRML( GetBoard(), Prj().Get3DCacheManager(), Prj().GetProjectPath(),
+                                 aFullFileName, aMMtoWRMLunit, aExport3DFiles,
+                                 aUseRelativePaths, aUsePlainPCB, a3D_Subdir, aXRef, aYRef,
+                                 &error );
+
+    if( !ok )
+        wxMessageBox( error );
+
+    return ok;
+}
+
+
+bool ExportBoardToVRML( BOARD* aPcb, S3D_CACHE* aCache, const wxString& aProjectDir,
+                        const wxString& aFullFileName, double aMMtoWRMLunit,
+                        bool aExport3DFiles, bool aUseRelativePaths, bool aUsePlainPCB,
+                        const wxString& a3D_Subdir, double aXRef, double aYRef,
+                        wxString* aErrorMsg )
+{
+    // The exporter keeps its state in the statics of this file
+    static MUTEX    exportLock;
+    MUTLOCK         lock( exportLock );
+
+    BOARD*          pcb = aPcb;
     bool            ok  = true;
 
     USE_INLINES = aExport3DFiles;
     USE_DEFS = true;
     USE_RELPATH = aUseRelativePaths;
 
-    cache = Prj().Get3DCacheManager();
-    PROJ_DIR = Prj().GetProjectPath();
+    cache = aCache;
+    PROJ_DIR = aProjectDir;
     SUBDIR_3D = a3D_Subdir;
     MODEL_VRML model3d;
     model_vrml = &model3d;
@@ -1583,9 +1653,11 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
     }
     catch( const std::exception& e )
     {
-        wxString msg;
-        msg << _( "IDF Export Failed:\n" ) << FROM_UTF8( e.what() );
-        wxMessageBox( msg );
+        if( aErrorMsg )
+        {
+            aErrorMsg->Clear();
+            *aErrorMsg << _( "IDF Export Failed:\n" ) << FROM_UTF8( e.what() );
+        }
 
         ok = false;
     }
@@ -43,6 +43,7 @@
 #include <class_module.h>
 
 #include <pcbnew.h>
+#include <board_exporters.h>
 #include <wildcards_and_files_ext.h>
 #include <kiface_i.h>
 #include <wx_html_report_panel.h>
@@ -72,11 +73,6 @@
 #define PLACEFILE_OPT_KEY    wxT( "PlaceFileOpts" )
 #define PLACEFILE_FORMAT_KEY wxT( "PlaceFileFormat" )
 
-
-#define PCB_BACK_SIDE 0
-#define PCB_FRONT_SIDE 1
-#define PCB_BOTH_SIDES 2
-
 class LIST_MOD      // An helper class used to build a list of useful footprints.
 {
 public:
@@ -366,8 +362,6 @@ static const char unit_text_inch[] = "## Unit = inches, Angle = deg.\n";
 static const double conv_unit_mm = 1.0 / IU_PER_MM;    // units = mm
 static const char unit_text_mm[] = "## Unit = mm, Angle = deg.\n";
 
-static wxPoint File_Place_Offset;  // Offset coordinates for generated file.
-
 
 // Sort function use by GenereModulesPosition()
 // sort is made by side (layer) top layer first
@@ -417,6 +411,23 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
                                                  bool aUnitsMM,
                                                  bool aForceSmdItems, int aSide,
                                                  bool aFormatCSV )
+{
+    bool modified = false;
+
+    int footprintCount = CreateFootprintsPositionFile( GetBoard(), aFullFileName, aUnitsMM,
+                                                       aForceSmdItems, aSide, aFormatCSV,
+                                                       &modified );
+
+    if( modified )
+        OnModify();
+
+    return footprintCount;
+}
+
+
+int CreateFootprintsPositionFile( BOARD* aBoard, const wxString& aFullFileName,
+                                  bool aUnitsMM, bool aForceSmdItems, int aSide,
+                                  bool aFormatCSV, bool* aBoardModified )
 {
     MODULE*     footprint;
 
@@ -425,7 +436,8 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
     int lenValText = 8;
     int lenPkgText = 16;
 
-    File_Place_Offset = GetAuxOrigin();
+    // Offset coordinates for generated file.
+    wxPoint placeOffset = aBoard->GetAuxOrigin();
 
     // Calculating the number of useful footprints (CMS attribute, not VIRTUAL)
     int footprintCount = 0;
@@ -438,7 +450,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
     std::vector<LIST_MOD> list;
     list.reserve( footprintCount );
 
-    for( footprint = GetBoard()->m_Modules; footprint; footprint = footprint->Next() )
+    for( footprint = aBoard->m_Modules; footprint; footprint = footprint->Next() )
     {
         if( aSide != PCB_BOTH_SIDES )
         {
@@ -463,7 +475,9 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
                 {
                     // all footprint's pins are SMD, mark the part for pick and place
                     footprint->SetAttributes( footprint->GetAttributes() | MOD_CMS );
-                    OnModify();
+
+                    if( aBoardModified )
+                        *aBoardModified = true;
                 }
                 else
                 {
@@ -515,7 +529,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
         {
             wxPoint  footprint_pos;
             footprint_pos  = list[ii].m_Module->GetPosition();
-            footprint_pos -= File_Place_Offset;
+            footprint_pos -= placeOffset;
 
             LAYER_NUM layer = list[ii].m_Module->GetLayer();
             wxASSERT( layer == F_Cu || layer == B_Cu );
@@ -546,7 +560,8 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
         // Write file header
         fprintf( file, "### Module positions - created on %s ###\n", TO_UTF8( DateAndTime() ) );
 
-        wxString Title = Pgm().App().GetAppName() + wxT( " " ) + GetBuildVersion();
+        // Not Pgm().App(): there is no program when run from the batch runner
+        wxString Title = wxTheApp->GetAppName() + wxT( " " ) + GetBuildVersion();
         fprintf( file, "### Printed by Pcbnew version %s\n", TO_UTF8( Title ) );
 
         fputs( unit_text, file );
@@ -572,7 +587,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
         {
             wxPoint  footprint_pos;
             footprint_pos  = list[ii].m_Module->GetPosition();
-            footprint_pos -= File_Place_Offset;
+            footprint_pos -= placeOffset;
 
             LAYER_NUM layer = list[ii].m_Module->GetLayer();
             wxASSERT( layer == F_Cu || layer == B_Cu );
@@ -641,8 +656,7 @@ bool PCB_EDIT_FRAME::DoGenFootprintsReport( const wxString& aFullFilename, bool
     wxString msg;
     FILE*    rptfile;
     wxPoint  module_pos;
-
-    File_Place_Offset = wxPoint( 0, 0 );
+    wxPoint  placeOffset( 0, 0 );
 
     rptfile = wxFopen( aFullFilename, wxT( "wt" ) );
 
@@ -702,8 +716,8 @@ bool PCB_EDIT_FRAME::DoGenFootprintsReport( const wxString& aFullFilename, bool
         fputs( TO_UTF8( msg ), rptfile );
 
         module_pos    = Module->GetPosition();
-        module_pos.x -= File_Place_Offset.x;
-        module_pos.y -= File_Place_Offset.y;
+        module_pos.x -= placeOffset.x;
+        module_pos.y -= placeOffset.y;
 
         fprintf( rptfile, "position %9.6f %9.6f  orientation %.2f\n",
                  module_pos.x * conv_unit,
@@ -0,0 +1,565 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fab_manifest.cpp
+ * @brief Creation of the fabrication outputs of a board from a manifest file.
+ */
+
+#include <fctsys.h>
+#include <common.h>
+#include <dsnlexer.h>
+#include <profile.h>
+#include <reporter.h>
+#include <plot_common.h>
+#include <wildcards_and_files_ext.h>
+
+#include <class_board.h>
+#include <io_mgr.h>
+#include <pcbplot.h>
+#include <board_exporters.h>
+#include <gendrill_Excellon_writer.h>
+#include <gendrill_gerber_writer.h>
+#include <3d_cache/3d_cache.h>
+#include <fab_manifest.h>
+
+#include <wx/filename.h>
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+
+static const KEYWORD empty_keywords[1] = {};
+
+
+/**
+ * Keeps the messages of a task, which runs in a worker thread, to report them
+ * afterwards in the manifest order.
+ */
+class TASK_REPORTER : public REPORTER
+{
+public:
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override
+    {
+        m_messages.push_back( std::make_pair( aText, aSeverity ) );
+        return *this;
+    }
+
+    void ReportTo( REPORTER& aReporter ) const
+    {
+        for( const auto& msg : m_messages )
+            aReporter.Report( msg.first, msg.second );
+    }
+
+private:
+    std::vector< std::pair<wxString, SEVERITY> > m_messages;
+};
+
+
+/**
+ * One output file (or set of files) of a job.
+ */
+struct FAB_TASK
+{
+    wxString                            m_name;
+    std::function<bool( REPORTER& )>    m_run;
+    std::unique_ptr<PLOTTER>            m_plotter;      ///< of a plot task, owns the file
+    bool                                m_modifiesBoard;
+    TASK_REPORTER                       m_reporter;
+    double                              m_msecs;
+    bool                                m_success;
+};
+
+
+static void runTask( FAB_TASK& aTask )
+{
+    PROF_COUNTER timer;
+
+    // Exceptions must not leave an OpenMP parallel region
+    try
+    {
+        aTask.m_success = aTask.m_run( aTask.m_reporter );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aTask.m_reporter.Report( ioe.What(), REPORTER::RPT_ERROR );
+    }
+    catch( const std::exception& e )
+    {
+        aTask.m_reporter.Report( FROM_UTF8( e.what() ), REPORTER::RPT_ERROR );
+    }
+
+    // Close the plot file now, even if the plot failed
+    aTask.m_plotter.reset();
+
+    aTask.m_msecs += timer.msecs();
+}
+
+
+static void needSymbol( DSNLEXER& aLexer, const char* aSymbol )
+{
+    if( aLexer.NextTok() != DSN_SYMBOL || strcmp( aLexer.CurText(), aSymbol ) != 0 )
+        aLexer.Expecting( aSymbol );
+}
+
+
+void FAB_MANIFEST::Load( const wxString& aFileName )
+{
+    static const struct
+    {
+        const char* m_name;
+        JOB_TYPE    m_type;
+    } jobNames[] =
+    {
+        { "gerber",         JOB_GERBER },
+        { "pdf",            JOB_PDF },
+        { "svg",            JOB_SVG },
+        { "excellon",       JOB_EXCELLON },
+        { "gerber_drill",   JOB_GERBER_DRILL },
+        { "position",       JOB_POSITION },
+        { "ipc356",         JOB_IPC356 },
+        { "vrml",           JOB_VRML },
+    };
+
+    FILE* fp = wxFopen( aFileName, wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open manifest file '%s'." ),
+                                          GetChars( aFileName ) ) );
+
+    // lexer now owns fp, will close on exception or return
+    DSNLEXER lexer( empty_keywords, 0, fp, aFileName );
+
+    m_outputDirectory.Clear();
+    m_jobs.clear();
+
+    lexer.NeedLEFT();
+    needSymbol( lexer, "fab_manifest" );
+
+    int tok;
+
+    while( ( tok = lexer.NextTok() ) != DSN_RIGHT )
+    {
+        if( tok != DSN_LEFT )
+            lexer.Expecting( DSN_LEFT );
+
+        if( lexer.NextTok() != DSN_SYMBOL )
+            lexer.Expecting( "output_directory or a job name" );
+
+        std::string name = lexer.CurText();
+
+        if( name == "output_directory" )
+        {
+            tok = lexer.NextTok();
+
+            if( tok == DSN_LEFT || tok == DSN_RIGHT || tok == DSN_EOF )
+                lexer.Expecting( "directory name" );
+
+            m_outputDirectory = lexer.FromUTF8();
+            lexer.NeedRIGHT();
+            continue;
+        }
+
+        JOB job;
+        bool found = false;
+
+        for( const auto& jobName : jobNames )
+        {
+            if( name == jobName.m_name )
+            {
+                job.m_type = jobName.m_type;
+                found = true;
+            }
+        }
+
+        if( !found )
+            lexer.Unexpected( lexer.CurText() );
+
+        while( ( tok = lexer.NextTok() ) != DSN_RIGHT )
+        {
+            if( tok == DSN_LEFT || tok == DSN_EOF )
+                lexer.Unexpected( tok );
+
+            job.m_options.Add( lexer.FromUTF8() );
+        }
+
+        m_jobs.push_back( job );
+    }
+}
+
+
+/**
+ * Builds the plot tasks of a plot job, one per layer.  The plot files are created here,
+ * serially, like PlotBoardLayers() does.
+ */
+static bool createPlotTasks( BOARD* aBoard, PCB_PLOT_PARAMS& aPlotOpts,
+                             const wxArrayString& aLayerNames, const wxString& aOutputDir,
+                             std::vector<FAB_TASK>& aTasks, REPORTER& aReporter )
+{
+    bool success = true;
+
+    for( const wxString& layerName : aLayerNames )
+    {
+        PCB_LAYER_ID layer = aBoard->GetLayerID( layerName );
+
+        if( layer == UNDEFINED_LAYER )
+        {
+            aReporter.Report( wxString::Format( _( "Unknown layer '%s'." ),
+                                                GetChars( layerName ) ),
+                              REPORTER::RPT_ERROR );
+            success = false;
+            continue;
+        }
+
+        wxFileName  fn( aBoard->GetFileName() );
+        wxString    fileExt = GetDefaultPlotExtension( aPlotOpts.GetFormat() );
+
+        if( aPlotOpts.GetFormat() == PLOT_FORMAT_GERBER && aPlotOpts.GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, aOutputDir, aBoard->GetLayerName( layer ), fileExt );
+
+        wxString    fullFileName = fn.GetFullPath();
+        PROF_COUNTER timer;
+        PLOTTER*    plotter = StartPlotBoard( aBoard, &aPlotOpts, layer, fullFileName,
+                                              wxEmptyString );
+        double      startMsecs = timer.msecs();
+
+        FAB_TASK task;
+
+        // The task owns the plotter, which closes the file if the task never runs
+        task.m_name = fullFileName;
+        task.m_plotter.reset( plotter );
+        task.m_modifiesBoard = false;
+        task.m_msecs = startMsecs;
+        task.m_success = false;
+
+        task.m_run = [aBoard, &aPlotOpts, layer, plotter, fullFileName]( REPORTER& aTaskReporter )
+        {
+            if( !plotter )
+            {
+                aTaskReporter.Report( wxString::Format( _( "Unable to create file '%s'." ),
+                                                        GetChars( fullFileName ) ),
+                                      REPORTER::RPT_ERROR );
+                return false;
+            }
+
+            PlotOneBoardLayer( aBoard, plotter, layer, aPlotOpts );
+            plotter->EndPlot();
+
+            aTaskReporter.Report( wxString::Format( _( "Plot file '%s' created." ),
+                                                    GetChars( fullFileName ) ),
+                                  REPORTER::RPT_ACTION );
+            return true;
+        };
+
+        aTasks.push_back( std::move( task ) );
+    }
+
+    return success;
+}
+
+
+bool FAB_MANIFEST::Run( BOARD* aBoard, REPORTER& aReporter )
+{
+    // The locale is global: it must be set before the tasks start, and restored after
+    // they finish.
+    LOCALE_IO   toggle;
+    PROF_COUNTER timer;
+    bool        success = true;
+
+    const PCB_PLOT_PARAMS& boardPlotOpts = aBoard->GetPlotOptions();
+    wxString    boardFilename = aBoard->GetFileName();
+    wxFileName  outputDir = wxFileName::DirName( m_outputDirectory.IsEmpty() ?
+                                                 boardPlotOpts.GetOutputDirectory() :
+                                                 m_outputDirectory );
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename, &aReporter ) )
+    {
+        aReporter.Report( wxString::Format( _( "Could not write plot files to folder '%s'." ),
+                                            GetChars( outputDir.GetPath() ) ),
+                          REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    wxString    outputPath = outputDir.GetPath();
+    wxPoint     drillOffset = boardPlotOpts.GetUseAuxOrigin() ? aBoard->GetAuxOrigin()
+                                                              : wxPoint( 0, 0 );
+
+    // The plot options of each job, they must not move while the tasks run
+    std::vector<PCB_PLOT_PARAMS>    plotOpts( m_jobs.size(), boardPlotOpts );
+    std::unique_ptr<S3D_CACHE>      cache3D;
+    std::vector<FAB_TASK>           tasks;
+
+    for( unsigned ii = 0; ii < m_jobs.size(); ++ii )
+    {
+        const JOB&  job = m_jobs[ii];
+        FAB_TASK    task;
+        wxFileName  fn( boardFilename );
+
+        task.m_modifiesBoard = false;
+        task.m_msecs = 0.0;
+        task.m_success = false;
+        fn.SetPath( outputPath );
+
+        switch( job.m_type )
+        {
+        case JOB_GERBER:
+        case JOB_PDF:
+        case JOB_SVG:
+            plotOpts[ii].SetFormat( job.m_type == JOB_GERBER ? PLOT_FORMAT_GERBER :
+                                    job.m_type == JOB_PDF ? PLOT_FORMAT_PDF : PLOT_FORMAT_SVG );
+
+            success &= createPlotTasks( aBoard, plotOpts[ii], job.m_options, outputPath,
+                                        tasks, aReporter );
+            continue;
+
+        case JOB_EXCELLON:
+            task.m_name = _( "Excellon drill files" );
+            task.m_run = [aBoard, outputPath, drillOffset]( REPORTER& aTaskReporter )
+            {
+                EXCELLON_WRITER writer( aBoard );
+                writer.SetFormat( true );
+                writer.SetOptions( false, false, drillOffset, false );
+                writer.CreateDrillandMapFilesSet( outputPath, true, false, &aTaskReporter );
+                return true;
+            };
+            break;
+
+        case JOB_GERBER_DRILL:
+            task.m_name = _( "Gerber drill files" );
+            task.m_run = [aBoard, &boardPlotOpts, outputPath, drillOffset]( REPORTER& aTaskReporter )
+            {
+                GERBER_WRITER writer( aBoard );
+                writer.SetFormat( boardPlotOpts.GetGerberPrecision() );
+                writer.SetOptions( drillOffset );
+                writer.CreateDrillandMapFilesSet( outputPath, true, false, &aTaskReporter );
+                return true;
+            };
+            break;
+
+        case JOB_POSITION:
+        {
+            int     side = PCB_BOTH_SIDES;
+            bool    csv = job.m_options.Index( wxT( "csv" ) ) != wxNOT_FOUND;
+            bool    unitsMM = job.m_options.Index( wxT( "inch" ) ) == wxNOT_FOUND;
+
+            if( job.m_options.Index( wxT( "front" ) ) != wxNOT_FOUND )
+                side = PCB_FRONT_SIDE;
+            else if( job.m_options.Index( wxT( "back" ) ) != wxNOT_FOUND )
+                side = PCB_BACK_SIDE;
+
+            // Same names as the footprint position file dialog
+            fn.SetName( fn.GetName() + wxT( "-" ) + ( side == PCB_FRONT_SIDE ? wxT( "top" ) :
+                                                      side == PCB_BACK_SIDE ? wxT( "bottom" ) :
+                                                      wxT( "all" ) ) );
+
+            if( csv )
+            {
+                fn.SetName( fn.GetName() + wxT( "-" ) + FootprintPlaceFileExtension );
+                fn.SetExt( wxT( "csv" ) );
+            }
+            else
+                fn.SetExt( FootprintPlaceFileExtension );
+
+            wxString fullFileName = fn.GetFullPath();
+
+            task.m_name = fullFileName;
+            task.m_run = [aBoard, fullFileName, unitsMM, side, csv]( REPORTER& aTaskReporter )
+            {
+                // Footprints are not forced to SMD: the board must not be modified
+                int count = CreateFootprintsPositionFile( aBoard, fullFileName, unitsMM,
+                                                          false, side, csv );
+
+                if( count < 0 )
+                {
+                    aTaskReporter.Report( wxString::Format( _( "Unable to create file '%s'." ),
+                                                            GetChars( fullFileName ) ),
+                                          REPORTER::RPT_ERROR );
+                    return false;
+                }
+
+                aTaskReporter.Report( wxString::Format( _( "Place file: '%s', component count: %d." ),
+                                                        GetChars( fullFileName ), count ),
+                                      REPORTER::RPT_ACTION );
+                return true;
+            };
+            break;
+        }
+
+        case JOB_IPC356:
+        {
+            fn.SetExt( wxT( "d356" ) );
+
+            wxString fullFileName = fn.GetFullPath();
+
+            task.m_name = fullFileName;
+            task.m_run = [aBoard, fullFileName]( REPORTER& aTaskReporter )
+            {
+                if( !CreateD356File( aBoard, fullFileName ) )
+                {
+                    aTaskReporter.Report( wxString::Format( _( "Unable to create file '%s'." ),
+                                                            GetChars( fullFileName ) ),
+                                          REPORTER::RPT_ERROR );
+                    return false;
+                }
+
+                aTaskReporter.Report( wxString::Format( _( "IPC-D-356 file '%s' created." ),
+                                                        GetChars( fullFileName ) ),
+                                      REPORTER::RPT_ACTION );
+                return true;
+            };
+            break;
+        }
+
+        case JOB_VRML:
+        {
+            fn.SetExt( VrmlFileExtension );
+
+            wxString fullFileName = fn.GetFullPath();
+            wxString projectDir = wxFileName( boardFilename ).GetPath();
+
+            // There is no project: the models are searched from the board directory and
+            // the environment variables only.
+            if( !cache3D )
+            {
+                wxFileName cfgpath;
+                cfgpath.AssignDir( GetKicadConfigPath() );
+                cfgpath.AppendDir( wxT( "3d" ) );
+
+                cache3D.reset( new S3D_CACHE );
+                cache3D->Set3DConfigDir( cfgpath.GetFullPath() );
+                cache3D->SetProjectDir( projectDir );
+            }
+
+            S3D_CACHE* cache = cache3D.get();
+
+            // The export fills the zones which are not filled yet, while the plots read them
+            task.m_name = fullFileName;
+            task.m_modifiesBoard = true;
+            task.m_run = [aBoard, cache, projectDir, fullFileName]( REPORTER& aTaskReporter )
+            {
+                wxString error;
+
+                // mm units, models embedded in the file, board origin
+                if( !ExportBoardToVRML( aBoard, cache, projectDir, fullFileName, 1.0,
+                                        false, false, false, wxEmptyString, 0.0, 0.0, &error ) )
+                {
+                    aTaskReporter.Report( error, REPORTER::RPT_ERROR );
+                    return false;
+                }
+
+                aTaskReporter.Report( wxString::Format( _( "VRML file '%s' created." ),
+                                                        GetChars( fullFileName ) ),
+                                      REPORTER::RPT_ACTION );
+                return true;
+            };
+            break;
+        }
+        }
+
+        tasks.push_back( std::move( task ) );
+    }
+
+    // The outputs which only read the board are created concurrently
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < (int) tasks.size(); ++ii )
+    {
+        if( !tasks[ii].m_modifiesBoard )
+            runTask( tasks[ii] );
+    }
+
+    // The others afterwards, one at a time
+    for( FAB_TASK& task : tasks )
+    {
+        if( task.m_modifiesBoard )
+            runTask( task );
+    }
+
+    for( const FAB_TASK& task : tasks )
+    {
+        task.m_reporter.ReportTo( aReporter );
+        aReporter.Report( wxString::Format( _( "%s: %.1f ms" ), GetChars( task.m_name ),
+                                            task.m_msecs ),
+                          REPORTER::RPT_INFO );
+        success &= task.m_success;
+    }
+
+    aReporter.Report( wxString::Format( _( "%u outputs created in %.1f ms." ),
+                                        (unsigned) tasks.size(), timer.msecs() ),
+                      REPORTER::RPT_INFO );
+
+    return success;
+}
+
+
+bool RunFabManifest( const wxString& aBoardFileName, const wxString& aManifestFileName,
+                     REPORTER& aReporter )
+{
+    FAB_MANIFEST            manifest;
+    std::unique_ptr<BOARD>  board;
+
+    try
+    {
+        manifest.Load( aManifestFileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aReporter.Report( ioe.What(), REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    // Same plugin choice as the scripting LoadBoard()
+    IO_MGR::PCB_FILE_T  pluginType = IO_MGR::LEGACY;
+    PROF_COUNTER        timer;
+
+    if( wxFileName( aBoardFileName ).GetExt() == KiCadPcbFileExtension )
+        pluginType = IO_MGR::KICAD;
+
+    try
+    {
+        board.reset( IO_MGR::Load( pluginType, aBoardFileName ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aReporter.Report( ioe.What(), REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    if( !board )
+    {
+        aReporter.Report( wxString::Format( _( "Unable to load board '%s'." ),
+                                            GetChars( aBoardFileName ) ),
+                          REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    aReporter.Report( wxString::Format( _( "Board '%s' loaded in %.1f ms." ),
+                                        GetChars( aBoardFileName ), timer.msecs() ),
+                      REPORTER::RPT_INFO );
+
+    return manifest.Run( board.get(), aReporter );
+}
@@ -0,0 +1,122 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FAB_MANIFEST_H_
+#define FAB_MANIFEST_H_
+
+#include <vector>
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+class BOARD;
+class REPORTER;
+
+
+/**
+ * Class FAB_MANIFEST
+ * is the list of the fabrication outputs to create from a board, read from a
+ * manifest file such as:
+ * <pre>
+ * (fab_manifest
+ *   (output_directory "fab")
+ *   (gerber F.Cu B.Cu F.Mask B.Mask F.SilkS B.SilkS Edge.Cuts)
+ *   (pdf F.Fab B.Fab)
+ *   (svg F.Cu)
+ *   (excellon)
+ *   (gerber_drill)
+ *   (position both csv mm)
+ *   (ipc356)
+ *   (vrml)
+ * )
+ * </pre>
+ * The plot jobs use the plot options stored in the board, as the plot dialog does.
+ * output_directory is optional and relative to the board file; the output directory of
+ * the board plot options is used when it is missing.
+ *
+ * The outputs which only read the board are created concurrently: each plotted layer,
+ * drill file set, position file, ... is a separate task.  The VRML export fills the zones
+ * which are not filled yet, so it runs after them.
+ */
+class FAB_MANIFEST
+{
+public:
+    enum JOB_TYPE
+    {
+        JOB_GERBER,
+        JOB_PDF,
+        JOB_SVG,
+        JOB_EXCELLON,
+        JOB_GERBER_DRILL,
+        JOB_POSITION,
+        JOB_IPC356,
+        JOB_VRML
+    };
+
+    struct JOB
+    {
+        JOB_TYPE        m_type;
+        wxArrayString   m_options;      ///< layer names for plots, options otherwise
+    };
+
+    /**
+     * Function Load
+     * reads a manifest file.
+     * @throw IO_ERROR if the file cannot be read, or PARSE_ERROR if it is malformed.
+     */
+    void Load( const wxString& aFileName );
+
+    /**
+     * Function Run
+     * creates all the outputs of the manifest, and reports the created files, the errors
+     * and the time spent for each output, in the manifest order.
+     * @return true if all the outputs were created
+     */
+    bool Run( BOARD* aBoard, REPORTER& aReporter );
+
+    const std::vector<JOB>& GetJobs() const { return m_jobs; }
+
+private:
+    wxString            m_outputDirectory;
+    std::vector<JOB>    m_jobs;
+};
+
+
+/**
+ * Function RunFabManifest
+ * loads a board and creates the outputs listed in a manifest file, see FAB_MANIFEST.
+ * The board is loaded once for all the outputs.
+ *
+ * It is exported by the pcbnew kiface (see KIFACE_RUN_FAB_MANIFEST) for the pcbnew_batch
+ * command line launcher.  It does not need a project, nor a program (Pgm()), nor a frame.
+ * @return true if all the outputs were created
+ */
+bool RunFabManifest( const wxString& aBoardFileName, const wxString& aManifestFileName,
+                     REPORTER& aReporter );
+
+/// The type of RunFabManifest(), as returned by KIFACE::IfaceOrAddress()
+typedef bool FAB_MANIFEST_RUNNER( const wxString& aBoardFileName,
+                                  const wxString& aManifestFileName,
+                                  REPORTER& aReporter );
+
+#endif  // FAB_MANIFEST_H_
@@ -26,6 +26,7 @@
 #include <common.h>
 #include <fctsys.h>
 #include <footprint_info.h>
+#include <fp_shared_cache.h>
 #include <fp_lib_table.h>
 #include <html_messagebox.h>
 #include <io_mgr.h>
@@ -35,11 +36,18 @@
 #include <macros.h>
 #include <make_unique.h>
 #include <pgm_base.h>
+#include <profile.h>
 #include <wildcards_and_files_ext.h>
 
 #include <thread>
 
 
+/**
+ * Trace mask to log the footprint list loading times.
+ */
+static const wxChar traceFootprintList[] = wxT( "KicadFootprintList" );
+
+
 void FOOTPRINT_INFO_IMPL::load()
 {
     FP_LIB_TABLE* fptable = m_owner->GetTable();
@@ -103,6 +111,23 @@ void FOOTPRINT_LIST_IMPL::loader_job()
     while( m_queue_in.pop( nickname ) )
     {
         CatchErrors( [this, &nickname]() {
+            const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( nickname );
+            wxString path = row->GetFullURI( true );
+            wxString signature = FOOTPRINT_INFO_INDEX::LibrarySignature( path, row->GetType() );
+            FOOTPRINT_INFO_INDEX::ENTRIES entries;
+
+            // Libraries which did not change since they were indexed are not parsed at all
+            if( FOOTPRINT_INFO_INDEX::GetIndex().Find( path, signature, entries ) )
+            {
+                m_queue_indexed.move_push( INDEXED_LIB( nickname, std::move( entries ) ) );
+                return;
+            }
+
+            {
+                MUTLOCK lock( m_lib_signatures_lock );
+                m_lib_signatures[nickname] = LIB_SIGNATURE( path, signature );
+            }
+
             m_lib_table->PrefetchLib( nickname );
             m_queue_out.push( nickname );
         } );
@@ -124,10 +149,25 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname )
 {
     FOOTPRINT_ASYNC_LOADER loader;
+    PROF_COUNTER           timer;
 
     loader.SetList( this );
     loader.Start( aTable, aNickname );
-    return loader.Join();
+
+    bool ok = loader.Join();
+
+    wxLogTrace( traceFootprintList, wxT( "Read %u footprints in %.1f ms" ),
+                GetCount(), timer.msecs() );
+
+    FP_SHARED_CACHE::STATS stats = FP_SHARED_CACHE::GetCache().GetStats();
+
+    wxLogTrace( traceFootprintList,
+                wxT( "Footprint cache: %llu hits, %llu misses, %llu evictions, %u footprints (%u kB)" ),
+                (unsigned long long) stats.m_hits, (unsigned long long) stats.m_misses,
+                (unsigned long long) stats.m_evictions, (unsigned) stats.m_count,
+                (unsigned) ( stats.m_memoryUsage >> 10 ) );
+
+    return ok;
 }
 
 
@@ -145,6 +185,8 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_queue_indexed.clear();
+    m_lib_signatures.clear();
 
     if( aNickname )
         m_queue_in.push( *aNickname );
@@ -190,6 +232,7 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
             while( this->m_queue_out.pop( nickname ) )
             {
                 wxArrayString fpnames;
+                bool          indexable = true;
 
                 try
                 {
@@ -197,6 +240,7 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                 }
                 catch( const IO_ERROR& ioe )
                 {
+                    indexable = false;
                     m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
                 }
                 catch( const std::exception& se )
@@ -211,13 +255,52 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                     {
                         m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
                     }
+
+                    indexable = false;
                 }
 
+                FOOTPRINT_INFO_INDEX::ENTRIES entries;
+
                 for( auto const& fpname : fpnames )
                 {
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
+                    FOOTPRINT_INFO_IMPL* fpinfo = nullptr;
+
+                    // Footprints are parsed on demand by the plugins, so a broken footprint
+                    // file is only detected here
+                    try
+                    {
+                        fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
+                        indexable = false;
+                        continue;
+                    }
+
+                    // Broken footprints are not indexed, so their errors are reported again
+                    if( fpinfo->IsLoaded() )
+                        entries.push_back( { fpinfo->GetFootprintName(), (int) fpinfo->GetPadCount(),
+                                             (int) fpinfo->GetUniquePadCount(), fpinfo->GetDoc(),
+                                             fpinfo->GetKeywords() } );
+                    else
+                        indexable = false;
+
                     queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
                 }
+
+                if( indexable )
+                {
+                    LIB_SIGNATURE signature;
+
+                    {
+                        MUTLOCK lock( m_lib_signatures_lock );
+                        signature = m_lib_signatures[nickname];
+                    }
+
+                    FOOTPRINT_INFO_INDEX::GetIndex().Store( signature.first, signature.second,
+                                                            entries );
+                }
             }
         } ) );
     }
@@ -230,6 +313,16 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     while( queue_parsed.pop( fpi ) )
         m_list.push_back( std::move( fpi ) );
 
+    INDEXED_LIB indexed;
+
+    while( m_queue_indexed.pop( indexed ) )
+    {
+        for( const FOOTPRINT_INFO_INDEX::ENTRY& entry : indexed.second )
+            m_list.push_back( std::make_unique<FOOTPRINT_INFO_IMPL>( this, indexed.first, entry ) );
+    }
+
+    FOOTPRINT_INFO_INDEX::GetIndex().Save();
+
     std::sort( m_list.begin(), m_list.end(),
             []( std::unique_ptr<FOOTPRINT_INFO> const&     lhs,
                     std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool { return *lhs < *rhs; } );
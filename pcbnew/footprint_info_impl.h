@@ -23,11 +23,14 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <footprint_info.h>
+#include <footprint_info_index.h>
 #include <sync_queue.h>
 
 class LOCALE_IO;
@@ -50,6 +53,23 @@ public:
 #endif
     }
 
+    /// Create a footprint info from the fields stored in the FOOTPRINT_INFO_INDEX
+    FOOTPRINT_INFO_IMPL( FOOTPRINT_LIST* aOwner, const wxString& aNickname,
+            const FOOTPRINT_INFO_INDEX::ENTRY& aEntry )
+    {
+        m_owner = aOwner;
+        m_loaded = true;
+        m_nickname = aNickname;
+        m_fpname = aEntry.m_fpname;
+        m_num = 0;
+        m_pad_count = aEntry.m_pad_count;
+        m_unique_pad_count = aEntry.m_unique_pad_count;
+        m_doc = aEntry.m_doc;
+        m_keywords = aEntry.m_keywords;
+    }
+
+    bool IsLoaded() const { return m_loaded; }
+
 protected:
     virtual void load() override;
 };
@@ -64,6 +84,16 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     std::atomic_size_t       m_count_finished;
     std::atomic_bool         m_first_to_finish;
 
+    typedef std::pair<wxString, FOOTPRINT_INFO_INDEX::ENTRIES> INDEXED_LIB;
+    typedef std::pair<wxString, wxString>                      LIB_SIGNATURE;
+
+    /// Libraries unchanged since they were stored in the FOOTPRINT_INFO_INDEX
+    SYNC_QUEUE<INDEXED_LIB>                 m_queue_indexed;
+
+    /// Full path and signature of the libraries to parse, per nickname
+    std::map<wxString, LIB_SIGNATURE>       m_lib_signatures;
+    MUTEX                                   m_lib_signatures_lock;
+
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
      *
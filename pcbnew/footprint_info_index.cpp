@@ -0,0 +1,322 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <footprint_info_index.h>
+
+#include <common.h>
+#include <dsnlexer.h>
+#include <richio.h>
+
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+
+/// Index files of another version are ignored, and rebuilt.
+static const int INDEX_VERSION = 1;
+
+static const KEYWORD empty_keywords[1] = {};
+
+
+FOOTPRINT_INFO_INDEX& FOOTPRINT_INFO_INDEX::GetIndex()
+{
+    static FOOTPRINT_INFO_INDEX* index = nullptr;
+    static MUTEX                 lock;
+
+    MUTLOCK locker( lock );
+
+    if( !index )
+    {
+        wxFileName fn;
+
+        fn.AssignDir( GetKicadConfigPath() );
+        fn.SetFullName( wxT( "fp-info-index" ) );
+
+        // Deliberately never deleted, the index lives as long as the process
+        index = new FOOTPRINT_INFO_INDEX( fn.GetFullPath() );
+    }
+
+    return *index;
+}
+
+
+FOOTPRINT_INFO_INDEX::FOOTPRINT_INFO_INDEX( const wxString& aFileName ) :
+    m_fileName( aFileName ),
+    m_modified( false )
+{
+    try
+    {
+        load();
+    }
+    catch( const IO_ERROR& )
+    {
+        // A broken index is discarded, it will be rebuilt from the libraries
+        m_libraries.clear();
+    }
+}
+
+
+static void hashValue( uint64_t& aHash, uint64_t aValue )
+{
+    // FNV-1a, one byte at a time
+    for( int i = 0; i < 8; ++i )
+    {
+        aHash ^= ( aValue >> ( i * 8 ) ) & 0xff;
+        aHash *= 1099511628211ULL;
+    }
+}
+
+
+static void hashString( uint64_t& aHash, const wxString& aString )
+{
+    for( wxUniChar c : aString )
+        hashValue( aHash, c.GetValue() );
+}
+
+
+static bool hashFile( uint64_t& aHash, const wxString& aFileName )
+{
+    wxStructStat st;
+
+    if( wxStat( aFileName, &st ) != 0 )
+        return false;
+
+    hashValue( aHash, st.st_size );
+    hashValue( aHash, st.st_mtime );
+    return true;
+}
+
+
+wxString FOOTPRINT_INFO_INDEX::LibrarySignature( const wxString& aLibraryPath,
+                                                 const wxString& aLibraryType )
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    hashString( hash, aLibraryType );
+
+    if( wxDirExists( aLibraryPath ) )
+    {
+        // A footprint can be edited in place, which does not change the directory time
+        // stamp: every file has to be checked.  This is still much cheaper than parsing.
+        wxDir           dir( aLibraryPath );
+        wxArrayString   files;
+        wxString        name;
+
+        if( !dir.IsOpened() )
+            return wxEmptyString;
+
+        for( bool cont = dir.GetFirst( &name, wxEmptyString, wxDIR_FILES | wxDIR_HIDDEN );
+             cont; cont = dir.GetNext( &name ) )
+        {
+            files.Add( name );
+        }
+
+        files.Sort();
+
+        for( const wxString& file : files )
+        {
+            hashString( hash, file );
+
+            if( !hashFile( hash, aLibraryPath + wxFileName::GetPathSeparator() + file ) )
+                return wxEmptyString;
+        }
+
+        hashValue( hash, files.size() );
+    }
+    else if( !hashFile( hash, aLibraryPath ) )
+    {
+        // Not a local library (e.g. a GitHub URL), it cannot be checked cheaply
+        return wxEmptyString;
+    }
+
+    return wxString::Format( wxT( "%016llx" ), (unsigned long long) hash );
+}
+
+
+bool FOOTPRINT_INFO_INDEX::Find( const wxString& aLibraryPath, const wxString& aSignature,
+                                 ENTRIES& aEntries )
+{
+    MUTLOCK locker( m_lock );
+
+    auto it = m_libraries.find( aLibraryPath );
+
+    if( aSignature.IsEmpty() || it == m_libraries.end() || it->second.m_signature != aSignature )
+        return false;
+
+    aEntries = it->second.m_footprints;
+    return true;
+}
+
+
+void FOOTPRINT_INFO_INDEX::Store( const wxString& aLibraryPath, const wxString& aSignature,
+                                  const ENTRIES& aEntries )
+{
+    if( aSignature.IsEmpty() )
+        return;
+
+    MUTLOCK locker( m_lock );
+
+    LIBRARY& lib = m_libraries[aLibraryPath];
+
+    lib.m_signature = aSignature;
+    lib.m_footprints = aEntries;
+    m_modified = true;
+}
+
+
+void FOOTPRINT_INFO_INDEX::Clear()
+{
+    MUTLOCK locker( m_lock );
+
+    m_libraries.clear();
+    m_modified = true;
+}
+
+
+void FOOTPRINT_INFO_INDEX::Save()
+{
+    MUTLOCK locker( m_lock );
+
+    if( !m_modified )
+        return;
+
+    wxFileName fn( m_fileName );
+    wxString   tempFileName = fn.CreateTempFileName( fn.GetPath() );
+
+    try
+    {
+        // Write a temporary file first, so concurrent readers never see a partial index
+        {
+            FILE_OUTPUTFORMATTER formatter( tempFileName );
+
+            formatter.Print( 0, "(fp_info_index %d\n", INDEX_VERSION );
+
+            for( const auto& lib : m_libraries )
+            {
+                formatter.Print( 1, "(lib %s %s\n",
+                                 formatter.Quotew( lib.first ).c_str(),
+                                 formatter.Quotew( lib.second.m_signature ).c_str() );
+
+                for( const ENTRY& entry : lib.second.m_footprints )
+                {
+                    formatter.Print( 2, "(fp %s %d %d %s %s)\n",
+                                     formatter.Quotew( entry.m_fpname ).c_str(),
+                                     entry.m_pad_count,
+                                     entry.m_unique_pad_count,
+                                     formatter.Quotew( entry.m_doc ).c_str(),
+                                     formatter.Quotew( entry.m_keywords ).c_str() );
+                }
+
+                formatter.Print( 1, ")\n" );
+            }
+
+            formatter.Print( 0, ")\n" );
+        }
+
+        // The previous index is replaced by the rename, it is never removed first
+        if( wxRenameFile( tempFileName, m_fileName, true ) )
+            m_modified = false;
+    }
+    catch( const IO_ERROR& )
+    {
+    }
+
+    if( wxFileExists( tempFileName ) )
+        wxRemove( tempFileName );
+}
+
+
+static void needSymbol( DSNLEXER& aLexer, const char* aSymbol )
+{
+    if( aLexer.NextTok() != DSN_SYMBOL || strcmp( aLexer.CurText(), aSymbol ) != 0 )
+        aLexer.Expecting( aSymbol );
+}
+
+
+static wxString needString( DSNLEXER& aLexer )
+{
+    int tok = aLexer.NextTok();
+
+    if( tok == DSN_LEFT || tok == DSN_RIGHT || tok == DSN_EOF )
+        aLexer.Expecting( "string" );
+
+    return aLexer.FromUTF8();
+}
+
+
+static int needInt( DSNLEXER& aLexer )
+{
+    aLexer.NeedNUMBER( "integer" );
+    return atoi( aLexer.CurText() );
+}
+
+
+void FOOTPRINT_INFO_INDEX::load()
+{
+    FILE* fp = wxFopen( m_fileName, wxT( "rt" ) );
+
+    if( !fp )
+        return;
+
+    // lexer now owns fp, will close on exception or return
+    DSNLEXER lexer( empty_keywords, 0, fp, m_fileName );
+
+    lexer.NeedLEFT();
+    needSymbol( lexer, "fp_info_index" );
+
+    if( needInt( lexer ) != INDEX_VERSION )
+        return;
+
+    int tok;
+
+    while( ( tok = lexer.NextTok() ) != DSN_RIGHT )
+    {
+        if( tok != DSN_LEFT )
+            lexer.Expecting( DSN_LEFT );
+
+        needSymbol( lexer, "lib" );
+
+        LIBRARY& lib = m_libraries[needString( lexer )];
+
+        lib.m_signature = needString( lexer );
+
+        while( ( tok = lexer.NextTok() ) != DSN_RIGHT )
+        {
+            if( tok != DSN_LEFT )
+                lexer.Expecting( DSN_LEFT );
+
+            needSymbol( lexer, "fp" );
+
+            ENTRY entry;
+
+            entry.m_fpname = needString( lexer );
+            entry.m_pad_count = needInt( lexer );
+            entry.m_unique_pad_count = needInt( lexer );
+            entry.m_doc = needString( lexer );
+            entry.m_keywords = needString( lexer );
+            lexer.NeedRIGHT();
+
+            lib.m_footprints.push_back( entry );
+        }
+    }
+}
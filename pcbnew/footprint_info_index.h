@@ -0,0 +1,121 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FOOTPRINT_INFO_INDEX_H
+#define FOOTPRINT_INFO_INDEX_H
+
+#include <map>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <ki_mutex.h>
+
+
+/**
+ * Class FOOTPRINT_INFO_INDEX
+ * is a persistent index of the FOOTPRINT_INFO fields (pad counts, description and
+ * keywords) of the footprint libraries.
+ *
+ * Libraries are identified by their full URI, and each entry holds a signature
+ * built from the size and modification time of the library files.  As long as the
+ * signature matches the library on disk, the footprints do not have to be parsed
+ * to fill the footprint list.
+ *
+ * The index is shared by all the footprint lists of the process, and is thread safe.
+ */
+class FOOTPRINT_INFO_INDEX
+{
+public:
+    struct ENTRY
+    {
+        wxString m_fpname;
+        int      m_pad_count;
+        int      m_unique_pad_count;
+        wxString m_doc;
+        wxString m_keywords;
+    };
+
+    typedef std::vector<ENTRY> ENTRIES;
+
+    /**
+     * Function GetIndex
+     * @return the index of the process, loaded from the user configuration directory
+     * on first use.
+     */
+    static FOOTPRINT_INFO_INDEX& GetIndex();
+
+    /**
+     * Function LibrarySignature
+     * builds the signature of the library at \a aLibraryPath, without parsing it.
+     * @param aLibraryPath is the full path of the library, file or directory.
+     * @param aLibraryType is the plugin type of the library.
+     * @return the signature, or an empty string when the library is not a local file
+     *         or directory (in which case it cannot be indexed).
+     */
+    static wxString LibrarySignature( const wxString& aLibraryPath,
+                                      const wxString& aLibraryType );
+
+    /**
+     * Function Find
+     * copies the footprints stored for \a aLibraryPath to \a aEntries.
+     * @return true if the library is in the index with the signature \a aSignature.
+     */
+    bool Find( const wxString& aLibraryPath, const wxString& aSignature, ENTRIES& aEntries );
+
+    /**
+     * Function Store
+     * stores the footprints of a library, replacing any previous entry.
+     */
+    void Store( const wxString& aLibraryPath, const wxString& aSignature,
+                const ENTRIES& aEntries );
+
+    /**
+     * Function Clear
+     * forgets all the libraries, so the next footprint lists parse them again.  The
+     * index file is rewritten by the next Save().
+     */
+    void Clear();
+
+    /**
+     * Function Save
+     * replaces the index file with the current index, if it has been modified since it
+     * was loaded.  Errors are ignored: the index is only an optimization.
+     */
+    void Save();
+
+private:
+    struct LIBRARY
+    {
+        wxString m_signature;
+        ENTRIES  m_footprints;
+    };
+
+    FOOTPRINT_INFO_INDEX( const wxString& aFileName );
+
+    /// Reads the index file.  Throws IO_ERROR or PARSE_ERROR on malformed files.
+    void load();
+
+    wxString                    m_fileName;
+    std::map<wxString, LIBRARY> m_libraries;
+    bool                        m_modified;
+    MUTEX                       m_lock;
+};
+
+#endif // FOOTPRINT_INFO_INDEX_H
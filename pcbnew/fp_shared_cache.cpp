@@ -0,0 +1,229 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fp_shared_cache.h>
+
+#include <class_module.h>
+#include <class_edge_mod.h>
+#include <class_pad.h>
+#include <class_text_mod.h>
+
+#include <ki_mutex.h>
+
+#include <wx/log.h>
+
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+
+#include <algorithm>
+#include <vector>
+
+
+/**
+ * Definition for enabling and disabling footprint cache trace output.  See the
+ * wxWidgets documentation on using the WXTRACE environment variable.
+ */
+static const wxChar traceFootprintCache[] = wxT( "KicadFootprintCache" );
+
+/// Default memory limit of the cache, enough for the footprints of the stock libraries
+static const size_t DEFAULT_MEMORY_LIMIT = 256 << 20;
+
+
+static size_t estimateModuleMemory( const MODULE* aModule )
+{
+    size_t size = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );
+
+    size += aModule->PadsList().GetCount() * sizeof( D_PAD );
+
+    for( const BOARD_ITEM* item = aModule->GraphicalItemsList(); item; item = item->Next() )
+    {
+        if( item->Type() == PCB_MODULE_TEXT_T )
+        {
+            size += sizeof( TEXTE_MODULE );
+        }
+        else
+        {
+            const EDGE_MODULE* edge = static_cast<const EDGE_MODULE*>( item );
+            size += sizeof( EDGE_MODULE ) + edge->GetPolyPoints().size() * sizeof( wxPoint );
+        }
+    }
+
+    return size;
+}
+
+
+FP_SHARED_CACHE& FP_SHARED_CACHE::GetCache()
+{
+    static FP_SHARED_CACHE* cache = nullptr;
+    static MUTEX            lock;
+
+    MUTLOCK locker( lock );
+
+    // Deliberately never deleted: footprints may be referenced until the process ends
+    if( !cache )
+        cache = new FP_SHARED_CACHE();
+
+    return *cache;
+}
+
+
+FP_SHARED_CACHE::FP_SHARED_CACHE() :
+    m_memoryUsage( 0 ),
+    m_memoryLimit( DEFAULT_MEMORY_LIMIT ),
+    m_clock( 0 ),
+    m_hits( 0 ),
+    m_misses( 0 ),
+    m_evictions( 0 )
+{
+}
+
+
+std::shared_ptr<MODULE> FP_SHARED_CACHE::Find( const wxString& aFileName,
+                                               const wxDateTime& aModTime )
+{
+    boost::interprocess::sharable_lock<SHARED_MUTEX> locker( m_lock );
+
+    auto it = m_entries.find( aFileName );
+
+    if( it == m_entries.end() || !aModTime.IsValid() || it->second.m_modTime != aModTime )
+    {
+        m_misses++;
+        return nullptr;
+    }
+
+    m_hits++;
+    it->second.m_lastUse = ++m_clock;
+
+    return it->second.m_module;
+}
+
+
+void FP_SHARED_CACHE::Store( const wxString& aFileName, const wxDateTime& aModTime,
+                             const std::shared_ptr<MODULE>& aModule )
+{
+    if( !aModule || !aModTime.IsValid() )
+        return;
+
+    boost::interprocess::scoped_lock<SHARED_MUTEX> locker( m_lock );
+
+    ENTRY& entry = m_entries[aFileName];
+
+    if( entry.m_module )
+        m_memoryUsage -= entry.m_size;
+
+    entry.m_modTime = aModTime;
+    entry.m_module = aModule;
+    entry.m_size = estimateModuleMemory( aModule.get() );
+    entry.m_lastUse = ++m_clock;
+
+    m_memoryUsage += entry.m_size;
+
+    if( m_memoryUsage > m_memoryLimit )
+        evict( aFileName );
+}
+
+
+void FP_SHARED_CACHE::Remove( const wxString& aFileName )
+{
+    boost::interprocess::scoped_lock<SHARED_MUTEX> locker( m_lock );
+
+    auto it = m_entries.find( aFileName );
+
+    if( it == m_entries.end() )
+        return;
+
+    m_memoryUsage -= it->second.m_size;
+    m_entries.erase( it );
+}
+
+
+void FP_SHARED_CACHE::SetMemoryLimit( size_t aBytes )
+{
+    boost::interprocess::scoped_lock<SHARED_MUTEX> locker( m_lock );
+
+    m_memoryLimit = aBytes;
+
+    if( m_memoryUsage > m_memoryLimit )
+        evict( wxEmptyString );
+}
+
+
+size_t FP_SHARED_CACHE::GetMemoryLimit() const
+{
+    boost::interprocess::sharable_lock<SHARED_MUTEX> locker( m_lock );
+
+    return m_memoryLimit;
+}
+
+
+FP_SHARED_CACHE::STATS FP_SHARED_CACHE::GetStats() const
+{
+    boost::interprocess::sharable_lock<SHARED_MUTEX> locker( m_lock );
+
+    STATS stats;
+
+    stats.m_hits = m_hits;
+    stats.m_misses = m_misses;
+    stats.m_evictions = m_evictions;
+    stats.m_count = m_entries.size();
+    stats.m_memoryUsage = m_memoryUsage;
+
+    return stats;
+}
+
+
+void FP_SHARED_CACHE::evict( const wxString& aKeep )
+{
+    typedef std::map<wxString, ENTRY>::iterator ENTRY_ITER;
+
+    std::vector<ENTRY_ITER> candidates;
+
+    for( ENTRY_ITER it = m_entries.begin(); it != m_entries.end(); ++it )
+    {
+        if( it->first != aKeep )
+            candidates.push_back( it );
+    }
+
+    // Eviction only happens once the cache is full, so sorting is cheaper than keeping
+    // the entries in LRU order on every lookup, which would require the exclusive lock
+    std::sort( candidates.begin(), candidates.end(),
+               []( const ENTRY_ITER& aFirst, const ENTRY_ITER& aSecond )
+               {
+                   return aFirst->second.m_lastUse < aSecond->second.m_lastUse;
+               } );
+
+    // Free a bit more than needed, so the next footprints stored do not evict again
+    size_t target = m_memoryLimit - m_memoryLimit / 8;
+    size_t count = 0;
+
+    for( ENTRY_ITER it : candidates )
+    {
+        if( m_memoryUsage <= target )
+            break;
+
+        m_memoryUsage -= it->second.m_size;
+        m_entries.erase( it );
+        ++count;
+    }
+
+    m_evictions += count;
+
+    wxLogTrace( traceFootprintCache, wxT( "Evicted %u footprints, %u footprints (%u kB) cached" ),
+                (unsigned) count, (unsigned) m_entries.size(), (unsigned) ( m_memoryUsage >> 10 ) );
+}
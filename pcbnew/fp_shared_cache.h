@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FP_SHARED_CACHE_H
+#define FP_SHARED_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include <wx/datetime.h>
+#include <wx/string.h>
+
+#include <boost/interprocess/sync/interprocess_sharable_mutex.hpp>
+
+class MODULE;
+
+
+/**
+ * Class FP_SHARED_CACHE
+ * holds the footprints parsed from footprint files, shared by all the footprint
+ * library plugins of the process: a footprint file used by several library tables,
+ * frames or loader threads is parsed only once.
+ *
+ * Footprints are identified by the full path of their file, and are only returned
+ * as long as the file modification time did not change.  They are reference counted,
+ * so a footprint evicted from the cache stays valid for the plugins still using it.
+ * The cached footprints must never be modified.
+ *
+ * Lookups only take a shared lock, so the footprint list loader threads do not
+ * serialize on the cache.  The least recently used footprints are evicted when the
+ * estimated memory used by the cache exceeds its limit.
+ */
+class FP_SHARED_CACHE
+{
+public:
+    struct STATS
+    {
+        uint64_t m_hits;
+        uint64_t m_misses;
+        uint64_t m_evictions;
+        size_t   m_count;           ///< Number of cached footprints
+        size_t   m_memoryUsage;     ///< Estimated size of the cached footprints, in bytes
+    };
+
+    /**
+     * Function GetCache
+     * @return the footprint cache of the process.
+     */
+    static FP_SHARED_CACHE& GetCache();
+
+    /**
+     * Function Find
+     * @return the footprint parsed from \a aFileName when it had the modification time
+     *         \a aModTime, or NULL if it is not in the cache.
+     */
+    std::shared_ptr<MODULE> Find( const wxString& aFileName, const wxDateTime& aModTime );
+
+    /**
+     * Function Store
+     * adds the footprint parsed from \a aFileName, replacing any previous version, and
+     * evicts the least recently used footprints if the memory limit is exceeded.
+     */
+    void Store( const wxString& aFileName, const wxDateTime& aModTime,
+                const std::shared_ptr<MODULE>& aModule );
+
+    /**
+     * Function Remove
+     * forgets the footprint of \a aFileName, e.g. because the file was written.
+     */
+    void Remove( const wxString& aFileName );
+
+    void SetMemoryLimit( size_t aBytes );
+    size_t GetMemoryLimit() const;
+
+    STATS GetStats() const;
+
+private:
+    typedef boost::interprocess::interprocess_sharable_mutex SHARED_MUTEX;
+
+    struct ENTRY
+    {
+        wxDateTime              m_modTime;
+        std::shared_ptr<MODULE> m_module;
+        size_t                  m_size;
+        std::atomic<uint64_t>   m_lastUse;  ///< Updated by readers under the shared lock
+    };
+
+    FP_SHARED_CACHE();
+
+    /// Evicts the least recently used entries, but \a aKeep, until the cache fits in its
+    /// memory limit.  Must be called with the exclusive lock held.
+    void evict( const wxString& aKeep );
+
+    std::map<wxString, ENTRY> m_entries;
+    size_t                    m_memoryUsage;
+    size_t                    m_memoryLimit;
+
+    std::atomic<uint64_t>     m_clock;      ///< Use counter, for the LRU order
+    std::atomic<uint64_t>     m_hits;
+    std::atomic<uint64_t>     m_misses;
+    uint64_t                  m_evictions;
+
+    mutable SHARED_MUTEX      m_lock;
+};
+
+#endif // FP_SHARED_CACHE_H
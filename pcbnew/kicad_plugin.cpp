@@ -43,6 +43,7 @@
 #include <zones.h>
 #include <kicad_plugin.h>
 #include <pcb_parser.h>
+#include <fp_shared_cache.h>
 
 #include <wx/dir.h>
 #include <wx/filename.h>
@@ -90,7 +91,8 @@ class FP_CACHE_ITEM
 {
     wxFileName              m_file_name; ///< The the full file name and path of the footprint to cache.
     wxDateTime              m_mod_time;  ///< The last file modified time stamp.
-    std::unique_ptr<MODULE> m_module;
+    std::shared_ptr<MODULE> m_module;    ///< The footprint, NULL until it is parsed.  It may
+                                         ///< be shared with the other caches of the process.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName );
@@ -98,10 +100,15 @@ public:
     wxString    GetName() const { return m_file_name.GetDirs().Last(); }
     wxFileName  GetFileName() const { return m_file_name; }
 
-    /// Tell if the disk content or the lib_path has changed.
+    /// Tell if the disk content or the lib_path has changed.  A footprint which has not
+    /// been parsed yet is never modified.
     bool        IsModified() const;
 
+    /// Tell if the footprint file has been parsed.
+    bool        IsLoaded() const { return m_module != nullptr; }
+
     MODULE*     GetModule() const { return m_module.get(); }
+    void        SetModule( const std::shared_ptr<MODULE>& aModule, const wxDateTime& aModTime );
     void        UpdateModificationTime() { m_mod_time = m_file_name.GetModificationTime(); }
 };
 
@@ -111,6 +118,11 @@ FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName ) :
 {
     m_file_name = aFileName;
 
+    // The time stamp of a footprint not parsed yet is read when it is parsed, so
+    // listing a library does not stat every file.
+    if( !m_module )
+        return;
+
     if( m_file_name.FileExists() )
         m_mod_time = m_file_name.GetModificationTime();
     else
@@ -118,9 +130,17 @@ FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName ) :
 }
 
 
+void FP_CACHE_ITEM::SetModule( const std::shared_ptr<MODULE>& aModule,
+                               const wxDateTime& aModTime )
+{
+    m_module = aModule;
+    m_mod_time = aModTime;
+}
+
+
 bool FP_CACHE_ITEM::IsModified() const
 {
-    if( !m_file_name.FileExists() )
+    if( !m_module || !m_file_name.FileExists() )
         return false;
 
     wxLogTrace( traceFootprintLibrary, wxT( "File '%s', m_mod_time %s-%s, file mod time: %s-%s." ),
@@ -160,8 +180,20 @@ public:
     /// save the entire legacy library to m_lib_name;
     void Save();
 
+    /// Lists the footprint files of the library.  Footprints are parsed on demand by
+    /// GetModule().
     void Load();
 
+    /**
+     * Function GetModule
+     * returns the footprint \a aFootprintName, parsing its file if it was not parsed yet
+     * or if it changed on disk since it was parsed.
+     *
+     * @return the cached footprint, or NULL if the library has no such footprint.
+     * @throw IO_ERROR if the footprint file cannot be parsed.
+     */
+    MODULE* GetModule( const wxString& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     wxDateTime GetLibModificationTime() const;
@@ -171,10 +203,13 @@ public:
      * check if the footprint cache has been modified relative to \a aLibPath
      * and \a aFootprintName.
      *
+     * Changes of the content of a footprint file are not checked here: GetModule()
+     * parses the file again when needed.
+     *
      * @param aLibPath is a path to test the current cache library path against.
      * @param aFootprintName is the footprint name in the cache to test.  If the footprint
-     *                       name is empty, the all the footprint files in the library are
-     *                       checked to see if they have been modified.
+     *                       name is empty, the library directory is checked for added or
+     *                       removed footprint files.
      * @return true if the cache has been modified.
      */
     bool IsModified( const wxString& aLibPath,
@@ -225,6 +260,10 @@ void FP_CACHE::Save()
 
     for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
     {
+        // Footprints never parsed have not been changed
+        if( !it->second->IsLoaded() )
+            continue;
+
         wxFileName fn = it->second->GetFileName();
 
         if( fn.FileExists() && !it->second->IsModified() )
@@ -267,6 +306,9 @@ void FP_CACHE::Save()
 #endif
         it->second->UpdateModificationTime();
         m_mod_time = GetLibModificationTime();
+
+        // The footprint parsed from the previous file content is obsolete
+        FP_SHARED_CACHE::GetCache().Remove( fn.GetFullPath() );
     }
 }
 
@@ -290,44 +332,66 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ) )
     {
-        wxString cacheError;
-
         do
         {
             // prepend the libpath into fullPath
             wxFileName fullPath( m_lib_path.GetPath(), fpFileName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER    reader( fullPath.GetFullPath() );
+            // The footprint name is the file name without the extension.
+            std::string name = TO_UTF8( fullPath.GetName() );
+            m_modules.insert( name, new FP_CACHE_ITEM( NULL, fullPath ) );
+        } while( dir.GetNext( &fpFileName ) );
+    }
 
-                m_owner->m_parser->SetLineReader( &reader );
+    // Remember the file modification time of library file when the
+    // cache snapshot was made, so that in a networked environment we will
+    // reload the cache as needed.
+    m_mod_time = GetLibModificationTime();
+}
 
-                std::string name = TO_UTF8( fullPath.GetName() );
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
 
-                // The footprint name is the file name without the extension.
-                footprint->SetFPID( LIB_ID( fullPath.GetName() ) );
-                m_modules.insert( name, new FP_CACHE_ITEM( footprint, fullPath ) );
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
+MODULE* FP_CACHE::GetModule( const wxString& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( TO_UTF8( aFootprintName ) );
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fpFileName ) );
+    if( it == m_modules.end() )
+        return NULL;
 
-        // Remember the file modification time of library file when the
-        // cache snapshot was made, so that in a networked environment we will
-        // reload the cache as needed.
-        m_mod_time = GetLibModificationTime();
+    FP_CACHE_ITEM* item = it->second;
+
+    if( item->IsLoaded() && !item->IsModified() )
+        return item->GetModule();
+
+    wxFileName          fullPath = item->GetFileName();
+    wxString            fileName = fullPath.GetFullPath();
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+    // Read the time stamp before parsing: a file changed while being parsed is parsed again
+    // on the next access.
+    wxDateTime          modTime = fullPath.GetModificationTime();
+    FP_SHARED_CACHE&    sharedCache = FP_SHARED_CACHE::GetCache();
+
+    // Another library table, frame or loader thread may already have parsed this file
+    std::shared_ptr<MODULE> footprint = sharedCache.Find( fileName, modTime );
+
+    if( !footprint )
+    {
+        FILE_LINE_READER    reader( fileName );
+
+        wxLogTrace( traceFootprintLibrary, wxT( "Parsing footprint file '%s'." ),
+                    GetChars( fileName ) );
+
+        m_owner->m_parser->SetLineReader( &reader );
+
+        footprint.reset( (MODULE*) m_owner->m_parser->Parse() );
+
+        // The footprint name is the file name without the extension.
+        footprint->SetFPID( LIB_ID( fullPath.GetName() ) );
+        sharedCache.Store( fileName, modTime, footprint );
     }
+
+    item->SetModule( footprint, modTime );
+
+    return footprint.get();
 }
 
 
@@ -351,6 +415,7 @@ void FP_CACHE::Remove( const wxString& aFootprintName )
     wxString fullPath = it->second->GetFileName().GetFullPath();
     m_modules.erase( footprintName );
     wxRemoveFile( fullPath );
+    FP_SHARED_CACHE::GetCache().Remove( fullPath );
 }
 
 
@@ -370,39 +435,25 @@ bool FP_CACHE::IsModified( const wxString& aLibPath, const wxString& aFootprintN
     if( !m_lib_path.DirExists() || !IsPath( aLibPath ) )
         return true;
 
-    // If no footprint was specified, check every file modification time against the time
-    // it was loaded.
+    // If no footprint was specified, the list of footprints is up to date as long as no
+    // file was added to or removed from the library directory, which updates its time stamp.
     if( aFootprintName.IsEmpty() )
     {
-        for( MODULE_CITER it = m_modules.begin();  it != m_modules.end();  ++it )
+        if( GetLibModificationTime() != m_mod_time )
         {
-            wxFileName fn = m_lib_path;
-
-            fn.SetName( it->second->GetFileName().GetName() );
-            fn.SetExt( KiCadFootprintFileExtension );
-
-            if( !fn.FileExists() )
-            {
-                wxLogTrace( traceFootprintLibrary,
-                            wxT( "Footprint cache file '%s' does not exist." ),
-                            fn.GetFullPath().GetData() );
-                return true;
-            }
-
-            if( it->second->IsModified() )
-            {
-                wxLogTrace( traceFootprintLibrary,
-                            wxT( "Footprint cache file '%s' has been modified." ),
-                            fn.GetFullPath().GetData() );
-                return true;
-            }
+            wxLogTrace( traceFootprintLibrary,
+                        wxT( "Footprint library path '%s' has been modified." ),
+                        GetChars( m_lib_path.GetPath() ) );
+            return true;
         }
     }
     else
     {
+        // A footprint file modified since it was parsed is parsed again by GetModule()
+        // so only unknown footprints require to list the library again.
         MODULE_CITER it = m_modules.find( TO_UTF8( aFootprintName ) );
 
-        if( it == m_modules.end() || it->second->IsModified() )
+        if( it == m_modules.end() )
             return true;
     }
 
@@ -1865,17 +1916,13 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 
     cacheLib( aLibraryPath, aFootprintName );
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( TO_UTF8( aFootprintName ) );
+    MODULE* footprint = m_cache->GetModule( aFootprintName );
 
-    if( it == mods.end() )
-    {
+    if( !footprint )
         return NULL;
-    }
 
     // copy constructor to clone the already loaded MODULE
-    return new MODULE( *it->second->GetModule() );
+    return new MODULE( *footprint );
 }
 
 
@@ -1069,6 +1069,14 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone )
             m_gal->SetIsStroke( true );
         }
 
+        if( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_FILLED )
+        {
+            // The fill keeps its triangulation until it is modified, so the GAL does not
+            // need to tesselate it each time the zone is redrawn
+            polySet.CacheTriangulation();
+            m_gal->DrawPolygon( polySet );
+        }
+
         for( int i = 0; i < polySet.OutlineCount(); i++ )
         {
             const SHAPE_LINE_CHAIN& outline = polySet.COutline( i );
@@ -1080,15 +1088,7 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone )
 
             corners.push_back( (VECTOR2D) outline.CPoint( 0 ) );
 
-            if( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_FILLED )
-            {
-                m_gal->DrawPolygon( corners );
-                m_gal->DrawPolyline( corners );
-            }
-            else if( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_OUTLINED )
-            {
-                m_gal->DrawPolyline( corners );
-            }
+            m_gal->DrawPolyline( corners );
 
             corners.clear();
         }
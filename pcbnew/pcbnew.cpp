@@ -61,6 +61,7 @@
 #include <footprint_wizard_frame.h>
 #include <footprint_preview_panel.h>
 #include <footprint_info_impl.h>
+#include <fab_manifest.h>
 #include <gl_context_mgr.h>
 extern bool IsWxPythonLoaded();
 
@@ -181,6 +182,9 @@ static struct IFACE : public KIFACE_I
         case KIFACE_G_FOOTPRINT_TABLE:
             return (void*) new FP_LIB_TABLE( &GFootprintTable );
 
+        case KIFACE_RUN_FAB_MANIFEST:
+            return (void*) &RunFabManifest;
+
         default:
             return nullptr;
         }
@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcbnew_batch.cpp
+ * @brief A command line launcher creating the fabrication outputs of a board.
+ *
+ * The board is loaded once, and the outputs listed in a manifest file (see fab_manifest.h)
+ * are created concurrently by the pcbnew kiface, without any window.  The time spent for
+ * each output and the peak memory use are reported.
+ */
+
+#include <fctsys.h>
+#include <kiway.h>
+#include <kiface_ids.h>
+#include <batch_launcher.h>
+#include <fab_manifest.h>
+
+#include <wx/app.h>
+#include <wx/cmdline.h>
+
+#if defined( __WINDOWS__ )
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+/**
+ * @return the peak resident memory of the process, in KiB
+ */
+static unsigned long peakMemoryKiB()
+{
+#if defined( __WINDOWS__ )
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+        return 0;
+
+    return (unsigned long) ( counters.PeakWorkingSetSize / 1024 );
+#else
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        return 0;
+
+#if defined( __APPLE__ )
+    return (unsigned long) ( usage.ru_maxrss / 1024 );     // bytes on OS X
+#else
+    return (unsigned long) usage.ru_maxrss;
+#endif
+#endif
+}
+
+
+class PCBNEW_BATCH : public wxAppConsole
+{
+public:
+    virtual int OnRun() override;
+    virtual void OnInitCmdLine( wxCmdLineParser& parser ) override;
+    virtual bool OnCmdLineParsed( wxCmdLineParser& parser ) override;
+
+private:
+    wxString m_boardFileName;
+    wxString m_manifestFileName;
+};
+
+
+static const wxCmdLineEntryDesc cmdLineDesc[] =
+{
+    { wxCMD_LINE_PARAM, NULL, NULL, "pcb_filename",
+        wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_MANDATORY },
+    { wxCMD_LINE_PARAM, NULL, NULL, "manifest_filename",
+        wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_MANDATORY },
+    { wxCMD_LINE_SWITCH, "h", NULL, "display this message",
+        wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_NONE }
+};
+
+
+wxIMPLEMENT_APP_CONSOLE( PCBNEW_BATCH );
+
+
+void PCBNEW_BATCH::OnInitCmdLine( wxCmdLineParser& parser )
+{
+    parser.SetDesc( cmdLineDesc );
+    parser.SetSwitchChars( "-" );
+}
+
+
+bool PCBNEW_BATCH::OnCmdLineParsed( wxCmdLineParser& parser )
+{
+    if( parser.GetParamCount() < 2 )
+    {
+        parser.Usage();
+        return false;
+    }
+
+    m_boardFileName = parser.GetParam( 0 );
+    m_manifestFileName = parser.GetParam( 1 );
+
+    return true;
+}
+
+
+int PCBNEW_BATCH::OnRun()
+{
+    STDIO_REPORTER reporter;
+
+    // The files created by the kiface show the application name, as they do from pcbnew
+    SetAppName( wxT( "pcbnew" ) );
+
+    KIFACE* kiface = LoadBatchKiface( wxT( "pcbnew" ), reporter );
+
+    if( !kiface )
+        return 2;
+
+    FAB_MANIFEST_RUNNER* runner =
+            (FAB_MANIFEST_RUNNER*) kiface->IfaceOrAddress( KIFACE_RUN_FAB_MANIFEST );
+
+    if( !runner )
+    {
+        reporter.Report( _( "The kiface library does not export the manifest runner." ),
+                         REPORTER::RPT_ERROR );
+        return 2;
+    }
+
+    bool success = runner( m_boardFileName, m_manifestFileName, reporter );
+
+    reporter.Report( wxString::Format( _( "Peak memory: %lu KiB." ), peakMemoryKiB() ),
+                     REPORTER::RPT_INFO );
+
+    return success ? 0 : 1;
+}
@@ -449,6 +449,36 @@ void PLOT_CONTROLLER::ClosePlot()
 }
 
 
+bool PLOT_CONTROLLER::buildPlotFileName( const wxString &aSuffix, PlotFormat aFormat,
+                                         LAYER_NUM aLayer, wxFileName &aFileName )
+{
+    // Compute the full filename for the output (after ensuring the output
+    // directory is OK)
+    wxString outputDirName = GetPlotOptions().GetOutputDirectory() ;
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return false;
+
+    // outputDir contains now the full path of plot files
+    aFileName = boardFilename;
+    aFileName.SetPath( outputDir.GetPath() );
+    wxString fileExt = GetDefaultPlotExtension( aFormat );
+
+    // Gerber format can use specific file ext, depending on layers
+    // (now not a good practice, because the official file ext is .gbr)
+    if( aFormat == PLOT_FORMAT_GERBER &&
+        GetPlotOptions().GetUseGerberProtelExtensions() )
+        fileExt = GetGerberProtelExtension( aLayer );
+
+    // Build plot filenames from the board name and layer names:
+    BuildPlotFileName( &aFileName, outputDir.GetPath(), aSuffix, fileExt );
+
+    return true;
+}
+
+
 bool PLOT_CONTROLLER::OpenPlotfile( const wxString &aSuffix,
                                     PlotFormat     aFormat,
                                     const wxString &aSheetDesc )
@@ -464,32 +494,67 @@ bool PLOT_CONTROLLER::OpenPlotfile( const wxString &aSuffix,
     ClosePlot();
 
     // Now compute the full filename for the output and start the plot
-    // (after ensuring the output directory is OK)
-    wxString outputDirName = GetPlotOptions().GetOutputDirectory() ;
-    wxFileName outputDir = wxFileName::DirName( outputDirName );
-    wxString boardFilename = m_board->GetFileName();
+    if( buildPlotFileName( aSuffix, aFormat, GetLayer(), m_plotFile ) )
+    {
+        m_plotter = StartPlotBoard( m_board, &GetPlotOptions(), ToLAYER_ID( GetLayer() ),
+                                    m_plotFile.GetFullPath(), aSheetDesc );
+    }
+
+    return( m_plotter != NULL );
+}
+
+
+void PLOT_CONTROLLER::QueueLayer( const wxString &aSuffix, const wxString &aSheetDesc )
+{
+    QUEUED_LAYER queued;
+
+    queued.m_layer = GetLayer();
+    queued.m_suffix = aSuffix;
+    queued.m_sheetDesc = aSheetDesc;
+
+    m_queuedLayers.push_back( queued );
+}
+
+
+bool PLOT_CONTROLLER::PlotQueuedLayers( PlotFormat aFormat )
+{
+    std::vector<BOARD_LAYER_PLOT> plots;
+    std::vector<QUEUED_LAYER>     queuedLayers;
+
+    queuedLayers.swap( m_queuedLayers );
+    m_plotFileNames.Clear();
 
-    if( EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+    GetPlotOptions().SetFormat( aFormat );
+    ClosePlot();
+
+    for( const QUEUED_LAYER& queued : queuedLayers )
     {
-        // outputDir contains now the full path of plot files
-        m_plotFile = boardFilename;
-        m_plotFile.SetPath( outputDir.GetPath() );
-        wxString fileExt = GetDefaultPlotExtension( aFormat );
+        wxFileName fn;
 
-        // Gerber format can use specific file ext, depending on layers
-        // (now not a good practice, because the official file ext is .gbr)
-        if( GetPlotOptions().GetFormat() == PLOT_FORMAT_GERBER &&
-            GetPlotOptions().GetUseGerberProtelExtensions() )
-            fileExt = GetGerberProtelExtension( GetLayer() );
+        if( !buildPlotFileName( queued.m_suffix, aFormat, queued.m_layer, fn ) )
+            return false;
 
-        // Build plot filenames from the board name and layer names:
-        BuildPlotFileName( &m_plotFile, outputDir.GetPath(), aSuffix, fileExt );
+        BOARD_LAYER_PLOT plot;
 
-        m_plotter = StartPlotBoard( m_board, &GetPlotOptions(), ToLAYER_ID( GetLayer() ),
-                                    m_plotFile.GetFullPath(), aSheetDesc );
+        plot.m_layer = ToLAYER_ID( queued.m_layer );
+        plot.m_fullFileName = fn.GetFullPath();
+        plot.m_sheetDesc = queued.m_sheetDesc;
+        plot.m_created = false;
+
+        plots.push_back( plot );
     }
 
-    return( m_plotter != NULL );
+    PlotBoardLayers( m_board, &GetPlotOptions(), plots );
+
+    bool success = true;
+
+    for( const BOARD_LAYER_PLOT& plot : plots )
+    {
+        m_plotFileNames.Add( plot.m_created ? plot.m_fullFileName : wxString() );
+        success &= plot.m_created;
+    }
+
+    return success;
 }
 
 
@@ -29,6 +29,7 @@
 #ifndef PCBPLOT_H_
 #define PCBPLOT_H_
 
+#include <vector>
 #include <wx/filename.h>
 #include <pad_shapes.h>
 #include <pcb_plot_params.h>
@@ -170,6 +171,30 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
                          const wxString& aFullFileName,
                          const wxString& aSheetDesc );
 
+/**
+ * A layer to plot with PlotBoardLayers(), in its own file.
+ */
+struct BOARD_LAYER_PLOT
+{
+    PCB_LAYER_ID    m_layer;
+    wxString        m_fullFileName;
+    wxString        m_sheetDesc;        ///< see StartPlotBoard()
+    bool            m_created;          ///< set by PlotBoardLayers()
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots several layers concurrently, each one in its own file and with its own plotter.
+ * The board is only read while plotting, so the files are identical to the ones plotted
+ * one after another with StartPlotBoard() and PlotOneBoardLayer().
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options, shared by all the layers
+ * @param aPlots = the layers to plot.  m_created is set to false for the files which
+ *                 could not be created.
+ */
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<BOARD_LAYER_PLOT>& aPlots );
+
 /**
  * Function PlotOneBoardLayer
  * main function to plot one copper or technical layer.
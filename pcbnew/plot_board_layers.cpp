@@ -150,6 +150,42 @@ void PlotSilkScreen( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
     }
 }
 
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<BOARD_LAYER_PLOT>& aPlots )
+{
+    // The locale is global: it must be set before the threads start, and restored after
+    // they finish.
+    LOCALE_IO toggle;
+
+    int                     count = (int) aPlots.size();
+    std::vector<PLOTTER*>   plotters( count );
+
+    // Plot files are created, and their headers written, one after another
+    for( int ii = 0; ii < count; ++ii )
+    {
+        plotters[ii] = StartPlotBoard( aBoard, aPlotOpts, aPlots[ii].m_layer,
+                                       aPlots[ii].m_fullFileName, aPlots[ii].m_sheetDesc );
+        aPlots[ii].m_created = plotters[ii] != NULL;
+    }
+
+    // Each layer walks the whole board, converting its items: this is where the time goes.
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < count; ++ii )
+    {
+        PLOTTER* plotter = plotters[ii];
+
+        if( !plotter )
+            continue;
+
+        PlotOneBoardLayer( aBoard, plotter, aPlots[ii].m_layer, *aPlotOpts );
+        plotter->EndPlot();
+        delete plotter;
+    }
+}
+
+
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt )
 {
@@ -366,7 +402,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             wxSize extraSize = margin * 2;
             extraSize.x += width_adj;
             extraSize.y += width_adj;
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
+            wxSize padPlotsDelta = pad->GetDelta(); // has meaning only for trapezoidal pads
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -399,7 +435,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                padPlotsDelta = delta;
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -416,17 +452,19 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->GetVisibleElementColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-            pad->SetSize( padPlotsSize );
+            // Plot a copy of the pad with the required plot size: the board must not be
+            // modified, other layers can be plotted at the same time.
+            D_PAD plotPad( *pad );
+            plotPad.SetSize( padPlotsSize );
+            plotPad.SetDelta( padPlotsDelta );
 
-            switch( pad->GetShape() )
+            switch( plotPad.GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    (pad->GetSize() == pad->GetDrillSize()) &&
-                    (pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED) )
+                    (plotPad.GetSize() == plotPad.GetDrillSize()) &&
+                    (plotPad.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED) )
                     break;
 
                 // Fall through:
@@ -434,12 +472,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             default:
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( &plotPad, color, plotMode );
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -30,6 +30,7 @@
 #ifndef PLOTCONTROLLER_H_
 #define PLOTCONTROLLER_H_
 
+#include <vector>
 #include <pcb_plot_params.h>
 #include <layers_id_colors_and_visibility.h>
 
@@ -84,6 +85,29 @@ public:
      */
     bool PlotLayer();
 
+    /** Queue the current layer (m_plotLayer) to be plotted by PlotQueuedLayers
+     * @param aSuffix is a string added to the base filename to identify the plot
+     * file, see OpenPlotfile
+     * @param aSheetDesc
+     */
+    void QueueLayer( const wxString &aSuffix, const wxString &aSheetDesc );
+
+    /** Plot the queued layers concurrently, each one in its own plotfile,
+     * and empty the queue. The files are identical to the ones created by
+     * OpenPlotfile and PlotLayer for each layer.
+     * The current plot, if any, is closed.
+     * @param aFormat is the plot file format identifier
+     * @return true if all the files were created
+     */
+    bool PlotQueuedLayers( PlotFormat aFormat );
+
+    /**
+     * @return the full filenames of the files plotted by the last call to
+     * PlotQueuedLayers, in the queue order. The name of a file which could not
+     * be created is empty.
+     */
+    const wxArrayString& GetPlotFileNames() const { return m_plotFileNames; }
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
@@ -123,6 +147,25 @@ private:
 
     /// The current plot filename, set by OpenPlotfile
     wxFileName m_plotFile;
+
+    /// The layers queued by QueueLayer
+    struct QUEUED_LAYER
+    {
+        LAYER_NUM m_layer;
+        wxString  m_suffix;
+        wxString  m_sheetDesc;
+    };
+
+    std::vector<QUEUED_LAYER> m_queuedLayers;
+
+    /// The files plotted by PlotQueuedLayers
+    wxArrayString m_plotFileNames;
+
+    /** Build the full filename of a plot file, and ensure the output directory exists
+     * @return false if the output directory cannot be created
+     */
+    bool buildPlotFileName( const wxString &aSuffix, PlotFormat aFormat,
+                            LAYER_NUM aLayer, wxFileName &aFileName );
 };
 
 #endif
@@ -266,6 +266,7 @@ int EDIT_TOOL::Main( const TOOL_EVENT& aEvent )
     m_dragging = false;         // Are selected items being dragged?
     bool restore = false;       // Should items' state be restored when finishing the tool?
     bool lockOverride = false;
+    bool translationOnly = true;    // Have the items only been moved (not rotated, flipped...)?
 
     controls->ShowCursor( true );
     controls->SetSnapping( true );
@@ -407,6 +408,10 @@ int EDIT_TOOL::Main( const TOOL_EVENT& aEvent )
                 break;      // exit the loop - we move exactly, so we have finished moving
             }
 
+            // Other actions (rotation, flip...) may have modified the items
+            if( !evt->IsAction( &PCB_ACTIONS::selectionModified ) )
+                translationOnly = false;
+
             if( m_dragging )
             {
                 // Update dragging offset (distance between cursor and the first dragged item)
@@ -442,7 +447,10 @@ int EDIT_TOOL::Main( const TOOL_EVENT& aEvent )
     if( restore )
         m_commit->Revert();
     else
+    {
+        m_commit->SetTranslationOnly( translationOnly );
         m_commit->Push( _( "Drag" ) );
+    }
 
     return 0;
 }
@@ -44,6 +44,7 @@ using namespace std::placeholders;
 #include <class_dimension.h>
 #include <class_zone.h>
 #include <class_edge_mod.h>
+#include <class_pad.h>
 
 #include <connectivity.h>
 
@@ -169,6 +170,62 @@ static bool TestForExistingItem( BOARD* aPcb, BOARD_ITEM* aItem )
 }
 
 
+/**
+ * Trace mask to log the memory held by the undo and redo lists.
+ */
+static const wxChar traceUndoMemory[] = wxT( "KicadUndoMemory" );
+
+
+/**
+ * Function estimateItemMemory
+ * gives a rough estimate of the heap memory held by a copy of aItem stored in the
+ * undo list.  Only the bulky parts of footprints and zones are taken into account.
+ */
+static size_t estimateItemMemory( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        size_t size = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );
+
+        size += module->PadsList().GetCount() * sizeof( D_PAD );
+
+        for( const BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+        {
+            if( item->Type() == PCB_MODULE_TEXT_T )
+                size += sizeof( TEXTE_MODULE );
+            else
+                size += sizeof( EDGE_MODULE );
+        }
+
+        return size;
+    }
+
+    case PCB_ZONE_AREA_T:
+    {
+        const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
+        size_t size = sizeof( ZONE_CONTAINER );
+
+        size += zone->Outline()->TotalVertices() * sizeof( VECTOR2I );
+        size += zone->GetFilledPolysList().TotalVertices() * sizeof( VECTOR2I );
+        size += zone->FillSegments().size() * sizeof( SEGMENT );
+
+        return size;
+    }
+
+    case PCB_TRACE_T:       return sizeof( TRACK );
+    case PCB_VIA_T:         return sizeof( VIA );
+    case PCB_LINE_T:        return sizeof( DRAWSEGMENT );
+    case PCB_TEXT_T:        return sizeof( TEXTE_PCB );
+    case PCB_DIMENSION_T:   return sizeof( DIMENSION );
+    case PCB_TARGET_T:      return sizeof( PCB_TARGET );
+    default:                return sizeof( BOARD_ITEM );
+    }
+}
+
+
 void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM* aItem, UNDO_REDO_T aCommandType,
                                               const wxPoint& aTransformPoint )
 {
@@ -252,6 +309,8 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
         }
     }
 
+    size_t memoryUsage = 0;
+
     for( unsigned ii = 0; ii < commandToUndo->GetCount(); ii++ )
     {
         BOARD_ITEM* item    = (BOARD_ITEM*) commandToUndo->GetPickedItem( ii );
@@ -278,6 +337,13 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
                 EDA_ITEM* cloned = item->Clone();
                 commandToUndo->SetPickedItemLink( cloned, ii );
             }
+
+            memoryUsage += estimateItemMemory(
+                    static_cast<BOARD_ITEM*>( commandToUndo->GetPickedItemLink( ii ) ) );
+            break;
+
+        case UR_DELETED:    // the undo list becomes the owner of deleted items
+            memoryUsage += estimateItemMemory( item );
             break;
 
         case UR_MOVED:
@@ -285,7 +351,6 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
         case UR_ROTATED_CLOCKWISE:
         case UR_FLIPPED:
         case UR_NEW:
-        case UR_DELETED:
             break;
 
         default:
@@ -299,11 +364,17 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
         }
     }
 
+    commandToUndo->SetMemoryUsage( memoryUsage );
+
     if( commandToUndo->GetCount() )
     {
         /* Save the copy in undo list */
         GetScreen()->PushCommandToUndoList( commandToUndo );
 
+        wxLogTrace( traceUndoMemory, wxT( "Undo command: %u items, %lu bytes; undo/redo total %lu bytes" ),
+                    commandToUndo->GetCount(), (unsigned long) commandToUndo->GetMemoryUsage(),
+                    (unsigned long) GetScreen()->GetUndoRedoMemoryUsage() );
+
         /* Clear redo list, because after a new command one cannot redo a command */
         GetScreen()->ClearUndoORRedoList( GetScreen()->m_RedoList );
     }
@@ -516,10 +587,26 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             break;
 
         case UR_MOVED:
-            item->Move( aRedoCommand ? aList->m_TransformPoint : -aList->m_TransformPoint );
+        {
+            // Moves recorded by a commit store a vector per item, block moves share
+            // the list transform point
+            const ITEM_PICKER& wrapper = aList->GetItemWrapper( ii );
+            wxPoint moveVector = wrapper.HasMoveVector() ? wrapper.GetMoveVector()
+                                                         : aList->m_TransformPoint;
+
+            item->Move( aRedoCommand ? moveVector : -moveVector );
+
+            if( item->Type() == PCB_MODULE_T )
+            {
+                MODULE* module = static_cast<MODULE*>( item );
+                module->RunOnChildren( [&view] ( BOARD_ITEM* aChild )
+                                       { view->Update( aChild, KIGFX::GEOMETRY ); } );
+            }
+
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
-            break;
+        }
+        break;
 
         case UR_ROTATED:
             item->Rotate( aList->m_TransformPoint,
@@ -31,6 +31,7 @@
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/string.h>
+#include <wx/thread.h>
 
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
@@ -74,19 +75,28 @@ static SCENEGRAPH* vrmlToSG( VRML_LAYER& vpcb, int idxColor, SGNODE* aParent, do
 
 class LOCALESWITCH
 {
+    // Store the caller's locale, to restore this locale later, in dtor
+    std::string m_locale;
+
 public:
     LOCALESWITCH()
     {
+        m_locale = setlocale( LC_NUMERIC, 0 );
         setlocale( LC_NUMERIC, "C" );
     }
 
     ~LOCALESWITCH()
     {
-        setlocale( LC_NUMERIC, "" );
+        setlocale( LC_NUMERIC, m_locale.c_str() );
     }
 };
 
 
+// the IDF parser and the color index are not reentrant; the 3D cache may call Load()
+// from several threads
+static wxCriticalSection lockIDF;
+
+
 static SGNODE* getColor( IFSG_SHAPE& shape, int colorIdx )
 {
     IFSG_APPEARANCE material( shape );
@@ -284,6 +294,8 @@ SCENEGRAPH* Load( char const* aFileName )
     if( NULL == aFileName )
         return NULL;
 
+    wxCriticalSectionLocker lock( lockIDF );
+
     wxFileName fname;
     fname.Assign( wxString::FromUTF8Unchecked( aFileName ) );
 
@@ -27,11 +27,15 @@
  */
 
 #include <wx/filename.h>
+#include <wx/thread.h>
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
 
 SCENEGRAPH* LoadModel( char const* filename );
 
+// OCE is not known to be reentrant; the 3D cache may call Load() from several threads
+static wxCriticalSection lockOCE;
+
 #define PLUGIN_OCE_MAJOR 1
 #define PLUGIN_OCE_MINOR 1
 #define PLUGIN_OCE_PATCH 1
@@ -163,5 +167,7 @@ SCENEGRAPH* Load( char const* aFileName )
     if( !wxFileName::FileExists( fname ) )
         return NULL;
 
+    wxCriticalSectionLocker lock( lockOCE );
+
     return LoadModel( aFileName );
 }
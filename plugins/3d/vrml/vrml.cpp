@@ -34,10 +34,13 @@
 #include <locale.h>
 #include <wx/log.h>
 #include <wx/filename.h>
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
 #include "richio.h"
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
 #include "wrlproc.h"
+#include "wrlmap.h"
 #include "vrml1_base.h"
 #include "vrml2_base.h"
 #include "x3d.h"
@@ -156,43 +159,59 @@ bool CanRender( void )
 }
 
 
+// the locale is global: as for LOCALE_IO, the loads running in several threads share
+// one switch, and the user locale is restored when the last one is done
+static wxCriticalSection lockLocale;
+static int localeCount = 0;
+static std::string userLocale;
+
 class LOCALESWITCH
 {
-    // Store the user locale name, to restore this locale later, in dtor
-    std::string m_locale;
-
 public:
     LOCALESWITCH()
     {
-        m_locale = setlocale( LC_NUMERIC, 0 );
-        setlocale( LC_NUMERIC, "C" );
+        wxCriticalSectionLocker lock( lockLocale );
+
+        if( localeCount++ == 0 )
+        {
+            // Store the user locale name, to restore this locale later, in dtor
+            userLocale = setlocale( LC_NUMERIC, 0 );
+            setlocale( LC_NUMERIC, "C" );
+        }
     }
 
     ~LOCALESWITCH()
     {
-        setlocale( LC_NUMERIC, m_locale.c_str() );
+        wxCriticalSectionLocker lock( lockLocale );
+
+        if( --localeCount == 0 )
+            setlocale( LC_NUMERIC, userLocale.c_str() );
     }
 };
 
 
 SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
 {
-    FILE_LINE_READER* modelFile = NULL;
+    MAPPED_LINE_READER* modelFile = NULL;
     SCENEGRAPH* scene = NULL;
 
     try
     {
-        // set the max char limit to 8MB; if a VRML file contains
-        // longer lines then perhaps it shouldn't be used
-        modelFile = new FILE_LINE_READER( aFileName, 0, 8388608 );
+        // the file is memory mapped, so that the MF arrays are read directly from it
+        // by the bulk tokenizer of WRLPROC; set the max char limit to 8MB; if a VRML
+        // file contains longer lines then perhaps it shouldn't be used
+        modelFile = new MAPPED_LINE_READER( aFileName, 8388608 );
     }
-    catch( IO_ERROR & )
+    catch( const IO_ERROR& ioe )
     {
-        wxLogError( _( " * [INFO] load failed: input line too long\n" ) );
+        wxLogError( _( " * [INFO] load failed: %s\n" ), ioe.Problem() );
         return NULL;
     }
 
 
+    // the parse time is traced to compare the parser performance across models
+    wxStopWatch parseTime;
+
     // VRML file processor
     WRLPROC proc( modelFile );
 
@@ -208,7 +227,7 @@ SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
         }
         else
         {
-            wxLogTrace( MASK_VRML, " * [INFO] load completed\n" );
+            wxLogTrace( MASK_VRML, " * [INFO] load completed in %ld ms\n", parseTime.Time() );
 
             scene = (SCENEGRAPH*)bp->TranslateToSG( NULL, NULL );
         }
@@ -230,7 +249,7 @@ SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
         }
         else
         {
-            wxLogTrace( MASK_VRML, " * [INFO] load completed\n" );
+            wxLogTrace( MASK_VRML, " * [INFO] load completed in %ld ms\n", parseTime.Time() );
 
             // for now we recalculate all normals per-vertex per-face
             scene = (SCENEGRAPH*)bp->TranslateToSG( NULL );
@@ -0,0 +1,188 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstring>
+
+#include <wx/intl.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "wrlmap.h"
+
+
+MAPPED_LINE_READER::MAPPED_LINE_READER( const wxString& aFileName, unsigned aMaxLineLength ) :
+    LINE_READER( aMaxLineLength )
+{
+    m_data = NULL;
+    m_size = 0;
+    m_lineOffset = 0;
+    m_nextOffset = 0;
+    source = aFileName;
+
+    wxString msg = wxString::Format(
+        _( "Unable to open filename '%s' for reading" ), aFileName.GetData() );
+
+    #if defined(_WIN32)
+    m_mapping = NULL;
+    m_file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+
+    if( INVALID_HANDLE_VALUE == m_file )
+        THROW_IO_ERROR( msg );
+
+    LARGE_INTEGER size;
+
+    if( !GetFileSizeEx( m_file, &size )
+        || (ULONGLONG) size.QuadPart > (ULONGLONG) (size_t) -1 )
+    {
+        unmapFile();
+        THROW_IO_ERROR( msg );
+    }
+
+    // an empty file cannot be mapped
+    if( 0 == size.QuadPart )
+        return;
+
+    m_mapping = CreateFileMappingW( m_file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+    if( NULL != m_mapping )
+        m_data = (const char*) MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+
+    if( NULL == m_data )
+    {
+        unmapFile();
+        THROW_IO_ERROR( msg );
+    }
+
+    m_size = (size_t) size.QuadPart;
+    #else
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd < 0 )
+        THROW_IO_ERROR( msg );
+
+    struct stat st;
+
+    if( fstat( fd, &st ) != 0 )
+    {
+        close( fd );
+        THROW_IO_ERROR( msg );
+    }
+
+    // an empty file cannot be mapped
+    if( 0 == st.st_size )
+    {
+        close( fd );
+        return;
+    }
+
+    void* data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    // the mapping remains valid after the file is closed
+    close( fd );
+
+    if( MAP_FAILED == data )
+        THROW_IO_ERROR( msg );
+
+    m_data = (const char*) data;
+    m_size = st.st_size;
+    #endif
+}
+
+
+MAPPED_LINE_READER::~MAPPED_LINE_READER()
+{
+    unmapFile();
+}
+
+
+void MAPPED_LINE_READER::unmapFile( void )
+{
+    #if defined(_WIN32)
+    if( m_data )
+        UnmapViewOfFile( m_data );
+
+    if( m_mapping )
+        CloseHandle( m_mapping );
+
+    if( INVALID_HANDLE_VALUE != m_file )
+        CloseHandle( m_file );
+
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = NULL;
+    #else
+    if( m_data )
+        munmap( (void*) m_data, m_size );
+    #endif
+
+    m_data = NULL;
+    m_size = 0;
+}
+
+
+char* MAPPED_LINE_READER::ReadLine()
+{
+    m_lineOffset = m_nextOffset;
+    length = 0;
+
+    if( m_nextOffset < m_size )
+    {
+        const char* start = m_data + m_nextOffset;
+        const char* nl = (const char*) memchr( start, '\n', m_size - m_nextOffset );
+
+        // include the newline, as the other readers do
+        size_t len = nl ? nl - start + 1 : m_size - m_nextOffset;
+
+        if( len >= maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        if( len + 1 > capacity )   // +1 for terminating nul
+            expandCapacity( len + 1 );
+
+        memcpy( line, start, len );
+        length = len;
+        m_nextOffset += len;
+    }
+
+    line[ length ] = 0;
+
+    // lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++lineNum;
+
+    return length ? line : NULL;
+}
+
+
+void MAPPED_LINE_READER::SetNextLine( size_t aOffset, unsigned aLineNumber )
+{
+    m_nextOffset = aOffset < m_size ? aOffset : m_size;
+    lineNum = aLineNumber - 1;
+}
@@ -0,0 +1,112 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file wrlmap.h
+ * defines a LINE_READER over a memory mapped file, whose data can also be read
+ * directly by the bulk tokenizer of WRLPROC
+ */
+
+
+#ifndef WRLMAP_H
+#define WRLMAP_H
+
+#include <cstddef>
+
+#include "richio.h"
+
+
+class MAPPED_LINE_READER : public LINE_READER
+{
+private:
+    // prohibit assignment and default copy constructor
+    MAPPED_LINE_READER( const MAPPED_LINE_READER& source );
+    MAPPED_LINE_READER& operator=( const MAPPED_LINE_READER& source );
+
+    const char* m_data;         // the mapped file; NULL if the file is empty
+    size_t      m_size;         // size of the mapped file
+    size_t      m_lineOffset;   // offset of the line returned by the last ReadLine()
+    size_t      m_nextOffset;   // offset of the line returned by the next ReadLine()
+
+    #if defined(_WIN32)
+    void*       m_file;         // file and mapping handles
+    void*       m_mapping;
+    #endif
+
+    void unmapFile( void );
+
+public:
+    /**
+     * Constructor MAPPED_LINE_READER
+     * maps the whole file in memory.
+     *
+     * @param aFileName is the name of the file to read
+     * @param aMaxLineLength is the longest line ReadLine() may return
+     * @throw IO_ERROR if the file cannot be opened or mapped
+     */
+    MAPPED_LINE_READER( const wxString& aFileName,
+                        unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MAPPED_LINE_READER();
+
+    char* ReadLine() override;
+
+    /**
+     * Function Data
+     * @return the mapped file, which is not nul terminated, or NULL if the file is empty
+     */
+    const char* Data() const
+    {
+        return m_data;
+    }
+
+    /**
+     * Function Size
+     * @return the size of the mapped file
+     */
+    size_t Size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Function LineOffset
+     * @return the offset in the mapped file of the line returned by the last ReadLine()
+     */
+    size_t LineOffset() const
+    {
+        return m_lineOffset;
+    }
+
+    /**
+     * Function SetNextLine
+     * makes the next ReadLine() return the line at aOffset, numbered aLineNumber; it
+     * is used to go back to reading lines after reading the data directly.
+     *
+     * @param aOffset is the offset of the start of a line in the mapped file
+     * @param aLineNumber is the number of this line
+     */
+    void SetNextLine( size_t aOffset, unsigned aLineNumber );
+};
+
+#endif  // WRLMAP_H
@@ -21,12 +21,19 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
 #include <iostream>
 #include <sstream>
 #include <wx/filename.h>
 #include <wx/string.h>
 #include <wx/log.h>
 #include "wrlproc.h"
+#include "wrlmap.h"
 
 #define GETLINE do {\
     try { \
@@ -46,8 +53,16 @@
     } } while( 0 )
 
 
+WRLPROC::WRLPROC( MAPPED_LINE_READER* aLineReader ) :
+    WRLPROC( (LINE_READER*) aLineReader )
+{
+    m_map = aLineReader;
+}
+
+
 WRLPROC::WRLPROC( LINE_READER* aLineReader )
 {
+    m_map = NULL;
     m_fileVersion = VRML_INVALID;
     m_eof = false;
     m_fileline = 0;
@@ -233,6 +248,329 @@ const char* WRLPROC::GetParentDir( void )
 }
 
 
+// true if the character ends a number: white space, comma, brace, bracket or end of line
+static inline bool isNumberEnd( char aChar )
+{
+    return aChar <= 0x20 || ',' == aChar || '{' == aChar || '}' == aChar
+           || '[' == aChar || ']' == aChar;
+}
+
+
+// converts the decimal numbers with up to 7 significant digits and a small exponent,
+// which are most of the numbers of the models: the digits and the power of ten are
+// exact floats, so a single multiplication or division gives the same value as strtof().
+// Returns false for the other numbers, which are left to strtof()
+static bool fastFloat( const char* aText, const char*& aEnd, float& aValue )
+{
+    static const float powers[] =
+    {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    const char* cp = aText;
+    bool negative = '-' == *cp;
+
+    if( '-' == *cp || '+' == *cp )
+        ++cp;
+
+    uint32_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+
+    for( ; *cp >= '0' && *cp <= '9'; ++cp, ++digits )
+    {
+        mantissa = mantissa * 10 + ( *cp - '0' );
+
+        if( mantissa > ( 1 << 24 ) )
+            return false;
+    }
+
+    if( '.' == *cp )
+    {
+        for( ++cp; *cp >= '0' && *cp <= '9'; ++cp, ++digits, --exponent )
+        {
+            mantissa = mantissa * 10 + ( *cp - '0' );
+
+            if( mantissa > ( 1 << 24 ) )
+                return false;
+        }
+    }
+
+    if( 0 == digits )
+        return false;
+
+    if( 'e' == *cp || 'E' == *cp )
+    {
+        ++cp;
+        bool negExp = '-' == *cp;
+
+        if( '-' == *cp || '+' == *cp )
+            ++cp;
+
+        if( *cp < '0' || *cp > '9' )
+            return false;
+
+        int exp = 0;
+
+        for( ; *cp >= '0' && *cp <= '9'; ++cp )
+        {
+            exp = exp * 10 + ( *cp - '0' );
+
+            if( exp > 100 )
+                return false;
+        }
+
+        exponent += negExp ? -exp : exp;
+    }
+
+    if( exponent < -10 || exponent > 10 || !isNumberEnd( *cp ) )
+        return false;
+
+    float value = (float) mantissa;
+
+    if( exponent < 0 )
+        value /= powers[-exponent];
+    else
+        value *= powers[exponent];
+
+    aValue = negative ? -value : value;
+    aEnd = cp;
+    return true;
+}
+
+
+// converts the float at aText, which must end at a space, comma, brace, bracket or nul
+// character; aEnd is set to the end of the number.  strtof() is not locale independent
+// but the plugin sets the "C" numeric locale
+static bool convertFloat( const char* aText, const char*& aEnd, float& aValue )
+{
+    const char* dp = ( '-' == *aText || '+' == *aText ) ? aText + 1 : aText;
+
+    // reject the forms accepted by strtof() only (infinity, nan, leading blanks)
+    if( !( ( *dp >= '0' && *dp <= '9' ) || '.' == *dp ) )
+        return false;
+
+    // and the hexadecimal floats
+    if( '0' == dp[0] && ( 'x' == dp[1] || 'X' == dp[1] ) )
+        return false;
+
+    if( fastFloat( aText, aEnd, aValue ) )
+        return true;
+
+    char* ep;
+    errno = 0;
+    float value = strtof( aText, &ep );
+
+    if( ep == aText || !isNumberEnd( *ep ) )
+        return false;
+
+    // an underflow also sets ERANGE but gives zero or a denormal, which is kept as
+    // the istream extraction did; only an overflow is an error
+    if( ERANGE == errno && fabsf( value ) == HUGE_VALF )
+        return false;
+
+    aValue = value;
+    aEnd = ep;
+    return true;
+}
+
+
+// converts the integer at aText, as convertFloat()
+static bool convertInt( const char* aText, const char*& aEnd, int& aValue )
+{
+    const char* dp = ( '-' == *aText || '+' == *aText ) ? aText + 1 : aText;
+
+    if( *dp < '0' || *dp > '9' )
+        return false;
+
+    // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
+    // this instance we do no enforce case.
+    int base = ( '0' == dp[0] && ( 'x' == dp[1] || 'X' == dp[1] ) ) ? 16 : 10;
+
+    char* ep;
+    errno = 0;
+    long value = strtol( aText, &ep, base );
+
+    if( ep == aText || ERANGE == errno || !isNumberEnd( *ep ) )
+        return false;
+
+    if( value < INT_MIN || value > INT_MAX )
+        return false;
+
+    aValue = (int) value;
+    aEnd = ep;
+    return true;
+}
+
+
+bool WRLPROC::parseFloat( float& aValue )
+{
+    // the number is converted in place, without copying it to a string or stream
+    const char* sp = m_buf.c_str() + m_bufpos;
+    const char* ep;
+
+    if( !convertFloat( sp, ep, aValue ) )
+        return false;
+
+    m_bufpos += ep - sp;
+
+    // the comma is a special instance of blank space
+    if( ',' == m_buf[m_bufpos] )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+bool WRLPROC::parseInt( int& aValue )
+{
+    const char* sp = m_buf.c_str() + m_bufpos;
+    const char* ep;
+
+    if( !convertInt( sp, ep, aValue ) )
+        return false;
+
+    m_bufpos += ep - sp;
+
+    if( ',' == m_buf[m_bufpos] )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+template< typename T >
+bool WRLPROC::readBulk( std::vector< T >& aValues, size_t aTupleSize,
+                        bool (*aConvert)( const char*, const char*&, T& ),
+                        size_t aFileLine, size_t aLinePos )
+{
+    aValues.clear();
+
+    const char* data = m_map->Data();
+    size_t size = m_map->Size();
+    size_t lineStart = m_map->LineOffset();
+    size_t pos = lineStart + m_bufpos;
+    unsigned int line = m_fileline;
+    const char* reason = NULL;
+
+    // the numbers are copied to a nul terminated buffer for the conversion, as the
+    // mapped file is not terminated
+    char token[64];
+    std::string longToken;
+
+    while( true )
+    {
+        // skip the white space, the commas and the comments
+        while( pos < size )
+        {
+            char c = data[pos];
+
+            if( VRML_V1 == m_fileVersion && ( c & 0x80 ) )
+            {
+                reason = "non-ASCII character sequence in VRML1 file";
+                break;
+            }
+
+            if( '\n' == c )
+            {
+                ++line;
+                lineStart = ++pos;
+            }
+            else if( c <= 0x20 || ',' == c )
+            {
+                ++pos;
+            }
+            else if( '#' == c )
+            {
+                while( pos < size && '\n' != data[pos] )
+                    ++pos;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if( reason )
+            break;
+
+        if( pos == size )
+        {
+            reason = "unexpected end of file in array";
+            break;
+        }
+
+        if( ']' == data[pos] )
+        {
+            if( aValues.size() % aTupleSize )
+                reason = "incomplete tuple at the end of the array";
+
+            break;
+        }
+
+        size_t end = pos;
+
+        while( end < size && !isNumberEnd( data[end] ) )
+            ++end;
+
+        const char* text;
+
+        if( end - pos < sizeof( token ) )
+        {
+            memcpy( token, data + pos, end - pos );
+            token[end - pos] = 0;
+            text = token;
+        }
+        else
+        {
+            longToken.assign( data + pos, end - pos );
+            text = longToken.c_str();
+        }
+
+        const char* ep;
+        T value;
+
+        if( !aConvert( text, ep, value ) )
+        {
+            reason = "invalid number in array";
+            break;
+        }
+
+        aValues.push_back( value );
+        pos = end;
+    }
+
+    // go back to reading lines, on the line of the closing bracket or of the error
+    m_map->SetNextLine( lineStart, line );
+    m_buf.clear();
+
+    if( !getRawLine() && !reason )
+        reason = "could not read the end of the array";
+
+    m_bufpos = pos - lineStart;
+
+    if( m_bufpos > m_buf.size() )
+        m_bufpos = m_buf.size();
+
+    if( reason )
+    {
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << aFileLine << ", char " << aLinePos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << reason;
+        m_error = ostr.str();
+
+        return false;
+    }
+
+    // skip the closing bracket
+    ++m_bufpos;
+    return true;
+}
+
+
 bool WRLPROC::ReadGlob( std::string& aGlob )
 {
     aGlob.clear();
@@ -811,9 +1149,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
+    if( !EatSpace() )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -826,11 +1162,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
         return false;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseFloat( aSFFloat ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -871,9 +1203,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
+    if( !EatSpace() )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -886,21 +1216,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
         return false;
     }
 
-    if( std::string::npos != tmp.find( "0x" ) )
-    {
-        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
-        // this instance we do no enforce case.
-        std::stringstream sstr;
-        sstr << std::hex << tmp;
-        sstr >> aSFInt32;
-        return true;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseInt( aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -945,12 +1261,11 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             break;
     }
 
-    std::string tmp;
     float trot[4];
 
     for( int i = 0; i < 4; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -963,11 +1278,7 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( trot[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1017,13 +1328,11 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[2];
 
     for( int i = 0; i < 2; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1036,11 +1345,7 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1089,13 +1394,11 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[3];
 
     for( int i = 0; i < 3; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1108,18 +1411,7 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
-        // ignore any commas
-        if( !EatSpace() )
-            return false;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1132,6 +1424,12 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
+        // ignore any commas
+        if( !EatSpace() )
+            return false;
+
+        if( ',' == m_buf[m_bufpos] )
+            Pop();
     }
 
     aSFVec3f.x = tcol[0];
@@ -1324,6 +1622,41 @@ bool WRLPROC::ReadMFColor( std::vector< WRLVEC3F >& aMFColor )
 
     ++m_bufpos;
 
+    if( m_map )
+    {
+        std::vector< float > values;
+
+        if( !readBulk( values, 3, convertFloat, fileline, linepos ) )
+            return false;
+
+        for( size_t i = 0; i < values.size(); ++i )
+        {
+            if( values[i] < 0.0 || values[i] > 1.0 )
+            {
+                std::ostringstream ostr;
+                ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+                ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+                ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+                ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+                ostr << " * [INFO] invalid RGB value in color triplet";
+                m_error = ostr.str();
+
+                return false;
+            }
+        }
+
+        aMFColor.resize( values.size() / 3 );
+
+        for( size_t i = 0; i < aMFColor.size(); ++i )
+        {
+            aMFColor[i].x = values[3 * i];
+            aMFColor[i].y = values[3 * i + 1];
+            aMFColor[i].z = values[3 * i + 2];
+        }
+
+        return true;
+    }
+
     while( true )
     {
         if( !EatSpace() )
@@ -1436,6 +1769,9 @@ bool WRLPROC::ReadMFFloat( std::vector< float >& aMFFloat )
 
     ++m_bufpos;
 
+    if( m_map )
+        return readBulk( aMFFloat, 1, convertFloat, fileline, linepos );
+
     while( true )
     {
         if( !EatSpace() )
@@ -1548,6 +1884,9 @@ bool WRLPROC::ReadMFInt( std::vector< int >& aMFInt32 )
 
     ++m_bufpos;
 
+    if( m_map )
+        return readBulk( aMFInt32, 1, convertInt, fileline, linepos );
+
     while( true )
     {
         if( !EatSpace() )
@@ -1660,6 +1999,26 @@ bool WRLPROC::ReadMFRotation( std::vector< WRLROTATION >& aMFRotation )
 
     ++m_bufpos;
 
+    if( m_map )
+    {
+        std::vector< float > values;
+
+        if( !readBulk( values, 4, convertFloat, fileline, linepos ) )
+            return false;
+
+        aMFRotation.resize( values.size() / 4 );
+
+        for( size_t i = 0; i < aMFRotation.size(); ++i )
+        {
+            aMFRotation[i].x = values[4 * i];
+            aMFRotation[i].y = values[4 * i + 1];
+            aMFRotation[i].z = values[4 * i + 2];
+            aMFRotation[i].w = values[4 * i + 3];
+        }
+
+        return true;
+    }
+
     while( true )
     {
         if( !EatSpace() )
@@ -1772,6 +2131,24 @@ bool WRLPROC::ReadMFVec2f( std::vector< WRLVEC2F >& aMFVec2f )
 
     ++m_bufpos;
 
+    if( m_map )
+    {
+        std::vector< float > values;
+
+        if( !readBulk( values, 2, convertFloat, fileline, linepos ) )
+            return false;
+
+        aMFVec2f.resize( values.size() / 2 );
+
+        for( size_t i = 0; i < aMFVec2f.size(); ++i )
+        {
+            aMFVec2f[i].x = values[2 * i];
+            aMFVec2f[i].y = values[2 * i + 1];
+        }
+
+        return true;
+    }
+
     while( true )
     {
         if( !EatSpace() )
@@ -1884,6 +2261,25 @@ bool WRLPROC::ReadMFVec3f( std::vector< WRLVEC3F >& aMFVec3f )
 
     ++m_bufpos;
 
+    if( m_map )
+    {
+        std::vector< float > values;
+
+        if( !readBulk( values, 3, convertFloat, fileline, linepos ) )
+            return false;
+
+        aMFVec3f.resize( values.size() / 3 );
+
+        for( size_t i = 0; i < aMFVec3f.size(); ++i )
+        {
+            aMFVec3f[i].x = values[3 * i];
+            aMFVec3f[i].y = values[3 * i + 1];
+            aMFVec3f[i].z = values[3 * i + 2];
+        }
+
+        return true;
+    }
+
     while( true )
     {
         if( !EatSpace() )
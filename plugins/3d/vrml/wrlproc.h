@@ -37,10 +37,13 @@
 #include "richio.h"
 #include "wrltypes.h"
 
+class MAPPED_LINE_READER;
+
 class WRLPROC
 {
 private:
     LINE_READER* m_file;
+    MAPPED_LINE_READER* m_map;  // m_file if the file is memory mapped, else NULL
     std::string m_buf;          // string being parsed
     bool m_eof;
     unsigned int m_fileline;
@@ -58,8 +61,27 @@ private:
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // parseFloat and parseInt convert the number at the current position of
+    // m_buf, which must be a non-blank character, and skip it along with a
+    // comma following it. They return 'false' and leave the position unchanged
+    // if the text is not a number which ends at a space, comma, brace or bracket.
+    bool parseFloat( float& aValue );
+    bool parseInt( int& aValue );
+
+    // readBulk is the tokenizer of the MF arrays of a memory mapped file. Called
+    // after the opening bracket, it converts the numbers up to the closing bracket
+    // directly from the mapped data, then reads the line of the bracket into m_buf
+    // and skips the bracket. The number of values must be a multiple of aTupleSize;
+    // aFileLine and aLinePos are the position of the array for the error messages.
+    template< typename T >
+    bool readBulk( std::vector< T >& aValues, size_t aTupleSize,
+                   bool (*aConvert)( const char*, const char*&, T& ),
+                   size_t aFileLine, size_t aLinePos );
+
 public:
     WRLPROC( LINE_READER* aLineReader );
+    // the MF arrays of a mapped file are read by the bulk tokenizer
+    WRLPROC( MAPPED_LINE_READER* aLineReader );
     ~WRLPROC();
 
     bool eof( void );
@@ -428,6 +428,11 @@ bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 
 SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 {
+    // an open plugin is called without touching the loader, so that several threads
+    // may load models at once; the plugin itself must be reentrant or lock its Load()
+    if( ok && NULL != m_load )
+        return m_load( aFileName );
+
     m_error.clear();
 
     if( !ok && !reopen() )
@@ -0,0 +1,200 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <3d_cache/3d_render_cache.h>
+
+
+/**
+ * A model of two meshes sharing their vertices: the first one without texture coordinates
+ * and colors, the second one without normals.
+ */
+struct RenderCacheFixture
+{
+    SMATERIAL   m_materials[2];
+    SFVEC3F     m_positions[3];
+    SFVEC3F     m_normals[3];
+    SFVEC2F     m_texcoords[3];
+    SFVEC3F     m_colors[3];
+    unsigned    m_faceIdx[3];
+    SMESH       m_meshes[2];
+    S3DMODEL    m_model;
+    wxString    m_fileName;
+
+    RenderCacheFixture()
+    {
+        for( int i = 0; i < 2; ++i )
+        {
+            m_materials[i].m_Ambient = SFVEC3F( i, 0.1f, 0.2f );
+            m_materials[i].m_Diffuse = SFVEC3F( 0.3f, 0.4f, 0.5f );
+            m_materials[i].m_Emissive = SFVEC3F( 0.0f, 0.0f, 0.0f );
+            m_materials[i].m_Specular = SFVEC3F( 1.0f, 1.0f, 1.0f );
+            m_materials[i].m_Shininess = 0.5f;
+            m_materials[i].m_Transparency = 0.25f * i;
+        }
+
+        for( int i = 0; i < 3; ++i )
+        {
+            m_positions[i] = SFVEC3F( i, 2 * i, 3 * i );
+            m_normals[i] = SFVEC3F( 0.0f, 0.0f, 1.0f );
+            m_texcoords[i] = SFVEC2F( i, -i );
+            m_colors[i] = SFVEC3F( 0.5f, i, 0.0f );
+            m_faceIdx[i] = 2 - i;
+        }
+
+        SMESH& first = m_meshes[0];
+        first.m_VertexSize = 3;
+        first.m_Positions = m_positions;
+        first.m_Normals = m_normals;
+        first.m_Texcoords = NULL;
+        first.m_Color = NULL;
+        first.m_FaceIdxSize = 3;
+        first.m_FaceIdx = m_faceIdx;
+        first.m_MaterialIdx = 1;
+
+        SMESH& second = m_meshes[1];
+        second = first;
+        second.m_Normals = NULL;
+        second.m_Texcoords = m_texcoords;
+        second.m_Color = m_colors;
+        second.m_MaterialIdx = 0;
+
+        m_model.m_MeshesSize = 2;
+        m_model.m_Meshes = m_meshes;
+        m_model.m_MaterialsSize = 2;
+        m_model.m_Materials = m_materials;
+
+        m_fileName = wxFileName::CreateTempFileName( wxT( "qa3dr" ) );
+    }
+
+    ~RenderCacheFixture()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    /**
+     * Removes the last aBytes bytes of the file.
+     */
+    void truncateFile( long aBytes )
+    {
+        FILE* fp = fopen( m_fileName.ToUTF8(), "rb" );
+        BOOST_REQUIRE( fp );
+
+        std::vector<char> data;
+        char buffer[1024];
+        size_t count;
+
+        while( ( count = fread( buffer, 1, sizeof( buffer ), fp ) ) > 0 )
+            data.insert( data.end(), buffer, buffer + count );
+
+        fclose( fp );
+
+        fp = fopen( m_fileName.ToUTF8(), "wb" );
+        BOOST_REQUIRE( fp );
+        fwrite( &data[0], 1, data.size() - aBytes, fp );
+        fclose( fp );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( RenderCache, RenderCacheFixture )
+
+/**
+ * Checks that a written file is mapped back to the same model and plugin information.
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( S3D_RENDER_CACHE::Write( m_fileName, m_model, "PLUGIN_TEST:1.2.3" ) );
+
+    S3D_RENDER_CACHE cache;
+    BOOST_REQUIRE( cache.Open( m_fileName ) );
+    BOOST_CHECK_EQUAL( cache.GetPluginInfo(), "PLUGIN_TEST:1.2.3" );
+
+    S3DMODEL* model = cache.GetModel();
+    BOOST_REQUIRE( model );
+    BOOST_REQUIRE_EQUAL( model->m_MaterialsSize, 2u );
+    BOOST_REQUIRE_EQUAL( model->m_MeshesSize, 2u );
+
+    for( int i = 0; i < 2; ++i )
+    {
+        BOOST_CHECK( model->m_Materials[i].m_Ambient == m_materials[i].m_Ambient );
+        BOOST_CHECK( model->m_Materials[i].m_Diffuse == m_materials[i].m_Diffuse );
+        BOOST_CHECK_EQUAL( model->m_Materials[i].m_Transparency,
+                           m_materials[i].m_Transparency );
+    }
+
+    const SMESH& first = model->m_Meshes[0];
+    const SMESH& second = model->m_Meshes[1];
+
+    BOOST_CHECK_EQUAL( first.m_MaterialIdx, 1u );
+    BOOST_CHECK_EQUAL( second.m_MaterialIdx, 0u );
+    BOOST_CHECK( first.m_Texcoords == NULL && first.m_Color == NULL );
+    BOOST_CHECK( second.m_Normals == NULL );
+
+    for( int i = 0; i < 3; ++i )
+    {
+        BOOST_CHECK( first.m_Positions[i] == m_positions[i] );
+        BOOST_CHECK( first.m_Normals[i] == m_normals[i] );
+        BOOST_CHECK( second.m_Texcoords[i] == m_texcoords[i] );
+        BOOST_CHECK( second.m_Color[i] == m_colors[i] );
+        BOOST_CHECK_EQUAL( second.m_FaceIdx[i], m_faceIdx[i] );
+    }
+
+    cache.Close();
+    BOOST_CHECK( cache.GetModel() == NULL );
+}
+
+/**
+ * Checks that a model cannot be written without the information of its plugin, and that
+ * a file with invalid data is rejected when mapped.
+ */
+BOOST_AUTO_TEST_CASE( Validation )
+{
+    BOOST_CHECK( !S3D_RENDER_CACHE::Write( m_fileName, m_model, "" ) );
+
+    // an index out of the vertex array
+    m_faceIdx[0] = 3;
+    BOOST_REQUIRE( S3D_RENDER_CACHE::Write( m_fileName, m_model, "PLUGIN_TEST:1.2.3" ) );
+
+    S3D_RENDER_CACHE cache;
+    BOOST_CHECK( !cache.Open( m_fileName ) );
+
+    // an array out of the file
+    m_faceIdx[0] = 0;
+    BOOST_REQUIRE( S3D_RENDER_CACHE::Write( m_fileName, m_model, "PLUGIN_TEST:1.2.3" ) );
+    BOOST_REQUIRE( cache.Open( m_fileName ) );
+    cache.Close();
+
+    truncateFile( 4 );
+    BOOST_CHECK( !cache.Open( m_fileName ) );
+    BOOST_CHECK( cache.GetModel() == NULL );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
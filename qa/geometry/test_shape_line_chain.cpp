@@ -0,0 +1,53 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_line_chain.h>
+
+#include <qa/data/fixtures_geometry.h>
+
+#include <cmath>
+
+/**
+ * Declares the common test data as the boost test suite fixture.
+ */
+BOOST_FIXTURE_TEST_SUITE( ShapeLineChain, CommonTestData )
+
+/**
+ * Checks SHAPE_LINE_CHAIN::Area() on the contours of the holey polygon, and that its sign
+ * only depends on the orientation of the contour.
+ */
+BOOST_AUTO_TEST_CASE( LineChainArea )
+{
+    const SHAPE_LINE_CHAIN& outline = holeyPolySet.COutline( 0 );
+
+    BOOST_CHECK_CLOSE( std::abs( outline.Area() ), 10000.0, 1e-6 );
+    BOOST_CHECK_CLOSE( std::abs( holeyPolySet.CHole( 0, 0 ).Area() ), 75.0, 1e-6 );
+    BOOST_CHECK_CLOSE( std::abs( holeyPolySet.CHole( 0, 1 ).Area() ), 100.0, 1e-6 );
+    BOOST_CHECK_CLOSE( outline.Reverse().Area(), -outline.Area(), 1e-6 );
+
+    BOOST_CHECK_EQUAL( SHAPE_LINE_CHAIN().Area(), 0.0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
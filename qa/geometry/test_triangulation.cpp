@@ -0,0 +1,108 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * @author Tomasz Wlostowski <tomasz.wlostowski@cern.ch>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_line_chain.h>
+
+#include <qa/data/fixtures_geometry.h>
+
+/**
+ * Sums the areas of the triangles in the cached triangulation of aPolySet.
+ */
+static double triangulatedArea( const SHAPE_POLY_SET& aPolySet )
+{
+    double area = 0.0;
+
+    for( unsigned int i = 0; i < aPolySet.TriangulatedPolyCount(); i++ )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri = aPolySet.TriangulatedPolygon( i );
+
+        for( int j = 0; j < tri->GetTriangleCount(); j++ )
+        {
+            VECTOR2I a, b, c;
+            tri->GetTriangle( j, a, b, c );
+
+            area += std::abs( (double) ( b - a ).Cross( c - a ) ) / 2.0;
+        }
+    }
+
+    return area;
+}
+
+/**
+ * Declares the common test data as the boost test suite fixture.
+ */
+BOOST_FIXTURE_TEST_SUITE( PolygonTriangulation, CommonTestData )
+
+/**
+ * Checks that the triangulation of a polygon with holes covers exactly its area: the 100x100
+ * square minus the pentagon (75) and the triangle (100).
+ */
+BOOST_AUTO_TEST_CASE( HoleyPolygonArea )
+{
+    BOOST_CHECK( !holeyPolySet.IsTriangulationUpToDate() );
+    BOOST_CHECK( holeyPolySet.CacheTriangulation() );
+    BOOST_CHECK( holeyPolySet.IsTriangulationUpToDate() );
+
+    BOOST_CHECK_EQUAL( holeyPolySet.TriangulatedPolyCount(), 1 );
+    BOOST_CHECK_CLOSE( triangulatedArea( holeyPolySet ), 9825.0, 1e-6 );
+}
+
+/**
+ * Checks that copies share the cached triangulation and that modifying the polygons, even
+ * through the non-const accessors, invalidates it.
+ */
+BOOST_AUTO_TEST_CASE( CacheInvalidation )
+{
+    holeyPolySet.CacheTriangulation();
+
+    SHAPE_POLY_SET copy( holeyPolySet );
+
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolygon( 0 ), holeyPolySet.TriangulatedPolygon( 0 ) );
+
+    copy.Vertex( 0 ) = VECTOR2I( 200, 200 );
+    BOOST_CHECK( !copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( holeyPolySet.IsTriangulationUpToDate() );
+
+    copy.Move( VECTOR2I( 10, 10 ) );
+    copy.CacheTriangulation();
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+
+    copy.RemoveAllContours();
+    BOOST_CHECK( !copy.IsTriangulationUpToDate() );
+}
+
+/**
+ * Checks that an empty set has an empty, valid triangulation.
+ */
+BOOST_AUTO_TEST_CASE( EmptyPolySet )
+{
+    BOOST_CHECK( emptyPolySet.CacheTriangulation() );
+    BOOST_CHECK_EQUAL( emptyPolySet.TriangulatedPolyCount(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+
+# Build a schematic with a large number of net labels, to measure the
+# performance of the eeschema ERC label tests (similar labels, orphan labels).
+#
+# Every hundredth label has a twin differing only by the case of its text, so
+# the similar labels test has something to report.  One third of the labels
+# are global labels.
+#
+# $ label_schematic.py 50000 /tmp/labels
+#
+# Then open /tmp/labels/labels.pro and run the ERC.  The number of similar
+# labels warnings must be the number of twins printed by this script.
+
+from __future__ import print_function
+import os
+import sys
+
+if len( sys.argv ) < 3:
+    print( "usage: label_schematic.py labelCount dstProjectDir" )
+    sys.exit( 1 )
+
+count = int( sys.argv[1] )
+dst_dir = sys.argv[2]
+
+if not os.path.isdir( dst_dir ):
+    os.makedirs( dst_dir )
+
+columns = 200
+pitch = 200
+
+open( os.path.join( dst_dir, "labels.pro" ), "w" ).close()
+
+twins = 0
+
+with open( os.path.join( dst_dir, "labels.sch" ), "w" ) as out:
+    out.write( "EESchema Schematic File Version 2\n" )
+    out.write( "EELAYER 26 0\nEELAYER END\n" )
+    out.write( "$Descr User %d %d\n" % ( ( columns + 2 ) * pitch,
+                                       ( count // columns + 3 ) * pitch ) )
+    out.write( "encoding utf-8\n" )
+    out.write( "Sheet 1 1\n" )
+    out.write( "Title \"%d labels\"\n" % count )
+    out.write( "$EndDescr\n" )
+
+    for i in range( count ):
+        x = pitch + ( i % columns ) * pitch
+        y = pitch + ( i // columns ) * pitch
+        name = "net_%d" % ( i // 2 if i % 100 == 1 else i )
+
+        if i % 100 == 1:
+            name = name.upper()
+            twins += 1
+
+        if i % 3 == 0:
+            out.write( "Text GLabel %d %d 0    60   Input ~ 0\n%s\n" % ( x, y, name ) )
+        else:
+            out.write( "Text Label %d %d 0    60   ~ 0\n%s\n" % ( x, y, name ) )
+
+    out.write( "$EndSCHEMATC\n" )
+
+print( "Created %s with %d labels, %d of them differing from another one only by case"
+       % ( os.path.join( dst_dir, "labels.sch" ), count, twins ) )
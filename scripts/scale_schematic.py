@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+
+# Build a large schematic hierarchy from an existing project, to measure the
+# netlist and ERC performance of eeschema on big designs.
+#
+# The root sheet of the new project instantiates the root sheet of the source
+# project as many times as requested, using a complex hierarchy (all the
+# instances share the same files).  Each instance is a separate sheet path,
+# so it is netlisted as a separate set of nets.
+#
+# $ scale_schematic.py <path_to>/demos/complex_hierarchy 40 /tmp/scaled
+#
+# Then open /tmp/scaled/scaled.pro and generate the netlist with
+# WXTRACE=KicadNetlist set in the environment to get the netlist timings.
+
+from __future__ import print_function
+import glob
+import os
+import shutil
+import sys
+
+if len( sys.argv ) < 4:
+    print( "usage: scale_schematic.py srcProjectDir copyCount dstProjectDir" )
+    sys.exit( 1 )
+
+src_dir = sys.argv[1]
+count = int( sys.argv[2] )
+dst_dir = sys.argv[3]
+
+projects = glob.glob( os.path.join( src_dir, "*.pro" ) )
+
+if len( projects ) != 1:
+    print( "%s must contain exactly one project file" % src_dir )
+    sys.exit( 1 )
+
+src_name = os.path.splitext( os.path.basename( projects[0] ) )[0]
+
+if not os.path.isdir( dst_dir ):
+    os.makedirs( dst_dir )
+
+# Copy the schematics and libraries of the source project
+for pattern in ( "*.sch", "*.lib", "*.dcm", "sym-lib-table" ):
+    for f in glob.glob( os.path.join( src_dir, pattern ) ):
+        shutil.copy( f, dst_dir )
+
+shutil.copy( projects[0], os.path.join( dst_dir, "scaled.pro" ) )
+
+# The cache library keeps its name: add it to the new project libraries
+cache = os.path.join( dst_dir, src_name + "-cache.lib" )
+
+if os.path.exists( cache ):
+    shutil.copy( cache, os.path.join( dst_dir, "scaled-cache.lib" ) )
+
+with open( os.path.join( src_dir, src_name + ".sch" ) ) as f:
+    libs = [ line for line in f if line.startswith( "LIBS:" ) ]
+
+sheet_w = 2000
+sheet_h = 1000
+columns = 10
+
+with open( os.path.join( dst_dir, "scaled.sch" ), "w" ) as out:
+    out.write( "EESchema Schematic File Version 2\n" )
+    out.writelines( libs )
+    out.write( "EELAYER 26 0\nEELAYER END\n" )
+    out.write( "$Descr User %d %d\n" % ( ( columns + 1 ) * sheet_w * 3 // 2,
+                                       ( count // columns + 2 ) * sheet_h * 3 // 2 ) )
+    out.write( "encoding utf-8\n" )
+    out.write( "Sheet 1 %d\n" % ( count + 1 ) )
+    out.write( "Title \"%d copies of %s\"\n" % ( count, src_name ) )
+    out.write( "$EndDescr\n" )
+
+    for i in range( count ):
+        x = 1000 + ( i % columns ) * sheet_w * 3 // 2
+        y = 1000 + ( i // columns ) * sheet_h * 3 // 2
+
+        out.write( "$Sheet\n" )
+        out.write( "S %d %d %d %d\n" % ( x, y, sheet_w, sheet_h ) )
+        out.write( "U %08X\n" % ( 0x10000000 + i ) )
+        out.write( "F0 \"%s_%d\" 60\n" % ( src_name, i + 1 ) )
+        out.write( "F1 \"%s.sch\" 60\n" % src_name )
+        out.write( "$EndSheet\n" )
+
+    out.write( "$EndSCHEMATC\n" )
+
+print( "Created %s with %d copies of %s" % ( os.path.join( dst_dir, "scaled.sch" ),
+                                           count, src_name ) )
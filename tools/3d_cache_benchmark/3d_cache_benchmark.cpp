@@ -0,0 +1,292 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_cache_benchmark.cpp
+ * measures how long the 3D model cache takes to build the render data of a set of
+ * models, as the 3D viewer does when it opens a board: with an empty cache directory
+ * (every model is parsed by its plugin) and with the cache files written by a
+ * previous run, prefetched in parallel or loaded one at a time.
+ *
+ * The cache directory is taken from XDG_CACHE_HOME, so the benchmark only redirects
+ * it on Linux; elsewhere the user's cache directory would be used, and the cold
+ * benchmarks, which remove the cache files, are skipped.
+ */
+
+#include <wx/wx.h>
+#include <wx/init.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <3d_cache/3d_cache.h>
+
+#include <bench_util.h>
+
+#include <functional>
+#include <iostream>
+#include <memory>
+
+
+/**
+ * A benchmark is always run with a new cache, so that nothing is served from the
+ * memory of a previous cycle; only the cache files are shared.
+ */
+using BENCH_FUNC = std::function<void( S3D_CACHE&, const std::vector<wxString>& )>;
+
+
+static void bench_prefetch( S3D_CACHE& aCache, const std::vector<wxString>& aModels )
+{
+    aCache.PrefetchModels( aModels );
+}
+
+
+static void bench_serial( S3D_CACHE& aCache, const std::vector<wxString>& aModels )
+{
+    for( const wxString& model : aModels )
+        aCache.GetModel( model );
+}
+
+
+/**
+ * The benchmarks run with an empty cache directory: the cache files are removed
+ * before each repetition
+ */
+static std::vector<BENCHMARK<BENCH_FUNC>> coldBenchmarkList =
+{
+    { 'c', bench_prefetch, "cold prefetch" },
+};
+
+
+/**
+ * The benchmarks run with the cache files of all the models
+ */
+static std::vector<BENCHMARK<BENCH_FUNC>> warmBenchmarkList =
+{
+    { 'w', bench_prefetch, "warm prefetch" },
+    { 's', bench_serial, "warm serial" },
+};
+
+
+/**
+ * Lists the models of a directory and its subdirectories which have an extension
+ * handled by the 3D plugins.
+ */
+static std::vector<wxString> findModels( const wxString& aDir )
+{
+    static const char* extensions[] =
+    {
+        "wrl", "wrz", "x3d", "idf", "emn", "step", "stp", "stpz", "igs", "iges"
+    };
+
+    wxArrayString files;
+    wxDir::GetAllFiles( aDir, &files );
+
+    std::vector<wxString> models;
+
+    for( const wxString& file : files )
+    {
+        wxString ext = wxFileName( file ).GetExt().Lower();
+
+        for( const char* modelExt : extensions )
+        {
+            if( ext == modelExt )
+            {
+                models.push_back( file );
+                break;
+            }
+        }
+    }
+
+    return models;
+}
+
+
+static void clearCacheFiles( const wxString& aCacheDir )
+{
+    if( !wxDir::Exists( aCacheDir ) )
+        return;
+
+    wxArrayString files;
+    wxDir::GetAllFiles( aCacheDir, &files );
+
+    for( const wxString& file : files )
+        wxRemoveFile( file );
+}
+
+
+/**
+ * @param aColdCache = true to remove the cache files before each repetition; otherwise
+ * they are written before the first one
+ */
+BENCH_REPORT executeBenchMark( const BENCHMARK<BENCH_FUNC>& aBenchmark, int aReps,
+                               const std::vector<wxString>& aModels,
+                               const wxString& aConfigDir, const wxString& aCacheDir,
+                               bool aColdCache )
+{
+    BENCH_REPORT report = {};
+    BENCH_TIMER  timer;
+
+    // the cache files must exist before a warm repetition
+    if( !aColdCache )
+    {
+        S3D_CACHE cache;
+        cache.Set3DConfigDir( aConfigDir );
+        cache.PrefetchModels( aModels );
+    }
+
+    for( int i = 0; i < aReps; ++i )
+    {
+        if( aColdCache )
+            clearCacheFiles( aCacheDir );
+
+        S3D_CACHE cache;
+        cache.Set3DConfigDir( aConfigDir );
+
+        timer.Start();
+        aBenchmark.func( cache, aModels );
+        timer.Stop();
+
+        // the count is per repetition, as the time is averaged; the models are in
+        // memory now, so counting them is left out of the time
+        report.itemCount = 0;
+
+        for( const wxString& model : aModels )
+        {
+            if( cache.GetModel( model ) )
+                report.itemCount++;
+        }
+    }
+
+    report.benchDurMs = timer.Average();
+
+    return report;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 4 )
+    {
+        os << "Usage: " << argv[0] << " <MODELS_DIR> <CACHE_DIR> <REPS> ["
+           << GetBenchFlags( coldBenchmarkList ) << GetBenchFlags( warmBenchmarkList )
+           << "]\n\n";
+        os << "The 3D plugins are searched where KiCad installs them.  The cache files are\n";
+        os << "written to CACHE_DIR/kicad/3d on Linux and to the user's cache directory\n";
+        os << "elsewhere.  A cold benchmark removes them, so it is only run on Linux.\n\n";
+        os << "Benchmarks:\n";
+        os << GetBenchDescriptions( coldBenchmarkList );
+        os << GetBenchDescriptions( warmBenchmarkList );
+        return BAD_ARGS;
+    }
+
+    // the standard paths used by the cache need an application object
+    wxInitializer initializer;
+
+    if( !initializer.IsOk() )
+        return RUN_ERROR;
+
+    wxFileName modelsDir = wxFileName::DirName( argv[1] );
+    wxFileName cacheHome = wxFileName::DirName( argv[2] );
+    cacheHome.MakeAbsolute();
+
+    long reps = 0;
+    wxString( argv[3] ).ToLong( &reps );
+
+    // get the benchmark to do, or all of them if nothing given
+    wxString bench;
+    if( argc == 5 )
+        bench = argv[4];
+
+    std::vector<wxString> models = findModels( modelsDir.GetPath() );
+
+    if( models.empty() )
+    {
+        os << "No 3D models in " << modelsDir.GetPath() << std::endl;
+        return LOAD_ERROR;
+    }
+
+    wxSetEnv( "XDG_CACHE_HOME", cacheHome.GetPath() );
+
+    wxFileName configDir( cacheHome );
+    configDir.AppendDir( "config" );
+
+    // the directory where S3D_CACHE::Set3DConfigDir() puts the cache files
+    wxString cacheDir;
+    {
+        S3D_CACHE cache;
+
+        if( !cache.Set3DConfigDir( configDir.GetPath() ) )
+        {
+            os << "Cannot create the 3D cache directories in " << cacheHome.GetPath()
+               << std::endl;
+            return RUN_ERROR;
+        }
+
+        cacheDir = cache.GetCacheDir();
+    }
+
+    // never remove the files of the user's cache
+    bool ownCache = cacheDir.StartsWith( cacheHome.GetPathWithSep() );
+
+    PrintBenchTitle( os, "3D Model Cache" );
+
+    PrintBenchParam( os, "Models", wxString::Format( "%s (%u files)",
+            modelsDir.GetPath(), (unsigned) models.size() ) );
+    PrintBenchParam( os, "Cache", cacheDir );
+    PrintBenchParam( os, "Repetitions", wxString::Format( "%d", (int) reps ) );
+    os << std::endl;
+
+    int ret = 0;
+
+    if( ownCache )
+    {
+        ret = RunBenchmarks( os, coldBenchmarkList, bench,
+                [&]( const BENCHMARK<BENCH_FUNC>& aBenchmark )
+                {
+                    return executeBenchMark( aBenchmark, reps, models, configDir.GetPath(),
+                                             cacheDir, true );
+                },
+                "models" );
+    }
+    else
+    {
+        for( auto& bmark : coldBenchmarkList )
+        {
+            if( IsBenchSelected( bmark, bench ) )
+                os << wxString::Format( "%-20s skipped: the cache is not in %s",
+                        bmark.name, cacheHome.GetPath() ) << std::endl;
+        }
+    }
+
+    int warmRet = RunBenchmarks( os, warmBenchmarkList, bench,
+            [&]( const BENCHMARK<BENCH_FUNC>& aBenchmark )
+            {
+                return executeBenchMark( aBenchmark, reps, models, configDir.GetPath(),
+                                         cacheDir, false );
+            },
+            "models" );
+
+    return ret ? ret : warmRet;
+}
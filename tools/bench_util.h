@@ -0,0 +1,223 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file bench_util.h
+ * the parts shared by the benchmark tools: the list of benchmarks selected by a
+ * character of the command line, the timing of their repetitions and the layout
+ * of their output.
+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <wx/string.h>
+
+#include <ki_exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+
+using CLOCK = std::chrono::steady_clock;
+using TIME_PT = std::chrono::time_point<CLOCK>;
+
+
+/**
+ * The exit codes of the benchmark tools.
+ */
+enum RET_CODES
+{
+    BAD_ARGS = 1,
+    LOAD_ERROR = 2,     ///< the data to measure cannot be read, or there is none
+    RUN_ERROR = 3,      ///< a benchmark cannot be set up, or failed
+};
+
+
+struct BENCH_REPORT
+{
+    unsigned itemCount;             ///< items handled by the last repetition
+    std::chrono::milliseconds benchDurMs;
+};
+
+
+/**
+ * A benchmark of a tool.  BENCH_FUNC, usually a std::function, does the work to
+ * measure; its arguments depend on the tool.
+ */
+template <typename BENCH_FUNC>
+struct BENCHMARK
+{
+    char triggerChar;               ///< selects the benchmark on the command line
+    BENCH_FUNC func;
+    wxString name;
+};
+
+
+/**
+ * Adds up the time of the measured part of each repetition of a benchmark, which
+ * leaves out its setup.
+ */
+class BENCH_TIMER
+{
+public:
+    BENCH_TIMER() :
+        m_total( 0 ),
+        m_reps( 0 )
+    {
+    }
+
+    void Start()
+    {
+        m_start = CLOCK::now();
+    }
+
+    void Stop()
+    {
+        using std::chrono::milliseconds;
+        using std::chrono::duration_cast;
+
+        m_total += duration_cast<milliseconds>( CLOCK::now() - m_start );
+        m_reps++;
+    }
+
+    /**
+     * @return the average time of the repetitions, or 0 if none was timed
+     */
+    std::chrono::milliseconds Average() const
+    {
+        return m_total / std::max( m_reps, 1 );
+    }
+
+private:
+    TIME_PT                     m_start;
+    std::chrono::milliseconds   m_total;
+    int                         m_reps;
+};
+
+
+/**
+ * @return the trigger characters of the benchmarks, for the usage line
+ */
+template <typename BENCH_FUNC>
+wxString GetBenchFlags( const std::vector<BENCHMARK<BENCH_FUNC>>& aList )
+{
+    wxString flags;
+
+    for( auto& bmark : aList )
+        flags << bmark.triggerChar;
+
+    return flags;
+}
+
+
+/**
+ * @return one line per benchmark, with its trigger character and its name
+ */
+template <typename BENCH_FUNC>
+wxString GetBenchDescriptions( const std::vector<BENCHMARK<BENCH_FUNC>>& aList )
+{
+    wxString desc;
+
+    for( auto& bmark : aList )
+        desc << "    " << bmark.triggerChar << ": " << bmark.name << "\n";
+
+    return desc;
+}
+
+
+/**
+ * @param aSelection are the trigger characters given on the command line; all the
+ *                   benchmarks are selected if it is empty
+ */
+template <typename BENCH_FUNC>
+bool IsBenchSelected( const BENCHMARK<BENCH_FUNC>& aBenchmark, const wxString& aSelection )
+{
+    return aSelection.IsEmpty() || aSelection.Contains( aBenchmark.triggerChar );
+}
+
+
+/**
+ * Prints the banner of a tool, followed by the lines given to PrintBenchParam().
+ */
+inline void PrintBenchTitle( std::ostream& aStream, const wxString& aTitle )
+{
+    aStream << aTitle << " Bench Mark Util" << std::endl;
+}
+
+
+inline void PrintBenchParam( std::ostream& aStream, const wxString& aLabel,
+                             const wxString& aValue )
+{
+    aStream << wxString::Format( "  %-13s", aLabel + ":" ) << aValue << std::endl;
+}
+
+
+/**
+ * Prints the result of a benchmark.
+ * @param aItems names the items counted by the report, in the plural
+ */
+inline void PrintBenchResult( std::ostream& aStream, const wxString& aName,
+                              const BENCH_REPORT& aReport, const wxString& aItems )
+{
+    aStream << wxString::Format( "%-20s %u %s in %d ms (average)",
+            aName, aReport.itemCount, aItems, (int) aReport.benchDurMs.count() )
+        << std::endl;
+}
+
+
+/**
+ * Runs the selected benchmarks of a list and prints their results.  An IO_ERROR thrown
+ * by a benchmark is printed, and the next benchmarks are run.
+ * @param aRun runs a benchmark: it is called with the BENCHMARK and returns its
+ *             BENCH_REPORT
+ * @param aItems names the items counted by the reports
+ * @return 0, or RUN_ERROR if a benchmark failed
+ */
+template <typename BENCH_FUNC, typename RUNNER>
+int RunBenchmarks( std::ostream& aStream, const std::vector<BENCHMARK<BENCH_FUNC>>& aList,
+                   const wxString& aSelection, RUNNER aRun, const wxString& aItems )
+{
+    int ret = 0;
+
+    for( auto& bmark : aList )
+    {
+        if( !IsBenchSelected( bmark, aSelection ) )
+            continue;
+
+        try
+        {
+            PrintBenchResult( aStream, bmark.name, aRun( bmark ), aItems );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            aStream << bmark.name << ": " << ioe.What() << std::endl;
+            ret = RUN_ERROR;
+        }
+    }
+
+    return ret;
+}
+
+#endif  // BENCH_UTIL_H
@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fp_info_benchmark.cpp
+ * measures how long filling the footprint list of a footprint library table takes,
+ * with every library parsed (cold: empty footprint info index) and with the fields
+ * read from the footprint info index (warm).
+ *
+ * The cold runs clear the index of the user, which is rebuilt with the libraries
+ * of the table: the other libraries are indexed again the next time they are loaded.
+ */
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+#include <fp_lib_table.h>
+#include <fp_shared_cache.h>
+#include <footprint_info_impl.h>
+#include <footprint_info_index.h>
+
+#include <bench_util.h>
+
+#include <iostream>
+#include <memory>
+
+
+/**
+ * Fills a footprint list from a new table, so that no footprint is served from the
+ * plugins of a previous cycle.
+ * @param aCold = true to clear the footprint info index and the shared footprint cache
+ * first, so that all the footprints are parsed
+ */
+BENCH_REPORT executeBenchMark( const wxString& aTablePath, int aReps, bool aCold )
+{
+    BENCH_REPORT report = {};
+    BENCH_TIMER  timer;
+
+    for( int i = 0; i < aReps; ++i )
+    {
+        FP_LIB_TABLE        table;
+        FOOTPRINT_LIST_IMPL list;
+
+        table.Load( aTablePath );
+
+        if( aCold )
+        {
+            FP_SHARED_CACHE& cache = FP_SHARED_CACHE::GetCache();
+            size_t           limit = cache.GetMemoryLimit();
+
+            cache.SetMemoryLimit( 0 );
+            cache.SetMemoryLimit( limit );
+
+            FOOTPRINT_INFO_INDEX::GetIndex().Clear();
+        }
+
+        timer.Start();
+        list.ReadFootprintFiles( &table );
+        timer.Stop();
+
+        report.itemCount = list.GetCount();
+
+        if( list.GetErrorCount() )
+            std::cerr << list.GetErrorCount() << " errors while reading the libraries\n";
+    }
+
+    report.benchDurMs = timer.Average();
+
+    return report;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 3 )
+    {
+        os << "Usage: " << argv[0] << " <fp-lib-table> <REPS>\n";
+        return BAD_ARGS;
+    }
+
+    wxFileName tablePath( argv[1] );
+
+    long reps = 0;
+    wxString( argv[2] ).ToLong( &reps );
+
+    PrintBenchTitle( os, "Footprint List" );
+
+    PrintBenchParam( os, "Table", tablePath.GetFullPath() );
+    PrintBenchParam( os, "Repetitions", wxString::Format( "%d", (int) reps ) );
+    os << std::endl;
+
+    try
+    {
+        // the cold runs come first, so the warm ones read the index they stored
+        for( bool cold : { true, false } )
+        {
+            BENCH_REPORT report = executeBenchMark( tablePath.GetFullPath(), reps, cold );
+
+            PrintBenchResult( os, cold ? "cold (parsed)" : "warm (indexed)", report,
+                              "footprints" );
+        }
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        os << ioe.What() << std::endl;
+        return LOAD_ERROR;
+    }
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fp_load_benchmark.cpp
+ * measures how long the KiCad footprint plugin takes to give access to the
+ * footprints of a .pretty library: listing the footprints, loading the first one
+ * (what the footprint viewer and the footprint chooser wait for) and loading all
+ * of them.
+ */
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+#include <io_mgr.h>
+#include <class_module.h>
+#include <fp_shared_cache.h>
+
+#include <bench_util.h>
+
+#include <functional>
+#include <iostream>
+#include <memory>
+
+
+/**
+ * A benchmark is always run with a new plugin and an empty shared footprint
+ * cache, so that nothing is served from the cache of a previous cycle.
+ */
+using BENCH_FUNC = std::function<void( PLUGIN&, const wxString&, BENCH_REPORT& )>;
+
+
+static void bench_enumerate( PLUGIN& aPlugin, const wxString& aLibPath, BENCH_REPORT& report )
+{
+    wxArrayString names;
+
+    aPlugin.FootprintEnumerate( names, aLibPath );
+}
+
+
+static void bench_first( PLUGIN& aPlugin, const wxString& aLibPath, BENCH_REPORT& report )
+{
+    wxArrayString names;
+
+    aPlugin.FootprintEnumerate( names, aLibPath );
+
+    if( names.IsEmpty() )
+        return;
+
+    std::unique_ptr<MODULE> module( aPlugin.FootprintLoad( aLibPath, names[0] ) );
+
+    if( module )
+        report.itemCount++;
+}
+
+
+static void bench_all( PLUGIN& aPlugin, const wxString& aLibPath, BENCH_REPORT& report )
+{
+    wxArrayString names;
+
+    aPlugin.FootprintEnumerate( names, aLibPath );
+
+    for( const wxString& name : names )
+    {
+        std::unique_ptr<MODULE> module( aPlugin.FootprintLoad( aLibPath, name ) );
+
+        if( module )
+            report.itemCount++;
+    }
+}
+
+
+/**
+ * List of available benchmarks
+ */
+static std::vector<BENCHMARK<BENCH_FUNC>> benchmarkList =
+{
+    { 'e', bench_enumerate, "enumerate" },
+    { 'f', bench_first, "first footprint" },
+    { 'a', bench_all, "all footprints" },
+};
+
+
+BENCH_REPORT executeBenchMark( const BENCHMARK<BENCH_FUNC>& aBenchmark, int aReps,
+                               const wxString& aLibPath )
+{
+    BENCH_REPORT report = {};
+    BENCH_TIMER  timer;
+
+    for( int i = 0; i < aReps; ++i )
+    {
+        PLUGIN::RELEASER plugin( IO_MGR::PluginFind( IO_MGR::KICAD ) );
+
+        // the parsed footprints are shared by all the plugins of the process
+        FP_SHARED_CACHE& cache = FP_SHARED_CACHE::GetCache();
+        size_t           limit = cache.GetMemoryLimit();
+
+        cache.SetMemoryLimit( 0 );
+        cache.SetMemoryLimit( limit );
+
+        // the count is per repetition, as the time is averaged
+        report.itemCount = 0;
+
+        timer.Start();
+        aBenchmark.func( *plugin, aLibPath, report );
+        timer.Stop();
+    }
+
+    report.benchDurMs = timer.Average();
+
+    return report;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 3 )
+    {
+        os << "Usage: " << argv[0] << " <LIBRARY.pretty> <REPS> ["
+           << GetBenchFlags( benchmarkList ) << "]\n\n";
+        os << "Benchmarks:\n";
+        os << GetBenchDescriptions( benchmarkList );
+        return BAD_ARGS;
+    }
+
+    wxFileName libPath = wxFileName::DirName( argv[1] );
+
+    long reps = 0;
+    wxString( argv[2] ).ToLong( &reps );
+
+    // get the benchmark to do, or all of them if nothing given
+    wxString bench;
+    if( argc == 4 )
+        bench = argv[3];
+
+    PrintBenchTitle( os, "Footprint Load" );
+
+    PrintBenchParam( os, "Library", libPath.GetFullPath() );
+    PrintBenchParam( os, "Repetitions", wxString::Format( "%d", (int) reps ) );
+    os << std::endl;
+
+    return RunBenchmarks( os, benchmarkList, bench,
+            [&]( const BENCHMARK<BENCH_FUNC>& aBenchmark )
+            {
+                return executeBenchMark( aBenchmark, reps, libPath.GetPath() );
+            },
+            "footprints" );
+}
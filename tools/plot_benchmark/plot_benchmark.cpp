@@ -0,0 +1,193 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plot_benchmark.cpp
+ * measures how long plotting the copper layers of a board in Gerber format takes,
+ * with the plot options of the board and one file per layer, like the plot dialog
+ * does: one layer after another, or all of them concurrently.
+ *
+ * The plot functions of the pcbnew kiface are built into the benchmark, so it
+ * measures StartPlotBoard() and PlotOneBoardLayer() themselves.
+ */
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+#include <common.h>
+#include <plot_common.h>
+#include <io_mgr.h>
+#include <class_board.h>
+#include <pcb_plot_params.h>
+#include <pcbplot.h>
+
+#include <bench_util.h>
+
+#include <functional>
+#include <iostream>
+#include <memory>
+
+
+/**
+ * Plots the layers of aPlots, setting their m_created flag.
+ */
+using BENCH_FUNC = std::function<void( BOARD&, PCB_PLOT_PARAMS&,
+                                       std::vector<BOARD_LAYER_PLOT>& )>;
+
+
+static void bench_serial( BOARD& aBoard, PCB_PLOT_PARAMS& aPlotOpts,
+                          std::vector<BOARD_LAYER_PLOT>& aPlots )
+{
+    for( BOARD_LAYER_PLOT& plot : aPlots )
+    {
+        std::unique_ptr<PLOTTER> plotter( StartPlotBoard( &aBoard, &aPlotOpts, plot.m_layer,
+                                                          plot.m_fullFileName,
+                                                          plot.m_sheetDesc ) );
+        plot.m_created = plotter != nullptr;
+
+        if( !plotter )
+            continue;
+
+        PlotOneBoardLayer( &aBoard, plotter.get(), plot.m_layer, aPlotOpts );
+        plotter->EndPlot();
+    }
+}
+
+
+static void bench_concurrent( BOARD& aBoard, PCB_PLOT_PARAMS& aPlotOpts,
+                              std::vector<BOARD_LAYER_PLOT>& aPlots )
+{
+    PlotBoardLayers( &aBoard, &aPlotOpts, aPlots );
+}
+
+
+/**
+ * List of available benchmarks
+ */
+static std::vector<BENCHMARK<BENCH_FUNC>> benchmarkList =
+{
+    { 's', bench_serial, "serial" },
+    { 'c', bench_concurrent, "concurrent" },
+};
+
+
+BENCH_REPORT executeBenchMark( const BENCHMARK<BENCH_FUNC>& aBenchmark, int aReps,
+                               BOARD& aBoard, const wxString& aOutputDir )
+{
+    BENCH_REPORT report = {};
+    BENCH_TIMER  timer;
+
+    // The plot dialog settings of the board, for a Gerber plot
+    PCB_PLOT_PARAMS plotOpts = aBoard.GetPlotOptions();
+    plotOpts.SetFormat( PLOT_FORMAT_GERBER );
+
+    std::vector<BOARD_LAYER_PLOT> plots;
+
+    for( LSEQ seq = aBoard.GetEnabledLayers().CuStack(); seq; ++seq )
+    {
+        wxFileName fn( aOutputDir, aBoard.GetLayerName( *seq ), wxT( "gbr" ) );
+
+        plots.push_back( { *seq, fn.GetFullPath(), wxEmptyString, false } );
+    }
+
+    // The plot files are always written with a '.' as decimal separator
+    LOCALE_IO toggle;
+
+    for( int i = 0; i < aReps; ++i )
+    {
+        timer.Start();
+        aBenchmark.func( aBoard, plotOpts, plots );
+        timer.Stop();
+
+        // the count is per repetition, as the time is averaged
+        report.itemCount = 0;
+
+        for( const BOARD_LAYER_PLOT& plot : plots )
+        {
+            if( !plot.m_created )
+                THROW_IO_ERROR( wxString::Format( "Unable to create file '%s'",
+                                                  GetChars( plot.m_fullFileName ) ) );
+
+            report.itemCount++;
+        }
+    }
+
+    report.benchDurMs = timer.Average();
+
+    return report;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 4 )
+    {
+        os << "Usage: " << argv[0] << " <BOARD.kicad_pcb> <OUTPUT_DIR> <REPS> ["
+           << GetBenchFlags( benchmarkList ) << "]\n\n";
+        os << "Benchmarks:\n";
+        os << GetBenchDescriptions( benchmarkList );
+        return BAD_ARGS;
+    }
+
+    wxFileName boardPath( argv[1] );
+    wxFileName outputDir = wxFileName::DirName( argv[2] );
+
+    long reps = 0;
+    wxString( argv[3] ).ToLong( &reps );
+
+    // get the benchmark to do, or all of them if nothing given
+    wxString bench;
+    if( argc == 5 )
+        bench = argv[4];
+
+    PrintBenchTitle( os, "Plot" );
+
+    PrintBenchParam( os, "Board", boardPath.GetFullPath() );
+    PrintBenchParam( os, "Output", outputDir.GetPath() );
+    PrintBenchParam( os, "Repetitions", wxString::Format( "%d", (int) reps ) );
+    os << std::endl;
+
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        board.reset( IO_MGR::Load( IO_MGR::KICAD, boardPath.GetFullPath() ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        os << ioe.What() << std::endl;
+        return LOAD_ERROR;
+    }
+
+    if( !board )
+        return LOAD_ERROR;
+
+    return RunBenchmarks( os, benchmarkList, bench,
+            [&]( const BENCHMARK<BENCH_FUNC>& aBenchmark )
+            {
+                return executeBenchMark( aBenchmark, reps, *board, outputDir.GetPath() );
+            },
+            "copper layers" );
+}
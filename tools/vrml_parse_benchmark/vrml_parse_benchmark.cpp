@@ -0,0 +1,200 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file vrml_parse_benchmark.cpp
+ * measures how long the VRML plugin takes to load a corpus of .wrl models, without
+ * the 3D cache.  Reading the same files line by line, with the FILE_LINE_READER the
+ * plugin used before and with the MAPPED_LINE_READER it uses now, gives the share of
+ * the time spent in the input itself.
+ */
+
+#include <wx/wx.h>
+#include <wx/init.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <richio.h>
+#include <wrlmap.h>
+#include <plugins/3dapi/ifsg_api.h>
+#include <plugins/ldr/3d/pluginldr3D.h>
+
+#include <bench_util.h>
+
+#include <functional>
+#include <iostream>
+
+
+using BENCH_FUNC = std::function<bool( KICAD_PLUGIN_LDR_3D&, const wxString& )>;
+
+
+static bool bench_read( KICAD_PLUGIN_LDR_3D& aPlugin, const wxString& aModel )
+{
+    // the same line limit as LoadVRML()
+    FILE_LINE_READER reader( aModel, 0, 8388608 );
+
+    while( reader.ReadLine() )
+        ;
+
+    return true;
+}
+
+
+static bool bench_read_mapped( KICAD_PLUGIN_LDR_3D& aPlugin, const wxString& aModel )
+{
+    MAPPED_LINE_READER reader( aModel, 8388608 );
+
+    while( reader.ReadLine() )
+        ;
+
+    return true;
+}
+
+
+static bool bench_load( KICAD_PLUGIN_LDR_3D& aPlugin, const wxString& aModel )
+{
+    SCENEGRAPH* scene = aPlugin.Load( aModel.ToUTF8() );
+
+    if( !scene )
+        return false;
+
+    S3D::DestroyNode( (SGNODE*) scene );
+    return true;
+}
+
+
+/**
+ * List of available benchmarks
+ */
+static std::vector<BENCHMARK<BENCH_FUNC>> benchmarkList =
+{
+    { 'r', bench_read, "read lines" },
+    { 'm', bench_read_mapped, "read mapped lines" },
+    { 'l', bench_load, "plugin load" },
+};
+
+
+BENCH_REPORT executeBenchMark( const BENCHMARK<BENCH_FUNC>& aBenchmark, int aReps,
+                               KICAD_PLUGIN_LDR_3D& aPlugin,
+                               const wxArrayString& aModels )
+{
+    BENCH_REPORT report = {};
+    BENCH_TIMER  timer;
+
+    for( int i = 0; i < aReps; ++i )
+    {
+        // the count is per repetition, as the time is averaged
+        report.itemCount = 0;
+
+        timer.Start();
+
+        for( const wxString& model : aModels )
+        {
+            if( aBenchmark.func( aPlugin, model ) )
+                report.itemCount++;
+        }
+
+        timer.Stop();
+    }
+
+    report.benchDurMs = timer.Average();
+
+    return report;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 4 )
+    {
+        os << "Usage: " << argv[0] << " <VRML_PLUGIN> <MODELS_DIR> <REPS> ["
+           << GetBenchFlags( benchmarkList ) << "]\n\n";
+        os << "VRML_PLUGIN is the s3d_plugin_vrml module of the build tree.\n\n";
+        os << "Benchmarks:\n";
+        os << GetBenchDescriptions( benchmarkList );
+        return BAD_ARGS;
+    }
+
+    // wxWidgets is used by the plugin and by its loader
+    wxInitializer initializer;
+
+    if( !initializer.IsOk() )
+        return RUN_ERROR;
+
+    wxFileName pluginPath( argv[1] );
+    pluginPath.MakeAbsolute();
+
+    wxFileName modelsDir = wxFileName::DirName( argv[2] );
+
+    long reps = 0;
+    wxString( argv[3] ).ToLong( &reps );
+
+    // get the benchmark to do, or all of them if nothing given
+    wxString bench;
+    if( argc == 5 )
+        bench = argv[4];
+
+    KICAD_PLUGIN_LDR_3D plugin;
+
+    if( !plugin.Open( pluginPath.GetFullPath() ) )
+    {
+        os << "Cannot load the plugin " << pluginPath.GetFullPath() << std::endl;
+        return RUN_ERROR;
+    }
+
+    wxArrayString models;
+    wxDir::GetAllFiles( modelsDir.GetPath(), &models, "*.wrl" );
+
+    if( models.IsEmpty() )
+    {
+        os << "No VRML models in " << modelsDir.GetPath() << std::endl;
+        return LOAD_ERROR;
+    }
+
+    wxULongLong corpusSize = 0;
+
+    for( const wxString& model : models )
+        corpusSize += wxFileName::GetSize( model );
+
+    PrintBenchTitle( os, "VRML Parse" );
+
+    PrintBenchParam( os, "Plugin", plugin.GetKicadPluginName() );
+    PrintBenchParam( os, "Models", wxString::Format( "%s (%u files, %s)",
+            modelsDir.GetPath(), (unsigned) models.size(),
+            wxFileName::GetHumanReadableSize( corpusSize ) ) );
+    PrintBenchParam( os, "Repetitions", wxString::Format( "%d", (int) reps ) );
+    os << std::endl;
+
+    int ret = RunBenchmarks( os, benchmarkList, bench,
+            [&]( const BENCHMARK<BENCH_FUNC>& aBenchmark )
+            {
+                return executeBenchMark( aBenchmark, reps, plugin, models );
+            },
+            "models" );
+
+    plugin.Close();
+
+    return ret;
+}
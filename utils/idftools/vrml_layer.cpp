@@ -732,6 +732,41 @@ bool VRML_LAYER::AddArc( double aCenterX, double aCenterY, double aStartX, doubl
 }
 
 
+// copies the contours of another layer; returns true if all was fine
+bool VRML_LAYER::AppendContours( const VRML_LAYER& aLayer )
+{
+    if( fix )
+    {
+        error = "AppendContours(): no more contours may be added (Tesselate was previously executed)";
+        return false;
+    }
+
+    for( unsigned int i = 0; i < aLayer.contours.size(); ++i )
+    {
+        int contour = NewContour( aLayer.pth[i] );
+
+        if( contour < 0 )
+            return false;
+
+        // the contours hold the position of their vertices in the vertex list
+        std::list<int>::const_iterator cbeg = aLayer.contours[i]->begin();
+        std::list<int>::const_iterator cend = aLayer.contours[i]->end();
+
+        while( cbeg != cend )
+        {
+            VERTEX_3D* vp = aLayer.vertices[*cbeg];
+
+            if( !AddVertex( contour, vp->x, vp->y ) )
+                return false;
+
+            ++cbeg;
+        }
+    }
+
+    return true;
+}
+
+
 // tesselates the contours in preparation for a 3D output;
 // returns true if all was fine, false otherwise
 bool VRML_LAYER::Tesselate( VRML_LAYER* holes, bool aHolesOnly )
@@ -312,6 +312,18 @@ public:
                  double aArcWidth, double aAngle,
                  bool aHoleFlag = false, bool aPlatedHole = false );
 
+    /**
+     * Function AppendContours
+     * copies the contours of aLayer to the internal list of contours.  The vertices
+     * are copied, so both objects may then be used as the holes of different layers,
+     * and be tesselated concurrently (Tesselate() renumbers the vertices of the holes).
+     *
+     * @param aLayer is the layer whose contours are copied
+     *
+     * @return bool: true if the contours were successfully copied
+     */
+    bool AppendContours( const VRML_LAYER& aLayer );
+
     /**
      * Function Tesselate
      * creates a list of outline vertices as well as the